@@ -1,305 +1,2648 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#include "HTTPSubsystem.h"
-#include "YnnkHttpTypes.h"
-#include "HttpModule.h"
-#include "Interfaces/IHttpRequest.h"
-#include "Interfaces/IHttpResponse.h"
-#include "Runtime/Launch/Resources/Version.h"
-#include "Misc/FileHelper.h"
-#include "JsonItemFunctionsLibrary.h"
-//#include "Async/Future.h"
-#include "Async/Async.h"
-
-bool UHTTPSubsystem::SendHttpRequestInternal(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FString& BodyString, const TArray<uint8>& BodyData, EExpectedResponseType ExpectedResponseFormat)
-{
-	const FString SendMethod = (Verb == ERequestMethod::Get ? TEXT("GET") : TEXT("POST"));
-
-	int32 RequestId = INDEX_NONE, MaxId = INDEX_NONE;
-	for (auto& Req : HttpRequests)
-	{
-		if (!Req.Value.HttpRequest.IsValid())
-		{
-			Req.Value.TempBinaryData.Empty();
-		}
-	}
-	for (const auto& Req : HttpRequests)
-	{
-		MaxId = FMath::Max(Req.Key, MaxId);
-		if (!Req.Value.HttpRequest.IsValid())
-		{
-			RequestId = Req.Key;
-			break;
-		}
-	}
-	if (!HttpRequests.Contains(RequestId))
-	{
-		RequestId = MaxId + 1;
-		HttpRequests.Add(RequestId);
-	}
-
-	HttpRequests[RequestId].Name = Keyword;
-	HttpRequests[RequestId].ResponseFormat = ExpectedResponseFormat;
-
-	if (!OnStreamChunkReceived.IsBound())
-	{
-#if ENGINE_MINOR_VERSION > 4
-		OnStreamChunkReceived.BindUObject(this, &UHTTPSubsystem::StreamChunkReceivedWrapperV2);
-#elif ENGINE_MINOR_VERSION > 2
-		OnStreamChunkReceived.BindUObject(this, &UHTTPSubsystem::StreamChunkReceivedWrapper);
-#endif
-	}
-
-	auto& HttpRequest = HttpRequests[RequestId].HttpRequest;
-	HttpRequest = FHttpModule::Get().CreateRequest();
-	HttpRequest->SetTimeout(Timeout);
-	HttpRequest->SetURL(URL);
-	HttpRequest->SetVerb(SendMethod);
-
-	bool bContentTypeSpecified = false;
-	for (const auto& Param : HeaderParams)
-	{
-		if (Param.Name == TEXT("Content-Type"))
-		{
-			bContentTypeSpecified = true;
-		}
-		HttpRequest->SetHeader(Param.Name, Param.Value);
-	}
-
-	bool bContentIsString = BodyString != TEXT("!!NULL") && !BodyString.IsEmpty();
-
-	if (!bContentTypeSpecified)
-	{
-		if (bContentIsString)
-		{
-			HttpRequest->SetHeader("Content-Type", "application/json");
-		}
-		else
-		{
-			HttpRequest->SetHeader("Content-Type", "audio/wav");
-		}
-	}
-
-	if (bContentIsString)
-	{
-		HttpRequest->SetContentAsString(BodyString);
-	}
-	else
-	{
-		HttpRequest->SetContent(BodyData);
-	}
-
-	HttpRequest->OnProcessRequestComplete().BindUObject(this, &UHTTPSubsystem::OnHTTPRequestComplete, RequestId);
-	if (HttpRequests[RequestId].FormatStream())
-	{
-#if ENGINE_MINOR_VERSION > 4
-		HttpRequest->SetResponseBodyReceiveStreamDelegateV2(OnStreamChunkReceived);
-#elif ENGINE_MINOR_VERSION > 2
-		HttpRequest->SetResponseBodyReceiveStreamDelegate(OnStreamChunkReceived);
-#endif
-		LastRequest = RequestId;
-	}
-	return HttpRequest->ProcessRequest();
-}
-
-bool UHTTPSubsystem::SendHttpRequest(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FString& BodyString, EExpectedResponseType ExpectedResponseFormat)
-{
-	return SendHttpRequestInternal(Keyword, URL, Verb, HeaderParams, BodyString, {}, ExpectedResponseFormat);
-}
-
-bool UHTTPSubsystem::SendHttpRequestData(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const TArray<uint8>& BodyData, EExpectedResponseType ExpectedResponseFormat)
-{
-	return SendHttpRequestInternal(Keyword, URL, Verb, HeaderParams, TEXT("!!NULL"), BodyData, ExpectedResponseFormat);
-}
-
-void UHTTPSubsystem::Deinitialize()
-{
-	Super::Deinitialize();
-
-	for (auto& Req : HttpRequests)
-	{
-		if (Req.Value.HttpRequest.IsValid())
-		{
-			Req.Value.HttpRequest->OnProcessRequestComplete().Unbind();
-			//HttpRequest->OnRequestProgress().Unbind();
-		}
-	}
-#if ENGINE_MINOR_VERSION > 2
-	OnStreamChunkReceived.Unbind();
-#endif
-}
-
-void UHTTPSubsystem::OnHTTPRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr RequestResponse, bool bWasSuccessful, int32 ReqId)
-{
-	if (!RequestResponse.IsValid())
-	{
-		return;
-	}
-
-	FString Type = RequestResponse->GetContentType();
-	TArray<FString> Headers = RequestResponse->GetAllHeaders();
-
-	if (Type.Contains(TEXT("audio/")) || HttpRequests[ReqId].FormatAudio())
-	{
-		UE_LOG(LogTemp, Log, TEXT("HTTP-request returned data of type: %s (binary). Length = %d"), *Type, RequestResponse->GetContentLength());
-		OnDataRequestCompleted(ReqId, RequestResponse->GetContent(), Headers, RequestResponse->GetResponseCode(), bWasSuccessful);
-	}
-	else if (Type.Contains(TEXT("application/json")) || Type.StartsWith("text/") || HttpRequests[ReqId].FormatText())
-	{
-		UE_LOG(LogTemp, Log, TEXT("HTTP-request returned data of type: %s (text). Length = %d"), *Type, RequestResponse->GetContentLength());
-		StringBuffer = RequestResponse->GetContentAsString();
-
-		UE_LOG(LogTemp, Log, TEXT("To remove: [%s]"), *StringBuffer);
-		OnStringRequestCompleted(ReqId, RequestResponse->GetContentAsString(), Headers, RequestResponse->GetResponseCode(), bWasSuccessful);
-	}
-	else
-	{
-		UE_LOG(LogTemp, Log, TEXT("HTTP-request returned data of type: %s (unknown). Length = %d"), *Type, RequestResponse->GetContentLength());
-		OnStringRequestCompleted(ReqId, RequestResponse->GetContentAsString(), Headers, RequestResponse->GetResponseCode(), bWasSuccessful);
-	}
-
-	if (EHttpRequestStatus::IsFinished(Request->GetStatus()))
-	{
-		if (HttpRequests.Contains(ReqId))
-		{
-			HttpRequests[ReqId].HttpRequest->OnProcessRequestComplete().Unbind();
-			HttpRequests[ReqId].HttpRequest = nullptr;
-			LastRequest = INDEX_NONE;
-		}
-	}
-}
-
-bool UHTTPSubsystem::StreamChunkReceivedWrapper(void* Ptr, int64 Length)
-{
-	if (HttpRequests.Contains(LastRequest) && Length > 0)
-	{
-		auto& Req = HttpRequests[LastRequest];
-
-		Req.TempBinaryData.SetNum(Length);
-		FMemory::Memcpy(Req.TempBinaryData.GetData(), Ptr, Length);
-
-		if (Req.FormatText())
-		{
-			FFileHelper::BufferToString(Req.TempStringData, Req.TempBinaryData.GetData(), Length);
-			Req.TempStringData = UJsonItemFunctionsLibrary::CleanJsonResponse(Req.TempStringData);
-
-			if (bResponseInGameThread && !IsInGameThread())
-			{
-				AsyncTask(ENamedThreads::GameThread, [this, ReqId = LastRequest, strDat = Req.TempStringData]()
-				{
-					if (HttpRequests.Contains(ReqId))
-					{
-						OnTextStreamResponse.Broadcast(HttpRequests[ReqId].Name, HttpRequests[ReqId].TempStringData);
-					}
-					else
-					{
-						OnTextStreamResponse.Broadcast(TEXT("Default"), strDat);
-					}
-				});
-			}
-			else
-			{
-				OnTextStreamResponse.Broadcast(Req.Name, Req.TempStringData);
-			}
-		}
-		else
-		{
-			if (bResponseInGameThread && !IsInGameThread())
-			{
-				AsyncTask(ENamedThreads::GameThread, [this, ReqId = LastRequest]()
-				{
-					if (HttpRequests.Contains(ReqId))
-					{
-						OnDataStreamResponse.Broadcast(HttpRequests[ReqId].Name, HttpRequests[ReqId].TempBinaryData);
-					}
-					else
-					{
-						OnDataStreamResponse.Broadcast(TEXT("Default_ERROR"), {});
-					}
-				});
-			}
-			else
-			{
-				OnDataStreamResponse.Broadcast(Req.Name, Req.TempBinaryData);
-			}
-		}
-	}
-
-	return (Ptr != NULL && Length > 0);
-}
-
-void UHTTPSubsystem::StreamChunkReceivedWrapperV2(void* Ptr, int64& InOutLength)
-{
-	StreamChunkReceivedWrapper(Ptr, InOutLength);
-}
-
-void UHTTPSubsystem::OnStringRequestCompleted(int32 ReqId, const FString Content, const TArray<FString>& Headers, const int32 ResponseCode, const bool bWasSuccessful)
-{
-	const FName Keyword = HttpRequests.Contains(ReqId) ? HttpRequests[ReqId].Name : TEXT("Default");
-
-	if (bWasSuccessful)
-	{
-		if (bResponseInGameThread && !IsInGameThread())
-		{
-			StringBuffer = Content;
-			AsyncTask(ENamedThreads::GameThread, [this, Keyword, ResponseCode, Headers]()
-			{
-				OnTextResponse.Broadcast(Keyword, ResponseCode, Headers, StringBuffer);
-			});
-		}
-		else
-		{
-			OnTextResponse.Broadcast(Keyword, ResponseCode, Headers, Content);
-		}
-	}
-	else
-	{
-		if (bResponseInGameThread && !IsInGameThread())
-		{
-			AsyncTask(ENamedThreads::GameThread, [this, Keyword, ResponseCode]()
-			{
-				OnResponseError.Broadcast(Keyword, ResponseCode);
-			});
-		}
-		else
-		{
-			OnResponseError.Broadcast(Keyword, ResponseCode);
-		}
-	}
-}
-
-void UHTTPSubsystem::OnDataRequestCompleted(int32 ReqId, const TArray<uint8>& Content, const TArray<FString>& Headers, const int32 ResponseCode, const bool bWasSuccessful)
-{
-	const FName Keyword = HttpRequests.Contains(ReqId) ? HttpRequests[ReqId].Name : TEXT("Default");
-
-	if (bWasSuccessful)
-	{
-		DataBuffer.SetNum(Content.Num());
-		FMemory::Memcpy(DataBuffer.GetData(), Content.GetData(), DataBuffer.Num());
-		if (bResponseInGameThread && !IsInGameThread())
-		{
-			AsyncTask(ENamedThreads::GameThread, [this, Keyword, ResponseCode, Headers]()
-			{
-				OnDataResponse.Broadcast(Keyword, ResponseCode, Headers, DataBuffer);
-			});
-		}
-		else
-		{
-			OnDataResponse.Broadcast(Keyword, ResponseCode, Headers, DataBuffer);
-		}
-	}
-	else
-	{
-		if (bResponseInGameThread && !IsInGameThread())
-		{
-			AsyncTask(ENamedThreads::GameThread, [this, Keyword, ResponseCode]()
-			{
-				OnResponseError.Broadcast(Keyword, ResponseCode);
-			});
-		}
-		else
-		{
-			OnResponseError.Broadcast(Keyword, ResponseCode);
-		}
-	}
-}
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HTTPSubsystem.h"
+#include "YnnkHttpTypes.h"
+#include "HttpModule.h"
+#include "PlatformHttp.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Interfaces/IHttpResponse.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "JsonItemFunctionsLibrary.h"
+#include "YnnkHttpCompression.h"
+#include "YnnkUtf8Decoder.h"
+#include "YnnkTextAccumulator.h"
+#include "YnnkStreamRingBuffer.h"
+#include "YnnkPcmStreamReframer.h"
+#include "YnnkHttpPrivate.h"
+#include "YnnkHttpTrace.h"
+#include "YnnkHttpRecording.h"
+#include "Misc/DateTime.h"
+//#include "Async/Future.h"
+#include "Async/Async.h"
+#include "WebSocketsModule.h"
+#include "IWebSocket.h"
+
+namespace
+{
+	// Coalesce policy merges pending chunks when this share of stream buffer or global budget is used
+	constexpr float StreamCoalesceThreshold = 0.75f;
+
+	// Created when the first chunk of request is broadcasted in http thread
+	TSharedPtr<FYnnkStreamScratch, ESPMode::ThreadSafe> GetStreamScratch(FYnnkNamedHttpRequest& Req)
+	{
+		if (!Req.StreamScratch.IsValid())
+		{
+			Req.StreamScratch = MakeShared<FYnnkStreamScratch, ESPMode::ThreadSafe>();
+		}
+		return Req.StreamScratch;
+	}
+
+	// scheme://host:port of URL in lower case
+	FString GetUrlOrigin(const FString& URL)
+	{
+		const int32 SchemeEnd = URL.Find(TEXT("://"));
+		const int32 HostStart = SchemeEnd == INDEX_NONE ? 0 : SchemeEnd + 3;
+		const int32 PathStart = URL.Find(TEXT("/"), ESearchCase::CaseSensitive, ESearchDir::FromStart, HostStart);
+		return (PathStart == INDEX_NONE ? URL : URL.Left(PathStart)).ToLower();
+	}
+
+	bool SetCompressedContent(const TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>& HttpRequest, const uint8* Data, int32 Size, const FYnnkHttpRequestOptions& Options)
+	{
+		if (Options.BodyEncoding == EYnnkContentEncoding::None || Size < Options.CompressionThreshold)
+		{
+			return false;
+		}
+
+		TArray<uint8> CompressedData;
+		if (!YnnkHttpCompression::Compress(Options.BodyEncoding, Data, Size, CompressedData))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Unable to compress request body, sending as is"));
+			return false;
+		}
+
+		HttpRequest->SetHeader(TEXT("Content-Encoding"), YnnkHttpCompression::GetEncodingName(Options.BodyEncoding));
+		HttpRequest->SetContent(MoveTemp(CompressedData));
+		return true;
+	}
+
+	// Response of the streaming request is replayed or received by Source
+	int32 GetStreamResponseCode(const FYnnkNamedHttpRequest& Req, const IHttpRequest* Source)
+	{
+		if (Req.Replay.IsValid())
+		{
+			return Req.Replay->ResponseCode;
+		}
+		const FHttpResponsePtr Response = Source->GetResponse();
+		return Response.IsValid() ? Response->GetResponseCode() : 0;
+	}
+
+	FString GetStreamResponseHeader(const FYnnkNamedHttpRequest& Req, const IHttpRequest* Source, const FString& Name)
+	{
+		if (Req.Replay.IsValid())
+		{
+			return Req.Replay->GetHeader(Name);
+		}
+		const FHttpResponsePtr Response = Source->GetResponse();
+		return Response.IsValid() ? Response->GetHeader(Name) : FString();
+	}
+}
+
+int32 UHTTPSubsystem::CreateNamedRequest(FName Keyword, const FString& URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, EExpectedResponseType ExpectedResponseFormat, const FYnnkHttpRequestOptions& Options, const TCHAR* DefaultContentType)
+{
+	const FString SendMethod = (Verb == ERequestMethod::Get ? TEXT("GET") : TEXT("POST"));
+
+	if (Options.bReplacePrevious)
+	{
+		CancelRequestsByKeyword(Keyword);
+	}
+
+	FScopeLock Lock(&RequestsLock);
+
+	int32 RequestId = INDEX_NONE, MaxId = INDEX_NONE;
+	for (auto& Req : HttpRequests)
+	{
+		if (!Req.Value.HttpRequest.IsValid())
+		{
+			Req.Value.TempBinaryData.Empty();
+		}
+	}
+	for (const auto& Req : HttpRequests)
+	{
+		MaxId = FMath::Max(Req.Key, MaxId);
+		if (!Req.Value.HttpRequest.IsValid())
+		{
+			RequestId = Req.Key;
+			break;
+		}
+	}
+	if (!HttpRequests.Contains(RequestId))
+	{
+		RequestId = MaxId + 1;
+		HttpRequests.Add(RequestId);
+	}
+
+	HttpRequests[RequestId].Name = Keyword;
+	HttpRequests[RequestId].Serial = ++NextRequestSerial;
+	LastRequestHandle = FYnnkHttpRequestHandle(RequestId, NextRequestSerial);
+	HttpRequests[RequestId].ResponseFormat = ExpectedResponseFormat;
+	HttpRequests[RequestId].Options = Options;
+	HttpRequests[RequestId].Attempt = 0;
+	HttpRequests[RequestId].Callbacks.Reset();
+	HttpRequests[RequestId].BodyFileName.Empty();
+	HttpRequests[RequestId].BodyStream.Reset();
+	HttpRequests[RequestId].ResponseFileName.Empty();
+	HttpRequests[RequestId].bResumeDownload = false;
+	HttpRequests[RequestId].Timing.Submit(FPlatformTime::Seconds());
+	INC_DWORD_STAT(STAT_YnnkHttpActiveRequests);
+
+	auto& HttpRequest = HttpRequests[RequestId].HttpRequest;
+	HttpRequest = FHttpModule::Get().CreateRequest();
+	HttpRequest->SetTimeout(GetAttemptTimeout(Options));
+	HttpRequest->SetURL(URL);
+	HttpRequest->SetVerb(SendMethod);
+
+	bool bContentTypeSpecified = false;
+	bool bAcceptEncodingSpecified = false;
+	for (const auto& Param : HeaderParams)
+	{
+		if (Param.Name == TEXT("Content-Type"))
+		{
+			bContentTypeSpecified = true;
+		}
+		else if (Param.Name == TEXT("Accept-Encoding"))
+		{
+			bAcceptEncodingSpecified = true;
+		}
+		HttpRequest->SetHeader(Param.Name, Param.Value);
+	}
+
+	if (Options.bDecompressResponse && !bAcceptEncodingSpecified)
+	{
+		HttpRequest->SetHeader(TEXT("Accept-Encoding"), TEXT("gzip, deflate"));
+	}
+
+	if (!bContentTypeSpecified)
+	{
+		HttpRequest->SetHeader(TEXT("Content-Type"), DefaultContentType);
+	}
+
+	YNNK_HTTP_TRACE_EVENT(Created, RequestId, Keyword, 0, 0);
+	return RequestId;
+}
+
+bool UHTTPSubsystem::SendHttpRequestInternal(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FString& BodyString, const TArray<uint8>& BodyData, EExpectedResponseType ExpectedResponseFormat, const FYnnkHttpRequestOptions& Options,
+	TSharedPtr<FYnnkHttpRequestCallbacks, ESPMode::ThreadSafe> Callbacks)
+{
+	YNNK_HTTP_TRACE_SCOPE("UHTTPSubsystem::SendHttpRequest");
+
+	bool bContentIsString = BodyString != TEXT("!!NULL") && !BodyString.IsEmpty();
+
+	const int32 RequestId = CreateNamedRequest(Keyword, URL, Verb, HeaderParams, ExpectedResponseFormat, Options, bContentIsString ? TEXT("application/json") : TEXT("audio/wav"));
+	HttpRequests[RequestId].Callbacks = Callbacks;
+	auto& HttpRequest = HttpRequests[RequestId].HttpRequest;
+
+	if (bContentIsString)
+	{
+		bool bCompressed = false;
+		if (Options.BodyEncoding != EYnnkContentEncoding::None)
+		{
+			FTCHARToUTF8 Utf8Body(*BodyString);
+			bCompressed = SetCompressedContent(HttpRequest, (const uint8*)Utf8Body.Get(), Utf8Body.Length(), Options);
+		}
+		if (!bCompressed)
+		{
+			HttpRequest->SetContentAsString(BodyString);
+		}
+	}
+	else if (!SetCompressedContent(HttpRequest, BodyData.GetData(), BodyData.Num(), Options))
+	{
+		HttpRequest->SetContent(BodyData);
+	}
+
+	return StartAttempt(RequestId);
+}
+
+bool UHTTPSubsystem::SendHttpRequestFile(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FString& FileName, const FYnnkHttpRequestOptions& Options, EExpectedResponseType ExpectedResponseFormat)
+{
+	const int64 FileSize = IFileManager::Get().FileSize(*FileName);
+	if (FileSize < 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SendHttpRequestFile: file %s doesn't exist"), *FileName);
+		return false;
+	}
+
+	const int32 RequestId = CreateNamedRequest(Keyword, URL, Verb, HeaderParams, ExpectedResponseFormat, Options, GetContentTypeForFile(FileName));
+	FYnnkNamedHttpRequest& Req = HttpRequests[RequestId];
+
+	// file is read by http module in small blocks while sending
+	if (!Req.HttpRequest->SetContentAsStreamedFile(FileName))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SendHttpRequestFile: unable to open file %s"), *FileName);
+		ReleaseRequest(RequestId);
+		return false;
+	}
+	Req.BodyFileName = FileName;
+
+	return StartAttempt(RequestId);
+}
+
+#if ENGINE_MINOR_VERSION > 0
+bool UHTTPSubsystem::SendHttpRequestStream(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, TSharedRef<FArchive, ESPMode::ThreadSafe> BodyStream, const FYnnkHttpRequestOptions& Options, EExpectedResponseType ExpectedResponseFormat)
+{
+	const int32 RequestId = CreateNamedRequest(Keyword, URL, Verb, HeaderParams, ExpectedResponseFormat, Options, TEXT("application/octet-stream"));
+	FYnnkNamedHttpRequest& Req = HttpRequests[RequestId];
+
+	if (!Req.HttpRequest->SetContentFromStream(BodyStream))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SendHttpRequestStream: invalid body stream"));
+		ReleaseRequest(RequestId);
+		return false;
+	}
+	Req.BodyStream = BodyStream;
+	// archive can only be read by one request at a time
+	Req.Options.RetryPolicy.HedgeDelay = 0.f;
+
+	return StartAttempt(RequestId);
+}
+#endif
+
+bool UHTTPSubsystem::SendHttpRequestMultipart(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FYnnkMultipartBody& Body, const FYnnkHttpRequestOptions& Options, EExpectedResponseType ExpectedResponseFormat)
+{
+	// boundary must match the body
+	TArray<FYnnkUrlParameter> Headers = HeaderParams;
+	Headers.RemoveAll([](const FYnnkUrlParameter& Param) { return Param.Name == TEXT("Content-Type"); });
+	Headers.Add(FYnnkUrlParameter(TEXT("Content-Type"), Body.GetContentType()));
+
+#if ENGINE_MINOR_VERSION > 0
+	return SendHttpRequestStream(Keyword, URL, Verb, Headers, Body.CreateReader(), Options, ExpectedResponseFormat);
+#else
+	// http module can't read content from archive
+	TArray<uint8> BodyData;
+	if (!Body.ReadToArray(BodyData))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SendHttpRequestMultipart: unable to read multipart body"));
+		return false;
+	}
+	FYnnkHttpRequestOptions DataOptions = Options;
+	DataOptions.BodyEncoding = EYnnkContentEncoding::None;
+	return SendHttpRequestDataWithOptions(Keyword, URL, Verb, Headers, BodyData, DataOptions, ExpectedResponseFormat);
+#endif
+}
+
+bool UHTTPSubsystem::SendHttpRequestMultipartParts(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const TArray<FYnnkMultipartPart>& Parts, const FYnnkHttpRequestOptions& Options, EExpectedResponseType ExpectedResponseFormat)
+{
+	FYnnkMultipartBody Body;
+	for (const FYnnkMultipartPart& Part : Parts)
+	{
+		if (!Body.AddPart(Part))
+		{
+			return false;
+		}
+	}
+	return SendHttpRequestMultipart(Keyword, URL, Verb, HeaderParams, Body, Options, ExpectedResponseFormat);
+}
+
+bool UHTTPSubsystem::DownloadToFile(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FString& BodyString, const FString& FileName, bool bResume, const FYnnkHttpRequestOptions& Options)
+{
+	if (FileName.IsEmpty())
+	{
+		return false;
+	}
+
+	const int32 RequestId = CreateNamedRequest(Keyword, URL, Verb, HeaderParams, EExpectedResponseType::Data, Options, TEXT("application/json"));
+	FYnnkNamedHttpRequest& Req = HttpRequests[RequestId];
+	Req.ResponseFileName = FPaths::ConvertRelativePathToFull(FileName);
+	Req.bResumeDownload = bResume;
+
+	if (!BodyString.IsEmpty())
+	{
+		Req.HttpRequest->SetContentAsString(BodyString);
+	}
+
+	return StartAttempt(RequestId);
+}
+
+void UHTTPSubsystem::PrepareResponseFile(FYnnkNamedHttpRequest& Req)
+{
+	Req.ResponseFileWriter.Reset();
+	Req.ResumeOffset = 0;
+
+	const FString TempFileName = Req.GetResponseTempFileName();
+	const int64 TempFileSize = IFileManager::Get().FileSize(*TempFileName);
+	if (TempFileSize > 0 && Req.bResumeDownload)
+	{
+		Req.ResumeOffset = TempFileSize;
+		Req.HttpRequest->SetHeader(TEXT("Range"), FString::Printf(TEXT("bytes=%lld-"), TempFileSize));
+	}
+	else
+	{
+		if (TempFileSize >= 0)
+		{
+			IFileManager::Get().Delete(*TempFileName, false, true, true);
+		}
+		IFileManager::Get().MakeDirectory(*FPaths::GetPath(Req.ResponseFileName), true);
+	}
+}
+
+void UHTTPSubsystem::WriteResponseFileChunk(FYnnkNamedHttpRequest& Req, const IHttpRequest* Source, const uint8* Data, int64 Length)
+{
+	if (!Req.ResponseFileWriter.IsValid())
+	{
+		const int32 ResponseCode = GetStreamResponseCode(Req, Source);
+		if (ResponseCode >= 300)
+		{
+			// don't save error description to file
+			return;
+		}
+
+		// server ignored Range header and sends the whole file
+		const bool bAppend = Req.ResumeOffset > 0 && ResponseCode == 206;
+		if (!bAppend)
+		{
+			Req.ResumeOffset = 0;
+		}
+
+		Req.ResponseFileWriter = MakeShareable(IFileManager::Get().CreateFileWriter(*Req.GetResponseTempFileName(), bAppend ? FILEWRITE_Append : FILEWRITE_None));
+		if (!Req.ResponseFileWriter.IsValid())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("HTTP-request %s: unable to write file %s"), *Req.Name.ToString(), *Req.GetResponseTempFileName());
+			return;
+		}
+	}
+
+	Req.ResponseFileWriter->Serialize(const_cast<uint8*>(Data), Length);
+}
+
+bool UHTTPSubsystem::OnFileRequestCompleted(int32 ReqId, const FYnnkHttpResponseView& Response, bool bWasSuccessful)
+{
+	FYnnkNamedHttpRequest& Req = HttpRequests[ReqId];
+	const FString TempFileName = Req.GetResponseTempFileName();
+	const int32 ResponseCode = Response.Code;
+
+	if (Req.ResponseFileWriter.IsValid())
+	{
+		Req.ResponseFileWriter->Close();
+		Req.ResponseFileWriter.Reset();
+	}
+	else if (bWasSuccessful && Response.GetContentSize() > 0 && ResponseCode < 300)
+	{
+		// http module without stream delegates
+		FFileHelper::SaveArrayToFile(*Response.Content, *TempFileName);
+	}
+
+	const bool bSucceeded = bWasSuccessful && ResponseCode >= 200 && ResponseCode < 300;
+	if (bSucceeded && IFileManager::Get().Move(*Req.ResponseFileName, *TempFileName, true, true))
+	{
+		const int64 FileSize = IFileManager::Get().FileSize(*Req.ResponseFileName);
+		UE_LOG(LogTemp, Log, TEXT("HTTP-request %s saved %lld bytes to %s"), *Req.Name.ToString(), FileSize, *Req.ResponseFileName);
+
+		if (!Req.UseGlobalDelegates())
+		{
+			return true;
+		}
+		if (bResponseInGameThread && !IsInGameThread())
+		{
+			AsyncTask(ENamedThreads::GameThread, [this, Keyword = Req.Name, ResponseCode, FileName = Req.ResponseFileName, FileSize]()
+			{
+				OnFileResponse.Broadcast(Keyword, ResponseCode, FileName, FileSize);
+			});
+		}
+		else
+		{
+			OnFileResponse.Broadcast(Req.Name, ResponseCode, Req.ResponseFileName, FileSize);
+		}
+		return true;
+	}
+	else
+	{
+		if (!Req.bResumeDownload)
+		{
+			IFileManager::Get().Delete(*TempFileName, false, true, true);
+		}
+
+		if (!Req.UseGlobalDelegates())
+		{
+			return false;
+		}
+		if (bResponseInGameThread && !IsInGameThread())
+		{
+			AsyncTask(ENamedThreads::GameThread, [this, Keyword = Req.Name, ResponseCode]()
+			{
+				OnResponseError.Broadcast(Keyword, ResponseCode);
+				Subscriptions.Broadcast(Keyword, &FYnnkHttpSubscriptions::FSubscribers::Error, ResponseCode);
+			});
+		}
+		else
+		{
+			OnResponseError.Broadcast(Req.Name, ResponseCode);
+			Subscriptions.Broadcast(Req.Name, &FYnnkHttpSubscriptions::FSubscribers::Error, ResponseCode);
+		}
+	}
+	return false;
+}
+
+const TCHAR* UHTTPSubsystem::GetContentTypeForFile(const FString& FileName)
+{
+	const FString Extension = FPaths::GetExtension(FileName).ToLower();
+	if (Extension == TEXT("wav"))
+	{
+		return TEXT("audio/wav");
+	}
+	else if (Extension == TEXT("mp3"))
+	{
+		return TEXT("audio/mpeg");
+	}
+	else if (Extension == TEXT("ogg"))
+	{
+		return TEXT("audio/ogg");
+	}
+	else if (Extension == TEXT("json"))
+	{
+		return TEXT("application/json");
+	}
+	else if (Extension == TEXT("txt"))
+	{
+		return TEXT("text/plain");
+	}
+	return TEXT("application/octet-stream");
+}
+
+bool UHTTPSubsystem::StartAttempt(int32 ReqId)
+{
+	FScopeLock Lock(&RequestsLock);
+
+	FYnnkNamedHttpRequest& Req = HttpRequests[ReqId];
+	auto& HttpRequest = Req.HttpRequest;
+
+	Req.Attempt++;
+	Req.Timing.StartAttempt(FPlatformTime::Seconds());
+	Req.StreamOwner = nullptr;
+	Req.bFirstByteReceived = false;
+	Req.bStreamEncodingChecked = false;
+	Req.Inflater.Reset();
+	if (Req.ResponseFormat == EExpectedResponseType::StreamText)
+	{
+		if (!Req.TextDecoder.IsValid())
+		{
+			Req.TextDecoder = MakeShared<FYnnkUtf8StreamDecoder>();
+		}
+		Req.TextDecoder->Reset();
+
+		if (Req.Options.bAccumulateText)
+		{
+			if (!Req.TextAccumulator.IsValid())
+			{
+				Req.TextAccumulator = MakeShared<FYnnkTextAccumulator, ESPMode::ThreadSafe>(Req.Options.AccumulatedTokenPath);
+			}
+			Req.TextAccumulator->Reset();
+		}
+	}
+	if (Req.FormatStream())
+	{
+		StreamBackpressure->SetMaxBytes(MaxPendingStreamBytes);
+		const int32 BufferSize = FMath::Max(Req.Options.StreamBufferSize, 4096);
+		if (!Req.StreamBuffer.IsValid() || Req.StreamBuffer->GetCapacity() != BufferSize)
+		{
+			Req.StreamBuffer = MakeShared<FYnnkStreamRingBuffer, ESPMode::ThreadSafe>(BufferSize, StreamBackpressure);
+		}
+		else
+		{
+			Req.StreamBuffer->Reset();
+		}
+	}
+	if (Req.ResponseFormat == EExpectedResponseType::StreamAudio)
+	{
+		if (!Req.AudioReframer.IsValid())
+		{
+			Req.AudioReframer = MakeShared<FYnnkPcmStreamReframer>();
+		}
+		Req.AudioReframer->Init(Req.Options.AudioStream);
+	}
+	if (Req.IsFileResponse())
+	{
+		PrepareResponseFile(Req);
+	}
+
+	Req.Recording.Reset();
+	if (TransportMode == EYnnkHttpTransportMode::Replay)
+	{
+		StartReplay(ReqId);
+		return true;
+	}
+	if (TransportMode == EYnnkHttpTransportMode::Record)
+	{
+		Req.Recording = MakeShared<FYnnkHttpRecording, ESPMode::ThreadSafe>();
+		Req.Recording->Keyword = Req.Name.ToString();
+		Req.Recording->Verb = HttpRequest->GetVerb();
+		Req.Recording->URL = HttpRequest->GetURL();
+		Req.Recording->RequestHash = FYnnkHttpRecording::MakeRequestHash(*HttpRequest, Req.BodyFileName, Req.BodyStream.Get());
+	}
+
+	Req.Timing.bWarmConnection = IsHostWarm(HttpRequest->GetURL());
+	HttpRequest->OnProcessRequestComplete().BindUObject(this, &UHTTPSubsystem::OnHTTPRequestComplete, ReqId);
+	if (bCollectMetrics)
+	{
+		HttpRequest->OnHeaderReceived().BindWeakLambda(this, [this, ReqId](FHttpRequestPtr Request, const FString& HeaderName, const FString& HeaderValue)
+		{
+			FScopeLock Lock(&RequestsLock);
+			FYnnkNamedHttpRequest* NamedRequest = HttpRequests.Find(ReqId);
+			if (NamedRequest && NamedRequest->Timing.HeadersTime == 0.0 && Request == NamedRequest->HttpRequest)
+			{
+				NamedRequest->Timing.HeadersTime = FPlatformTime::Seconds();
+			}
+		});
+	}
+#if ENGINE_MINOR_VERSION > 3
+	HttpRequest->OnRequestProgress64().BindUObject(this, &UHTTPSubsystem::OnRequestProgress, ReqId);
+#else
+	HttpRequest->OnRequestProgress().BindWeakLambda(this, [this, ReqId](FHttpRequestPtr Request, int32 BytesSent, int32 BytesReceived)
+	{
+		OnRequestProgress(Request, (uint64)BytesSent, (uint64)BytesReceived, ReqId);
+	});
+#endif
+	if (Req.UseStreamDelegate())
+	{
+#if ENGINE_MINOR_VERSION > 4
+		HttpRequest->SetResponseBodyReceiveStreamDelegateV2(FHttpRequestStreamDelegateV2::CreateUObject(this, &UHTTPSubsystem::StreamChunkReceivedWrapperV2, ReqId, (const IHttpRequest*)HttpRequest.Get()));
+#elif ENGINE_MINOR_VERSION > 2
+		HttpRequest->SetResponseBodyReceiveStreamDelegate(FHttpRequestStreamDelegate::CreateUObject(this, &UHTTPSubsystem::StreamChunkReceivedWrapper, ReqId, (const IHttpRequest*)HttpRequest.Get()));
+#endif
+	}
+
+	const FYnnkRetryPolicy& Policy = Req.Options.RetryPolicy;
+	if (Policy.HedgeDelay > 0.f)
+	{
+		Req.HedgeTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this, ReqId, Primary = TWeakPtr<IHttpRequest, ESPMode::ThreadSafe>(HttpRequest)](float DeltaTime)
+		{
+			SendHedgeRequest(ReqId, Primary);
+			return false;
+		}), Policy.HedgeDelay);
+	}
+
+	YNNK_HTTP_TRACE_EVENT(Started, ReqId, Req.Name, 0, Req.Attempt);
+	return HttpRequest->ProcessRequest();
+}
+
+TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> UHTTPSubsystem::CloneHttpRequest(const FYnnkNamedHttpRequest& Req, const TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>& Source) const
+{
+	TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> NewRequest = FHttpModule::Get().CreateRequest();
+	NewRequest->SetTimeout(GetAttemptTimeout(Req.Options));
+	NewRequest->SetURL(Source->GetURL());
+	NewRequest->SetVerb(Source->GetVerb());
+
+	for (const FString& Header : Source->GetAllHeaders())
+	{
+		FString Name, Value;
+		if (Header.Split(TEXT(":"), &Name, &Value))
+		{
+			NewRequest->SetHeader(Name.TrimStartAndEnd(), Value.TrimStartAndEnd());
+		}
+	}
+
+	if (!Req.BodyFileName.IsEmpty())
+	{
+		NewRequest->SetContentAsStreamedFile(Req.BodyFileName);
+	}
+#if ENGINE_MINOR_VERSION > 0
+	else if (Req.BodyStream.IsValid())
+	{
+		Req.BodyStream->Seek(0);
+		NewRequest->SetContentFromStream(Req.BodyStream.ToSharedRef());
+	}
+#endif
+	else
+	{
+		NewRequest->SetContent(Source->GetContent());
+	}
+
+	return NewRequest;
+}
+
+bool UHTTPSubsystem::ScheduleRetry(int32 ReqId, const FHttpResponsePtr& Response)
+{
+	FYnnkNamedHttpRequest& Req = HttpRequests[ReqId];
+	const FYnnkRetryPolicy& Policy = Req.Options.RetryPolicy;
+	if (Req.Attempt >= Policy.MaxAttempts)
+	{
+		return false;
+	}
+
+	float Delay = Policy.GetBackoff(Req.Attempt);
+	if (Response.IsValid())
+	{
+		// Retry-After in seconds or http-date
+		const float RetryAfter = FYnnkHttpHeaders(Response).GetRetryAfter();
+		if (RetryAfter >= 0.f)
+		{
+			Delay = FMath::Max(Delay, RetryAfter);
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("HTTP-request %s failed (attempt %d of %d). Retry in %.2f s"), *Req.Name.ToString(), Req.Attempt, Policy.MaxAttempts, Delay);
+
+	Req.RetryTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this, ReqId](float DeltaTime)
+	{
+		FYnnkNamedHttpRequest* NamedRequest = HttpRequests.Find(ReqId);
+		if (NamedRequest && NamedRequest->HttpRequest.IsValid())
+		{
+			NamedRequest->RetryTickerHandle.Reset();
+			TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> NewRequest = CloneHttpRequest(*NamedRequest, NamedRequest->HttpRequest);
+			{
+				FScopeLock Lock(&RequestsLock);
+				NamedRequest->HttpRequest = NewRequest;
+			}
+			if (!StartAttempt(ReqId))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("HTTP-request %s: unable to process retry"), *NamedRequest->Name.ToString());
+			}
+		}
+		return false;
+	}), Delay);
+
+	return true;
+}
+
+void UHTTPSubsystem::SendHedgeRequest(int32 ReqId, TWeakPtr<IHttpRequest, ESPMode::ThreadSafe> PrimaryRequest)
+{
+	FYnnkNamedHttpRequest* Req = HttpRequests.Find(ReqId);
+	if (!Req)
+	{
+		return;
+	}
+	Req->HedgeTickerHandle.Reset();
+
+	const TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> Primary = PrimaryRequest.Pin();
+	if (!Primary.IsValid() || Primary != Req->HttpRequest || Req->HedgeRequest.IsValid() || Req->bFirstByteReceived || Req->StreamOwner
+		|| EHttpRequestStatus::IsFinished(Primary->GetStatus()))
+	{
+		return;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("HTTP-request %s: no response in %.2f s, sending hedged request"), *Req->Name.ToString(), Req->Options.RetryPolicy.HedgeDelay);
+
+	TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> HedgeRequest = CloneHttpRequest(*Req, Primary);
+	HedgeRequest->OnProcessRequestComplete().BindUObject(this, &UHTTPSubsystem::OnHTTPRequestComplete, ReqId);
+	if (Req->UseStreamDelegate())
+	{
+#if ENGINE_MINOR_VERSION > 4
+		HedgeRequest->SetResponseBodyReceiveStreamDelegateV2(FHttpRequestStreamDelegateV2::CreateUObject(this, &UHTTPSubsystem::StreamChunkReceivedWrapperV2, ReqId, (const IHttpRequest*)HedgeRequest.Get()));
+#elif ENGINE_MINOR_VERSION > 2
+		HedgeRequest->SetResponseBodyReceiveStreamDelegate(FHttpRequestStreamDelegate::CreateUObject(this, &UHTTPSubsystem::StreamChunkReceivedWrapper, ReqId, (const IHttpRequest*)HedgeRequest.Get()));
+#endif
+	}
+
+	{
+		FScopeLock Lock(&RequestsLock);
+		Req->HedgeRequest = HedgeRequest;
+	}
+	HedgeRequest->ProcessRequest();
+}
+
+void UHTTPSubsystem::AbandonHttpRequest(TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>& Request)
+{
+	if (Request.IsValid())
+	{
+		// stream delegate is bound to weak subsystem and ignores requests which aren't in HttpRequests
+		Request->OnProcessRequestComplete().Unbind();
+		Request->OnHeaderReceived().Unbind();
+#if ENGINE_MINOR_VERSION > 3
+		Request->OnRequestProgress64().Unbind();
+#else
+		Request->OnRequestProgress().Unbind();
+#endif
+		if (!EHttpRequestStatus::IsFinished(Request->GetStatus()))
+		{
+			Request->CancelRequest();
+		}
+		Request = nullptr;
+	}
+}
+
+void UHTTPSubsystem::ReleaseRequest(int32 ReqId, bool bCancel)
+{
+	FScopeLock Lock(&RequestsLock);
+
+	if (FYnnkNamedHttpRequest* Req = HttpRequests.Find(ReqId))
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(Req->RetryTickerHandle);
+		FTSTicker::GetCoreTicker().RemoveTicker(Req->HedgeTickerHandle);
+		Req->RetryTickerHandle.Reset();
+		Req->HedgeTickerHandle.Reset();
+
+		AbandonHttpRequest(Req->HedgeRequest);
+		if (Req->HttpRequest.IsValid())
+		{
+			Req->HttpRequest->OnHeaderReceived().Unbind();
+			if (bCancel)
+			{
+				AbandonHttpRequest(Req->HttpRequest);
+			}
+			else
+			{
+				Req->HttpRequest->OnProcessRequestComplete().Unbind();
+				Req->HttpRequest = nullptr;
+			}
+			DEC_DWORD_STAT(STAT_YnnkHttpActiveRequests);
+		}
+		Req->StreamOwner = nullptr;
+		Req->Inflater.Reset();
+		Req->BodyStream.Reset();
+		Req->ResponseFileWriter.Reset();
+		Req->Recording.Reset();
+		Req->Replay.Reset();
+		Req->Callbacks.Reset();
+		Req->TextAccumulator.Reset();
+
+		if (bCancel)
+		{
+			// http thread can still hold stream buffer while pushing the last chunk
+			Req->StreamBuffer.Reset();
+			Req->AudioReframer.Reset();
+			Req->TempBinaryData.Empty();
+			// listener in http thread can still use them
+			Req->StreamScratch.Reset();
+			Req->TextDecoder.Reset();
+		}
+	}
+}
+
+FYnnkNamedHttpRequest* UHTTPSubsystem::FindRequest(const FYnnkHttpRequestHandle& Handle)
+{
+	FYnnkNamedHttpRequest* Req = HttpRequests.Find(Handle.RequestId);
+	return Req && Req->HttpRequest.IsValid() && Req->Serial == Handle.Serial ? Req : nullptr;
+}
+
+const FYnnkNamedHttpRequest* UHTTPSubsystem::FindRequest(const FYnnkHttpRequestHandle& Handle) const
+{
+	const FYnnkNamedHttpRequest* Req = HttpRequests.Find(Handle.RequestId);
+	return Req && Req->HttpRequest.IsValid() && Req->Serial == Handle.Serial ? Req : nullptr;
+}
+
+void UHTTPSubsystem::SubscribeToTextStream(FName Keyword, FHttpKeywordTextEvent Event)
+{
+	Subscriptions.Add(Keyword, &FYnnkHttpSubscriptions::FSubscribers::TextStream, Event);
+}
+
+void UHTTPSubsystem::SubscribeToDataStream(FName Keyword, FHttpKeywordDataEvent Event)
+{
+	Subscriptions.Add(Keyword, &FYnnkHttpSubscriptions::FSubscribers::DataStream, Event);
+}
+
+void UHTTPSubsystem::SubscribeToTextResponse(FName Keyword, FHttpKeywordTextResponseEvent Event)
+{
+	Subscriptions.Add(Keyword, &FYnnkHttpSubscriptions::FSubscribers::TextResponse, Event);
+}
+
+void UHTTPSubsystem::SubscribeToDataResponse(FName Keyword, FHttpKeywordDataResponseEvent Event)
+{
+	Subscriptions.Add(Keyword, &FYnnkHttpSubscriptions::FSubscribers::DataResponse, Event);
+}
+
+void UHTTPSubsystem::SubscribeToError(FName Keyword, FHttpKeywordErrorEvent Event)
+{
+	Subscriptions.Add(Keyword, &FYnnkHttpSubscriptions::FSubscribers::Error, Event);
+}
+
+void UHTTPSubsystem::Unsubscribe(UObject* Listener, FName Keyword)
+{
+	Subscriptions.Remove(Keyword, Listener);
+}
+
+bool UHTTPSubsystem::IsRequestActive(const FYnnkHttpRequestHandle& Handle) const
+{
+	return FindRequest(Handle) != nullptr;
+}
+
+FYnnkStreamBackpressureStats UHTTPSubsystem::GetStreamBackpressureStats() const
+{
+	FYnnkStreamBackpressureStats Stats;
+	if (StreamBackpressure.IsValid())
+	{
+		Stats.PendingBytes = StreamBackpressure->GetUsedBytes();
+		Stats.PeakPendingBytes = StreamBackpressure->GetPeakBytes();
+		Stats.Parks = StreamBackpressure->NumParks;
+		Stats.ParkedTime = StreamBackpressure->ParkedMicroseconds / 1000000.f;
+		Stats.CoalescedChunks = StreamBackpressure->NumCoalescedChunks;
+		Stats.DroppedFrames = StreamBackpressure->NumDroppedFrames;
+	}
+	return Stats;
+}
+
+void UHTTPSubsystem::ResetStreamBackpressureStats()
+{
+	if (StreamBackpressure.IsValid())
+	{
+		StreamBackpressure->ResetCounters();
+	}
+}
+
+FString UHTTPSubsystem::GetStreamedText(const FYnnkHttpRequestHandle& Handle) const
+{
+	const FYnnkNamedHttpRequest* Req = FindRequest(Handle);
+	return Req && Req->TextAccumulator.IsValid() ? Req->TextAccumulator->GetText() : FString();
+}
+
+bool UHTTPSubsystem::ReadNewStreamedText(const FYnnkHttpRequestHandle& Handle, FString& NewText)
+{
+	const FYnnkNamedHttpRequest* Req = FindRequest(Handle);
+	if (!Req || !Req->TextAccumulator.IsValid())
+	{
+		NewText.Reset();
+		return false;
+	}
+	return Req->TextAccumulator->ReadNewText(NewText);
+}
+
+bool UHTTPSubsystem::CancelRequest(const FYnnkHttpRequestHandle& Handle)
+{
+	return FindRequest(Handle) ? CancelRequestById(Handle.RequestId) : false;
+}
+
+int32 UHTTPSubsystem::CancelRequestsByKeyword(FName Keyword)
+{
+	TArray<int32, TInlineAllocator<8>> Cancelled;
+	for (const auto& Req : HttpRequests)
+	{
+		if (Req.Value.Name == Keyword && Req.Value.HttpRequest.IsValid())
+		{
+			Cancelled.Add(Req.Key);
+		}
+	}
+
+	int32 NumCancelled = 0;
+	for (const int32 ReqId : Cancelled)
+	{
+		if (CancelRequestById(ReqId))
+		{
+			NumCancelled++;
+		}
+	}
+	return NumCancelled;
+}
+
+bool UHTTPSubsystem::CancelRequestById(int32 ReqId)
+{
+	FYnnkNamedHttpRequest* Req = HttpRequests.Find(ReqId);
+	if (!Req || !Req->HttpRequest.IsValid())
+	{
+		return false;
+	}
+
+	const FName RequestName = Req->Name;
+	const FYnnkHttpRequestHandle Handle(ReqId, Req->Serial);
+	const TSharedPtr<FYnnkHttpRequestCallbacks, ESPMode::ThreadSafe> Callbacks = Req->Callbacks;
+	const bool bGlobalDelegates = Req->UseGlobalDelegates();
+	UE_LOG(LogTemp, Log, TEXT("HTTP-request %s cancelled"), *RequestName.ToString());
+	YNNK_HTTP_TRACE_EVENT(Cancelled, ReqId, RequestName, 0, Req->Attempt);
+
+	if (Req->IsFileResponse())
+	{
+		FScopeLock Lock(&RequestsLock);
+		if (Req->ResponseFileWriter.IsValid())
+		{
+			Req->ResponseFileWriter->Close();
+			Req->ResponseFileWriter.Reset();
+		}
+		// partial file is kept to be resumed
+		if (!Req->bResumeDownload)
+		{
+			IFileManager::Get().Delete(*Req->GetResponseTempFileName(), false, true, true);
+		}
+	}
+
+	ReleaseRequest(ReqId, true);
+	if (bGlobalDelegates)
+	{
+		OnRequestCancelled.Broadcast(RequestName, Handle);
+	}
+	if (Callbacks.IsValid())
+	{
+		FYnnkHttpResponse Response;
+		Response.RequestName = RequestName;
+		Response.Handle = Handle;
+		Response.bCancelled = true;
+		ExecuteCompleteCallback(Callbacks, MoveTemp(Response));
+	}
+	return true;
+}
+
+void UHTTPSubsystem::ExecuteCompleteCallback(const TSharedPtr<FYnnkHttpRequestCallbacks, ESPMode::ThreadSafe>& Callbacks, FYnnkHttpResponse&& Response)
+{
+	if (!Callbacks.IsValid() || !Callbacks->OnComplete.IsBound())
+	{
+		return;
+	}
+
+	if (bResponseInGameThread && !IsInGameThread())
+	{
+		AsyncTask(ENamedThreads::GameThread, [Callbacks, Response = MoveTemp(Response)]()
+		{
+			Callbacks->OnComplete.ExecuteIfBound(Response);
+		});
+	}
+	else
+	{
+		Callbacks->OnComplete.Execute(Response);
+	}
+}
+
+void UHTTPSubsystem::RecordRequestMetrics(int32 ReqId, int64 ContentSize, int32 ResponseCode, bool bWasSuccessful)
+{
+	if (!bCollectMetrics)
+	{
+		return;
+	}
+
+	const FYnnkNamedHttpRequest& Req = HttpRequests[ReqId];
+	FYnnkHttpRequestTiming Timing;
+	{
+		FScopeLock Lock(&RequestsLock);
+		Timing = Req.Timing;
+	}
+	auto SinceSend = [&Timing](double Time)
+	{
+		return Time > 0.0 ? (float)(Time - Timing.SendTime) : 0.f;
+	};
+
+	FYnnkHttpRequestMetrics RequestMetrics;
+	RequestMetrics.Keyword = Req.Name;
+	RequestMetrics.Host = Req.HttpRequest.IsValid() ? FPlatformHttp::GetUrlDomain(Req.HttpRequest->GetURL()) : FString();
+	RequestMetrics.ResponseCode = ResponseCode;
+	RequestMetrics.bSucceeded = bWasSuccessful && ResponseCode >= 200 && ResponseCode < 400;
+	RequestMetrics.Attempts = Req.Attempt;
+	RequestMetrics.bReusedConnection = Timing.bWarmConnection;
+	RequestMetrics.QueueTime = (float)(Timing.SendTime - Timing.SubmitTime);
+	RequestMetrics.ConnectTime = SinceSend(Timing.HeadersTime);
+	RequestMetrics.TimeToFirstByte = SinceSend(Timing.FirstByteTime);
+	RequestMetrics.TimeToFirstToken = SinceSend(Timing.FirstTokenTime);
+	RequestMetrics.TotalTime = (float)(FPlatformTime::Seconds() - Timing.SubmitTime);
+	RequestMetrics.BytesReceived = Timing.ChunksReceived > 0 ? Timing.BytesReceived : ContentSize;
+	RequestMetrics.ChunksReceived = Timing.ChunksReceived;
+	if (Timing.ChunksReceived > 1)
+	{
+		RequestMetrics.MeanChunkInterval = (float)(Timing.ChunkIntervalSum / (Timing.ChunksReceived - 1));
+		RequestMetrics.MaxChunkInterval = (float)Timing.ChunkIntervalMax;
+	}
+
+	UE_LOG(LogTemp, Verbose, TEXT("HTTP-request %s: code %d, queue %.3f s, headers %.3f s, first byte %.3f s, total %.3f s, %lld bytes in %d chunks"),
+		*Req.Name.ToString(), ResponseCode, RequestMetrics.QueueTime, RequestMetrics.ConnectTime, RequestMetrics.TimeToFirstByte, RequestMetrics.TotalTime, RequestMetrics.BytesReceived, RequestMetrics.ChunksReceived);
+
+	Metrics.Record(RequestMetrics);
+	OnMetricsRecorded.Broadcast(RequestMetrics.Keyword, RequestMetrics);
+	OnRequestMetrics.Broadcast(RequestMetrics.Keyword, RequestMetrics);
+}
+
+bool UHTTPSubsystem::GetKeywordMetrics(FName Keyword, FYnnkHttpMetricsSnapshot& Snapshot) const
+{
+	return Metrics.GetKeywordSnapshot(Keyword, Snapshot);
+}
+
+bool UHTTPSubsystem::GetHostMetrics(const FString& Host, FYnnkHttpMetricsSnapshot& Snapshot) const
+{
+	return Metrics.GetHostSnapshot(Host, Snapshot);
+}
+
+FYnnkHttpMetricsSnapshot UHTTPSubsystem::GetTotalMetrics() const
+{
+	FYnnkHttpMetricsSnapshot Snapshot;
+	Metrics.GetTotalSnapshot(Snapshot);
+	return Snapshot;
+}
+
+void UHTTPSubsystem::GetAllMetrics(TArray<FYnnkHttpMetricsSnapshot>& Keywords, TArray<FYnnkHttpMetricsSnapshot>& Hosts) const
+{
+	Metrics.GetAllSnapshots(Keywords, Hosts);
+}
+
+void UHTTPSubsystem::ResetMetrics()
+{
+	Metrics.Reset();
+}
+
+void UHTTPSubsystem::SetTransportMode(EYnnkHttpTransportMode Mode, const FString& Directory)
+{
+	TransportMode = Mode;
+	RecordingDirectory = Directory.IsEmpty() ? FString() : FPaths::ConvertRelativePathToFull(Directory);
+
+	// recordings are scanned again by next replayed request
+	ReplayIndex.Reset();
+	RecordingSession.Empty();
+	RecordingCounter = 0;
+}
+
+FString UHTTPSubsystem::GetRecordingDirectory() const
+{
+	return RecordingDirectory.IsEmpty() ? FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("HttpRecordings")) : RecordingDirectory;
+}
+
+void UHTTPSubsystem::SaveRecording(int32 ReqId, const FYnnkHttpResponseView& Response, bool bWasSuccessful)
+{
+	FYnnkNamedHttpRequest& Req = HttpRequests[ReqId];
+	TSharedPtr<FYnnkHttpRecording, ESPMode::ThreadSafe> Recording;
+	double SendTime, HeadersTime;
+	{
+		FScopeLock Lock(&RequestsLock);
+		Recording = MoveTemp(Req.Recording);
+		SendTime = Req.Timing.SendTime;
+		HeadersTime = Req.Timing.HeadersTime;
+	}
+
+	Recording->bHasResponse = Response.bValid;
+	Recording->bSucceeded = bWasSuccessful;
+	Recording->ResponseCode = Response.Code;
+	Recording->ContentType = Response.ContentType;
+	Recording->Headers = Response.Headers.ToArray();
+	Recording->HeadersTime = HeadersTime > 0.0 ? HeadersTime - SendTime : 0.0;
+	Recording->TotalTime = FPlatformTime::Seconds() - SendTime;
+	if (Response.Content)
+	{
+		Recording->Content = *Response.Content;
+	}
+
+	if (RecordingSession.IsEmpty())
+	{
+		RecordingSession = FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S"));
+	}
+	const FString FileName = FYnnkHttpReplayIndex::MakeFileName(GetRecordingDirectory(), Req.Name, Recording->RequestHash, RecordingSession, RecordingCounter++);
+	UE_LOG(LogTemp, Verbose, TEXT("HTTP-request %s recorded to %s"), *Req.Name.ToString(), *FileName);
+	FYnnkHttpReplayIndex::SaveAsync(Recording, FileName);
+}
+
+void UHTTPSubsystem::StartReplay(int32 ReqId)
+{
+	FYnnkNamedHttpRequest& Req = HttpRequests[ReqId];
+	if (!ReplayIndex.IsValid())
+	{
+		ReplayIndex = MakeShared<FYnnkHttpReplayIndex>();
+		ReplayIndex->Scan(GetRecordingDirectory());
+	}
+
+	Req.ReplayChunk = 0;
+	Req.Replay = ReplayIndex->Find(Req.Name, FYnnkHttpRecording::MakeRequestHash(*Req.HttpRequest, Req.BodyFileName, Req.BodyStream.Get()));
+	if (!Req.Replay.IsValid())
+	{
+		// replayed as request failed without response
+		UE_LOG(LogTemp, Warning, TEXT("HTTP-request %s: no recording to replay %s %s"), *Req.Name.ToString(), *Req.HttpRequest->GetVerb(), *Req.HttpRequest->GetURL());
+		Req.Replay = MakeShared<const FYnnkHttpRecording, ESPMode::ThreadSafe>();
+	}
+
+	YNNK_HTTP_TRACE_EVENT(Started, ReqId, Req.Name, 0, Req.Attempt);
+	if (!ReplayTickerHandle.IsValid())
+	{
+		ReplayTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UHTTPSubsystem::TickReplay));
+	}
+}
+
+bool UHTTPSubsystem::TickReplay(float DeltaTime)
+{
+	const double Now = FPlatformTime::Seconds();
+
+	TArray<int32, TInlineAllocator<32>> ReplayedRequests;
+	for (const auto& Req : HttpRequests)
+	{
+		if (Req.Value.Replay.IsValid())
+		{
+			ReplayedRequests.Add(Req.Key);
+		}
+	}
+	for (const int32 ReqId : ReplayedRequests)
+	{
+		AdvanceReplay(ReqId, Now);
+	}
+
+	for (const auto& Req : HttpRequests)
+	{
+		if (Req.Value.Replay.IsValid())
+		{
+			return true;
+		}
+	}
+	ReplayTickerHandle.Reset();
+	return false;
+}
+
+void UHTTPSubsystem::AdvanceReplay(int32 ReqId, double Now)
+{
+	FYnnkNamedHttpRequest* Req = HttpRequests.Find(ReqId);
+	if (!Req || !Req->Replay.IsValid())
+	{
+		return;
+	}
+
+	const TSharedPtr<const FYnnkHttpRecording, ESPMode::ThreadSafe> Recording = Req->Replay;
+	const double Elapsed = ReplaySpeed > 0.f ? (Now - Req->Timing.SendTime) * ReplaySpeed : TNumericLimits<double>::Max();
+
+	if (Req->Timing.HeadersTime == 0.0 && Recording->bHasResponse && Elapsed >= Recording->HeadersTime)
+	{
+		FScopeLock Lock(&RequestsLock);
+		Req->Timing.HeadersTime = Now;
+	}
+
+	// chunks go through the same path as chunks of http module
+	while (Req->ReplayChunk < Recording->Chunks.Num() && Recording->Chunks[Req->ReplayChunk].Time <= Elapsed)
+	{
+		const FYnnkHttpRecording::FChunk& Chunk = Recording->Chunks[Req->ReplayChunk++];
+		StreamChunkReceivedWrapper((void*)(Recording->StreamData.GetData() + Chunk.Offset), Chunk.Size, ReqId, Req->HttpRequest.Get());
+
+		// listeners can send new requests
+		Req = HttpRequests.Find(ReqId);
+		if (!Req || Req->Replay != Recording)
+		{
+			return;
+		}
+	}
+
+	if (Req->ReplayChunk < Recording->Chunks.Num() || Elapsed < Recording->TotalTime)
+	{
+		return;
+	}
+
+	{
+		FScopeLock Lock(&RequestsLock);
+		Req->Replay.Reset();
+	}
+	YNNK_HTTP_TRACE_EVENT(Completed, ReqId, Req->Name, Recording->Content.Num(), Recording->ResponseCode);
+
+	FYnnkHttpResponseView Response;
+	Response.bValid = Recording->bHasResponse;
+	Response.Code = Recording->ResponseCode;
+	Response.ContentType = Recording->ContentType;
+	Response.Headers = FYnnkHttpHeaders(Recording->Headers);
+	Response.Content = &Recording->Content;
+	CompleteRequest(ReqId, Response, Recording->bSucceeded);
+}
+
+void UHTTPSubsystem::OnRequestProgress(FHttpRequestPtr Request, uint64 BytesSent, uint64 BytesReceived, int32 ReqId)
+{
+	FYnnkNamedHttpRequest* Req = HttpRequests.Find(ReqId);
+	if (!Req || Request != Req->HttpRequest)
+	{
+		return;
+	}
+
+	if (BytesReceived > 0 && !Req->bFirstByteReceived)
+	{
+		FScopeLock Lock(&RequestsLock);
+		Req->bFirstByteReceived = true;
+		if (Req->Timing.FirstByteTime == 0.0)
+		{
+			Req->Timing.FirstByteTime = FPlatformTime::Seconds();
+		}
+	}
+	if (Req->Options.bReportProgress)
+	{
+		OnRequestProgressUpdated.Broadcast(Req->Name, (int64)BytesSent, (int64)Request->GetContentLength(), (int64)BytesReceived);
+	}
+}
+
+bool UHTTPSubsystem::SendHttpRequest(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FString& BodyString, EExpectedResponseType ExpectedResponseFormat)
+{
+	return SendHttpRequestInternal(Keyword, URL, Verb, HeaderParams, BodyString, {}, ExpectedResponseFormat, DefaultOptions);
+}
+
+bool UHTTPSubsystem::SendHttpRequestData(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const TArray<uint8>& BodyData, EExpectedResponseType ExpectedResponseFormat)
+{
+	return SendHttpRequestInternal(Keyword, URL, Verb, HeaderParams, TEXT("!!NULL"), BodyData, ExpectedResponseFormat, DefaultOptions);
+}
+
+FYnnkHttpRequestHandle UHTTPSubsystem::SendRequest(FName Keyword, const FString& URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FString& BodyString,
+	EExpectedResponseType ExpectedResponseFormat, const FYnnkHttpRequestOptions& Options, FYnnkHttpRequestCallbacks Callbacks)
+{
+	const TSharedPtr<FYnnkHttpRequestCallbacks, ESPMode::ThreadSafe> SharedCallbacks = MakeShared<FYnnkHttpRequestCallbacks, ESPMode::ThreadSafe>(MoveTemp(Callbacks));
+	const bool bSent = SendHttpRequestInternal(Keyword, URL, Verb, HeaderParams, BodyString, {}, ExpectedResponseFormat, Options, SharedCallbacks);
+	if (!bSent && !IsRequestActive(LastRequestHandle))
+	{
+		FYnnkHttpResponse Response;
+		Response.RequestName = Keyword;
+		ExecuteCompleteCallback(SharedCallbacks, MoveTemp(Response));
+		return FYnnkHttpRequestHandle();
+	}
+	return LastRequestHandle;
+}
+
+FYnnkHttpRequestHandle UHTTPSubsystem::SendRequestData(FName Keyword, const FString& URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const TArray<uint8>& BodyData,
+	EExpectedResponseType ExpectedResponseFormat, const FYnnkHttpRequestOptions& Options, FYnnkHttpRequestCallbacks Callbacks)
+{
+	const TSharedPtr<FYnnkHttpRequestCallbacks, ESPMode::ThreadSafe> SharedCallbacks = MakeShared<FYnnkHttpRequestCallbacks, ESPMode::ThreadSafe>(MoveTemp(Callbacks));
+	const bool bSent = SendHttpRequestInternal(Keyword, URL, Verb, HeaderParams, TEXT("!!NULL"), BodyData, ExpectedResponseFormat, Options, SharedCallbacks);
+	if (!bSent && !IsRequestActive(LastRequestHandle))
+	{
+		FYnnkHttpResponse Response;
+		Response.RequestName = Keyword;
+		ExecuteCompleteCallback(SharedCallbacks, MoveTemp(Response));
+		return FYnnkHttpRequestHandle();
+	}
+	return LastRequestHandle;
+}
+
+TFuture<FYnnkHttpResponse> UHTTPSubsystem::SendRequestAsync(FName Keyword, const FString& URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FString& BodyString,
+	EExpectedResponseType ExpectedResponseFormat, const FYnnkHttpRequestOptions& Options)
+{
+	const TSharedRef<TPromise<FYnnkHttpResponse>, ESPMode::ThreadSafe> Promise = MakeShared<TPromise<FYnnkHttpResponse>, ESPMode::ThreadSafe>();
+	TFuture<FYnnkHttpResponse> Future = Promise->GetFuture();
+
+	FYnnkHttpRequestCallbacks Callbacks;
+	Callbacks.OnComplete.BindLambda([Promise](const FYnnkHttpResponse& Response)
+	{
+		Promise->SetValue(Response);
+	});
+	SendRequest(Keyword, URL, Verb, HeaderParams, BodyString, ExpectedResponseFormat, Options, MoveTemp(Callbacks));
+
+	return Future;
+}
+
+TFuture<FYnnkHttpResponse> UHTTPSubsystem::SendRequestDataAsync(FName Keyword, const FString& URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const TArray<uint8>& BodyData,
+	EExpectedResponseType ExpectedResponseFormat, const FYnnkHttpRequestOptions& Options)
+{
+	const TSharedRef<TPromise<FYnnkHttpResponse>, ESPMode::ThreadSafe> Promise = MakeShared<TPromise<FYnnkHttpResponse>, ESPMode::ThreadSafe>();
+	TFuture<FYnnkHttpResponse> Future = Promise->GetFuture();
+
+	FYnnkHttpRequestCallbacks Callbacks;
+	Callbacks.OnComplete.BindLambda([Promise](const FYnnkHttpResponse& Response)
+	{
+		Promise->SetValue(Response);
+	});
+	SendRequestData(Keyword, URL, Verb, HeaderParams, BodyData, ExpectedResponseFormat, Options, MoveTemp(Callbacks));
+
+	return Future;
+}
+
+void UHTTPSubsystem::AddWarmupEndpoint(const FString& URL)
+{
+	WarmupEndpoints.AddUnique(URL);
+	WarmUpEndpoint(URL);
+}
+
+void UHTTPSubsystem::RemoveWarmupEndpoint(const FString& URL)
+{
+	WarmupEndpoints.Remove(URL);
+}
+
+bool UHTTPSubsystem::IsHostWarm(const FString& URL) const
+{
+	const double* LastActivity = HostActivity.Find(GetUrlOrigin(URL));
+	return LastActivity && FPlatformTime::Seconds() - *LastActivity < ConnectionIdleTimeout;
+}
+
+void UHTTPSubsystem::MarkHostActivity(const FString& URL)
+{
+	HostActivity.Add(GetUrlOrigin(URL), FPlatformTime::Seconds());
+}
+
+void UHTTPSubsystem::WarmUpEndpoint(const FString& URL)
+{
+	const FString Origin = GetUrlOrigin(URL);
+	if (TransportMode == EYnnkHttpTransportMode::Replay || Origin.IsEmpty() || PendingWarmups.Contains(Origin))
+	{
+		return;
+	}
+	PendingWarmups.Add(Origin);
+
+	// not added to HttpRequests: warm-up isn't visible to delegates and metrics
+	const TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+	Request->SetVerb(WarmupVerb);
+	Request->SetURL(URL);
+	Request->SetTimeout(FMath::Min(Timeout, 10.f));
+	Request->OnProcessRequestComplete().BindWeakLambda(this, [this, Origin](FHttpRequestPtr HttpRequest, FHttpResponsePtr HttpResponse, bool bWasSuccessful)
+	{
+		PendingWarmups.Remove(Origin);
+		// any response code means connection is open
+		if (HttpResponse.IsValid())
+		{
+			HostActivity.Add(Origin, FPlatformTime::Seconds());
+		}
+		else
+		{
+			UE_LOG(LogTemp, Verbose, TEXT("Unable to connect to %s"), *Origin);
+		}
+	});
+	Request->ProcessRequest();
+}
+
+bool UHTTPSubsystem::TickKeepAlive(float DeltaTime)
+{
+	if (KeepAliveInterval <= 0.f || WarmupEndpoints.Num() == 0)
+	{
+		return true;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	for (const FString& URL : WarmupEndpoints)
+	{
+		const double* LastActivity = HostActivity.Find(GetUrlOrigin(URL));
+		if (!LastActivity || Now - *LastActivity >= KeepAliveInterval)
+		{
+			WarmUpEndpoint(URL);
+		}
+	}
+	return true;
+}
+
+int32 UHTTPSubsystem::SendHttpBatch(FName Keyword, const TArray<FYnnkHttpBatchItem>& Items, int32 MaxParallel, const FYnnkHttpRequestOptions& Options)
+{
+	check(IsInGameThread());
+
+	if (Items.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SendHttpBatch: batch %s has no items"), *Keyword.ToString());
+		return INDEX_NONE;
+	}
+
+	if (Options.bReplacePrevious)
+	{
+		CancelRequestsByKeyword(Keyword);
+	}
+
+	TSharedPtr<FYnnkHttpBatch> Batch = MakeShared<FYnnkHttpBatch>();
+	Batch->BatchId = ++NextBatchId;
+	Batch->Keyword = Keyword;
+	Batch->Items = Items;
+	Batch->Options = Options;
+	// items of the same batch must not cancel each other
+	Batch->Options.bReplacePrevious = false;
+	Batch->MaxParallel = FMath::Max(MaxParallel, 1);
+	Batch->Results.SetNum(Items.Num());
+	Batch->Handles.SetNum(Items.Num());
+	Batches.Add(Batch->BatchId, Batch);
+
+	SendBatchItems(Batch);
+	return Batch->BatchId;
+}
+
+int32 UHTTPSubsystem::OpenHttpBatch(FName Keyword, int32 MaxParallel, const FYnnkHttpRequestOptions& Options,
+	TFunction<void(int32 ItemIndex, const FYnnkHttpResponse& Response)> OnItemResponse, TFunction<void(int32 NumSucceeded)> OnCompleted)
+{
+	check(IsInGameThread());
+
+	if (Options.bReplacePrevious)
+	{
+		CancelRequestsByKeyword(Keyword);
+	}
+
+	TSharedPtr<FYnnkHttpBatch> Batch = MakeShared<FYnnkHttpBatch>();
+	Batch->BatchId = ++NextBatchId;
+	Batch->Keyword = Keyword;
+	Batch->Options = Options;
+	Batch->Options.bReplacePrevious = false;
+	Batch->MaxParallel = FMath::Max(MaxParallel, 1);
+	Batch->bClosed = false;
+	Batch->OnItemResponse = MoveTemp(OnItemResponse);
+	Batch->OnCompleted = MoveTemp(OnCompleted);
+	Batches.Add(Batch->BatchId, Batch);
+
+	return Batch->BatchId;
+}
+
+int32 UHTTPSubsystem::AddBatchItem(int32 BatchId, const FYnnkHttpBatchItem& Item)
+{
+	const TSharedPtr<FYnnkHttpBatch> Batch = Batches.FindRef(BatchId);
+	if (!Batch.IsValid() || Batch->bClosed)
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 ItemIndex = Batch->Items.Add(Item);
+	Batch->Results.AddDefaulted();
+	Batch->Handles.AddDefaulted();
+	SendBatchItems(Batch);
+	return ItemIndex;
+}
+
+bool UHTTPSubsystem::CloseBatch(int32 BatchId)
+{
+	const TSharedPtr<FYnnkHttpBatch> Batch = Batches.FindRef(BatchId);
+	if (!Batch.IsValid() || Batch->bClosed)
+	{
+		return false;
+	}
+
+	Batch->bClosed = true;
+	DeliverBatchResponses(Batch);
+	return true;
+}
+
+bool UHTTPSubsystem::CancelBatch(int32 BatchId)
+{
+	TSharedPtr<FYnnkHttpBatch> Batch;
+	if (!Batches.RemoveAndCopyValue(BatchId, Batch))
+	{
+		return false;
+	}
+
+	// batch is already removed, so callbacks of cancelled requests are ignored
+	for (int32 Index = Batch->NextToDeliver; Index < Batch->NextToSend; Index++)
+	{
+		CancelRequest(Batch->Handles[Index]);
+	}
+	return true;
+}
+
+void UHTTPSubsystem::SendBatchItems(TSharedPtr<FYnnkHttpBatch> Batch)
+{
+	Batch->bSending = true;
+	while (Batch->NumActive < Batch->MaxParallel && Batch->NextToSend < Batch->Items.Num() && Batches.Contains(Batch->BatchId))
+	{
+		const int32 ItemIndex = Batch->NextToSend++;
+		Batch->NumActive++;
+		const FYnnkHttpBatchItem& Item = Batch->Items[ItemIndex];
+
+		// responses are delivered as a whole
+		EExpectedResponseType ResponseType = Item.ExpectedResponseFormat;
+		if (ResponseType == EExpectedResponseType::StreamText)
+		{
+			ResponseType = EExpectedResponseType::Text;
+		}
+		else if (ResponseType == EExpectedResponseType::StreamData || ResponseType == EExpectedResponseType::StreamAudio)
+		{
+			ResponseType = EExpectedResponseType::Data;
+		}
+
+		FYnnkHttpRequestCallbacks Callbacks;
+		Callbacks.OnComplete.BindUObject(this, &UHTTPSubsystem::OnBatchItemCompleted, Batch->BatchId, ItemIndex);
+
+		// failed request calls OnBatchItemCompleted before returning
+		const FYnnkHttpRequestHandle Handle = SendRequest(Batch->Keyword, Item.URL, Item.Verb, Item.HeaderParams, Item.BodyString, ResponseType, Batch->Options, MoveTemp(Callbacks));
+		if (Batch->Handles.IsValidIndex(ItemIndex))
+		{
+			Batch->Handles[ItemIndex] = Handle;
+		}
+	}
+	Batch->bSending = false;
+}
+
+void UHTTPSubsystem::OnBatchItemCompleted(const FYnnkHttpResponse& Response, int32 BatchId, int32 ItemIndex)
+{
+	if (!IsInGameThread())
+	{
+		AsyncTask(ENamedThreads::GameThread, [WeakThis = TWeakObjectPtr<UHTTPSubsystem>(this), Response, BatchId, ItemIndex]()
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->OnBatchItemCompleted(Response, BatchId, ItemIndex);
+			}
+		});
+		return;
+	}
+
+	// keep batch alive while delegates are called
+	const TSharedPtr<FYnnkHttpBatch> Batch = Batches.FindRef(BatchId);
+	if (!Batch.IsValid() || !Batch->Results.IsValidIndex(ItemIndex))
+	{
+		return;
+	}
+
+	Batch->NumActive--;
+	Batch->Results[ItemIndex] = Response;
+
+	if (Batch->bSending)
+	{
+		// request failed inside SendBatchItems: deliver in the next tick, so a dead URL doesn't recurse per item
+		// and SendHttpBatch returns before the batch is completed
+		if (!Batch->bDeliveryScheduled)
+		{
+			Batch->bDeliveryScheduled = true;
+			FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this, BatchId](float DeltaTime)
+			{
+				const TSharedPtr<FYnnkHttpBatch> PendingBatch = Batches.FindRef(BatchId);
+				if (PendingBatch.IsValid())
+				{
+					PendingBatch->bDeliveryScheduled = false;
+					if (DeliverBatchResponses(PendingBatch))
+					{
+						SendBatchItems(PendingBatch);
+					}
+				}
+				return false;
+			}));
+		}
+		return;
+	}
+
+	if (DeliverBatchResponses(Batch))
+	{
+		SendBatchItems(Batch);
+	}
+}
+
+bool UHTTPSubsystem::DeliverBatchResponses(const TSharedPtr<FYnnkHttpBatch>& Batch)
+{
+	const int32 BatchId = Batch->BatchId;
+	while (Batch->NextToDeliver < Batch->Items.Num() && Batch->Results[Batch->NextToDeliver].IsSet())
+	{
+		const int32 Index = Batch->NextToDeliver++;
+		const FYnnkHttpResponse ItemResponse = MoveTemp(Batch->Results[Index].GetValue());
+		Batch->Results[Index].Reset();
+		if (ItemResponse.IsOk())
+		{
+			Batch->NumSucceeded++;
+		}
+
+		if (Batch->OnItemResponse)
+		{
+			Batch->OnItemResponse(Index, ItemResponse);
+		}
+		else
+		{
+			OnBatchItemResponse.Broadcast(Batch->Keyword, BatchId, Index, ItemResponse.Code, ItemResponse.Text, ItemResponse.Data);
+		}
+
+		// cancelled from delegate
+		if (!Batches.Contains(BatchId))
+		{
+			return false;
+		}
+	}
+
+	if (Batch->bClosed && Batch->NextToDeliver == Batch->Items.Num())
+	{
+		Batches.Remove(BatchId);
+		if (Batch->OnCompleted)
+		{
+			Batch->OnCompleted(Batch->NumSucceeded);
+		}
+		else
+		{
+			OnBatchCompleted.Broadcast(Batch->Keyword, BatchId, Batch->NumSucceeded);
+		}
+		return false;
+	}
+	return true;
+}
+
+bool UHTTPSubsystem::OpenWebSocket(FName Keyword, FString URL, const TArray<FYnnkUrlParameter>& HeaderParams, const FYnnkWebSocketOptions& Options)
+{
+	if (const TSharedPtr<FYnnkWebSocketChannel>* Existing = WebSockets.Find(Keyword))
+	{
+		const TSharedPtr<FYnnkWebSocketChannel> OldChannel = *Existing;
+		RemoveWebSocket(OldChannel);
+		OldChannel->Socket->Close();
+	}
+
+	TMap<FString, FString> UpgradeHeaders;
+	for (const FYnnkUrlParameter& Param : HeaderParams)
+	{
+		UpgradeHeaders.Add(Param.Name, Param.Value);
+	}
+	const TSharedPtr<IWebSocket> Socket = FWebSocketsModule::Get().CreateWebSocket(URL, Options.Protocol, UpgradeHeaders);
+	if (!Socket.IsValid())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("OpenWebSocket: unable to create WebSocket for %s"), *URL);
+		return false;
+	}
+
+	const TSharedPtr<FYnnkWebSocketChannel> Channel = MakeShared<FYnnkWebSocketChannel>();
+	Channel->Keyword = Keyword;
+	Channel->Options = Options;
+	Channel->Socket = Socket;
+	WebSockets.Add(Keyword, Channel);
+
+	// events of WebSocket are called in game thread
+	TWeakObjectPtr<UHTTPSubsystem> WeakThis(this);
+	TWeakPtr<FYnnkWebSocketChannel> WeakChannel(Channel);
+	Socket->OnConnected().AddLambda([WeakThis, WeakChannel]()
+	{
+		const TSharedPtr<FYnnkWebSocketChannel> Channel = WeakChannel.Pin();
+		if (WeakThis.IsValid() && Channel.IsValid() && !Channel->bRemoved)
+		{
+			Channel->bConnected = true;
+			Channel->LastSendTime = FPlatformTime::Seconds();
+			WeakThis->FlushWebSocket(*Channel);
+			WeakThis->OnWebSocketConnected.Broadcast(Channel->Keyword);
+		}
+	});
+	Socket->OnConnectionError().AddLambda([WeakThis, WeakChannel](const FString& Error)
+	{
+		const TSharedPtr<FYnnkWebSocketChannel> Channel = WeakChannel.Pin();
+		if (WeakThis.IsValid() && Channel.IsValid() && !Channel->bRemoved)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("WebSocket %s: %s"), *Channel->Keyword.ToString(), *Error);
+			WeakThis->RemoveWebSocket(Channel);
+			WeakThis->OnWebSocketError.Broadcast(Channel->Keyword, Error);
+		}
+	});
+	Socket->OnClosed().AddLambda([WeakThis, WeakChannel](int32 StatusCode, const FString& Reason, bool bWasClean)
+	{
+		const TSharedPtr<FYnnkWebSocketChannel> Channel = WeakChannel.Pin();
+		if (WeakThis.IsValid() && Channel.IsValid() && !Channel->bRemoved)
+		{
+			WeakThis->RemoveWebSocket(Channel);
+			WeakThis->OnWebSocketClosed.Broadcast(Channel->Keyword, StatusCode, Reason);
+		}
+	});
+	Socket->OnMessage().AddLambda([WeakThis, WeakChannel](const FString& Message)
+	{
+		const TSharedPtr<FYnnkWebSocketChannel> Channel = WeakChannel.Pin();
+		if (WeakThis.IsValid() && Channel.IsValid() && !Channel->bRemoved)
+		{
+			// listeners get the same buffer as stream chunks
+			FString& Text = WeakThis->DispatchString;
+			Text = Message;
+			WeakThis->BroadcastTextChunk(Channel->Keyword, nullptr, Text);
+		}
+	});
+	Socket->OnBinaryMessage().AddLambda([WeakThis, WeakChannel](const void* Data, SIZE_T Size, bool bIsLastFragment)
+	{
+		const TSharedPtr<FYnnkWebSocketChannel> Channel = WeakChannel.Pin();
+		if (!WeakThis.IsValid() || !Channel.IsValid() || Channel->bRemoved)
+		{
+			return;
+		}
+		UHTTPSubsystem* This = WeakThis.Get();
+		if (Channel->Options.bDeliverBinaryFragments)
+		{
+			This->BroadcastStreamChunk(Channel->Keyword, nullptr, nullptr, TArrayView<const uint8>((const uint8*)Data, (int32)Size), This->DispatchString, This->DispatchData);
+			return;
+		}
+
+		Channel->IncomingData.Append((const uint8*)Data, (int32)Size);
+		if (bIsLastFragment)
+		{
+			This->BroadcastStreamChunk(Channel->Keyword, nullptr, nullptr, Channel->IncomingData, This->DispatchString, This->DispatchData);
+			Channel->IncomingData.Reset();
+		}
+	});
+
+	if (!WebSocketTickerHandle.IsValid())
+	{
+		WebSocketTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UHTTPSubsystem::TickWebSockets));
+	}
+
+	Socket->Connect();
+	return true;
+}
+
+bool UHTTPSubsystem::SendWebSocketText(FName Keyword, const FString& Message)
+{
+	const FTCHARToUTF8 Utf8(*Message);
+	return SendWebSocketMessage(Keyword, TArrayView<const uint8>((const uint8*)Utf8.Get(), Utf8.Length()), false);
+}
+
+bool UHTTPSubsystem::SendWebSocketData(FName Keyword, const TArray<uint8>& Data)
+{
+	return SendWebSocketMessage(Keyword, Data, true);
+}
+
+bool UHTTPSubsystem::SendWebSocketMessage(FName Keyword, TArrayView<const uint8> Data, bool bBinary)
+{
+	const TSharedPtr<FYnnkWebSocketChannel>* Found = WebSockets.Find(Keyword);
+	if (!Found)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SendWebSocketMessage: WebSocket %s isn't open"), *Keyword.ToString());
+		return false;
+	}
+
+	FYnnkWebSocketChannel& Channel = **Found;
+	if (Channel.QueuedBytes > 0 && Channel.QueuedBytes + Data.Num() > Channel.Options.MaxQueuedBytes)
+	{
+		UE_LOG(LogTemp, Verbose, TEXT("SendWebSocketMessage: queue of WebSocket %s is full (%lld bytes)"), *Keyword.ToString(), Channel.QueuedBytes);
+		return false;
+	}
+
+	FYnnkWebSocketChannel::FOutgoingMessage& Message = Channel.Outgoing.AddDefaulted_GetRef();
+	Message.Data = Data;
+	Message.bBinary = bBinary;
+	Channel.QueuedBytes += Data.Num();
+
+	FlushWebSocket(Channel);
+	return true;
+}
+
+void UHTTPSubsystem::FlushWebSocket(FYnnkWebSocketChannel& Channel)
+{
+	if (!Channel.bConnected || Channel.Outgoing.Num() == 0)
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	const double BytesPerSecond = Channel.Options.MaxSendRate * 1024.0;
+	if (BytesPerSecond > 0.0)
+	{
+		// allowance is limited to one second of data, so idle channel doesn't send a burst
+		Channel.SendAllowance = FMath::Min(Channel.SendAllowance + (Now - Channel.LastSendTime) * BytesPerSecond, BytesPerSecond);
+	}
+	Channel.LastSendTime = Now;
+
+	int32 NumSent = 0;
+	for (const FYnnkWebSocketChannel::FOutgoingMessage& Message : Channel.Outgoing)
+	{
+		if (BytesPerSecond > 0.0 && Channel.SendAllowance <= 0.0)
+		{
+			break;
+		}
+		Channel.Socket->Send(Message.Data.GetData(), Message.Data.Num(), Message.bBinary);
+		Channel.QueuedBytes -= Message.Data.Num();
+		Channel.SendAllowance -= Message.Data.Num();
+		NumSent++;
+	}
+	Channel.Outgoing.RemoveAt(0, NumSent, YNNK_NO_SHRINK);
+}
+
+bool UHTTPSubsystem::TickWebSockets(float DeltaTime)
+{
+	for (const TSharedPtr<FYnnkWebSocketChannel>& Channel : ClosedWebSockets)
+	{
+		Channel->Socket->OnConnected().Clear();
+		Channel->Socket->OnConnectionError().Clear();
+		Channel->Socket->OnClosed().Clear();
+		Channel->Socket->OnMessage().Clear();
+		Channel->Socket->OnBinaryMessage().Clear();
+	}
+	ClosedWebSockets.Empty();
+
+	for (const auto& Channel : WebSockets)
+	{
+		FlushWebSocket(*Channel.Value);
+	}
+	return true;
+}
+
+void UHTTPSubsystem::RemoveWebSocket(const TSharedPtr<FYnnkWebSocketChannel>& Channel)
+{
+	const TSharedPtr<FYnnkWebSocketChannel>* Found = WebSockets.Find(Channel->Keyword);
+	if (Found && *Found == Channel)
+	{
+		WebSockets.Remove(Channel->Keyword);
+	}
+	if (!Channel->bRemoved)
+	{
+		Channel->bRemoved = true;
+		Channel->bConnected = false;
+		Channel->Outgoing.Empty();
+		Channel->QueuedBytes = 0;
+		ClosedWebSockets.Add(Channel);
+	}
+}
+
+void UHTTPSubsystem::CloseWebSocket(FName Keyword, int32 StatusCode, const FString& Reason)
+{
+	const TSharedPtr<FYnnkWebSocketChannel>* Found = WebSockets.Find(Keyword);
+	if (!Found)
+	{
+		return;
+	}
+	const TSharedPtr<FYnnkWebSocketChannel> Channel = *Found;
+	RemoveWebSocket(Channel);
+	Channel->Socket->Close(StatusCode, Reason);
+	OnWebSocketClosed.Broadcast(Keyword, StatusCode, Reason);
+}
+
+bool UHTTPSubsystem::IsWebSocketConnected(FName Keyword) const
+{
+	const TSharedPtr<FYnnkWebSocketChannel>* Found = WebSockets.Find(Keyword);
+	return Found && (*Found)->bConnected;
+}
+
+int32 UHTTPSubsystem::GetWebSocketQueuedBytes(FName Keyword) const
+{
+	const TSharedPtr<FYnnkWebSocketChannel>* Found = WebSockets.Find(Keyword);
+	return Found ? (int32)(*Found)->QueuedBytes : 0;
+}
+
+bool UHTTPSubsystem::SendHttpRequestWithOptions(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FString& BodyString, const FYnnkHttpRequestOptions& Options, EExpectedResponseType ExpectedResponseFormat)
+{
+	return SendHttpRequestInternal(Keyword, URL, Verb, HeaderParams, BodyString, {}, ExpectedResponseFormat, Options);
+}
+
+bool UHTTPSubsystem::SendHttpRequestDataWithOptions(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const TArray<uint8>& BodyData, const FYnnkHttpRequestOptions& Options, EExpectedResponseType ExpectedResponseFormat)
+{
+	return SendHttpRequestInternal(Keyword, URL, Verb, HeaderParams, TEXT("!!NULL"), BodyData, ExpectedResponseFormat, Options);
+}
+
+void UHTTPSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	StreamBackpressure = MakeShared<FYnnkStreamBackpressure, ESPMode::ThreadSafe>();
+	StreamDispatchTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UHTTPSubsystem::TickStreamDispatch));
+
+	// first request to local servers shouldn't wait for connection
+	for (const FString& URL : WarmupEndpoints)
+	{
+		WarmUpEndpoint(URL);
+	}
+	KeepAliveTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UHTTPSubsystem::TickKeepAlive), 1.f);
+}
+
+void UHTTPSubsystem::Deinitialize()
+{
+	Super::Deinitialize();
+
+	FTSTicker::GetCoreTicker().RemoveTicker(StreamDispatchTickerHandle);
+	StreamDispatchTickerHandle.Reset();
+	FTSTicker::GetCoreTicker().RemoveTicker(ReplayTickerHandle);
+	ReplayTickerHandle.Reset();
+	FTSTicker::GetCoreTicker().RemoveTicker(KeepAliveTickerHandle);
+	KeepAliveTickerHandle.Reset();
+	Subscriptions.Reset();
+	Batches.Empty();
+
+	FTSTicker::GetCoreTicker().RemoveTicker(WebSocketTickerHandle);
+	WebSocketTickerHandle.Reset();
+	TArray<TSharedPtr<FYnnkWebSocketChannel>> Channels;
+	WebSockets.GenerateValueArray(Channels);
+	for (const TSharedPtr<FYnnkWebSocketChannel>& Channel : Channels)
+	{
+		RemoveWebSocket(Channel);
+		Channel->Socket->Close();
+	}
+	TickWebSockets(0.f);
+
+	// in-flight requests are cancelled, callbacks are called after the map is cleared
+	TArray<TPair<TSharedPtr<FYnnkHttpRequestCallbacks, ESPMode::ThreadSafe>, FYnnkHttpResponse>> CancelledCallbacks;
+	{
+		FScopeLock Lock(&RequestsLock);
+		for (auto& Req : HttpRequests)
+		{
+			FTSTicker::GetCoreTicker().RemoveTicker(Req.Value.RetryTickerHandle);
+			FTSTicker::GetCoreTicker().RemoveTicker(Req.Value.HedgeTickerHandle);
+			AbandonHttpRequest(Req.Value.HedgeRequest);
+			if (Req.Value.HttpRequest.IsValid())
+			{
+				AbandonHttpRequest(Req.Value.HttpRequest);
+				DEC_DWORD_STAT(STAT_YnnkHttpActiveRequests);
+
+				// futures must not wait forever
+				if (Req.Value.Callbacks.IsValid() && Req.Value.Callbacks->OnComplete.IsBound())
+				{
+					FYnnkHttpResponse Response;
+					Response.RequestName = Req.Value.Name;
+					Response.Handle = FYnnkHttpRequestHandle(Req.Key, Req.Value.Serial);
+					Response.bCancelled = true;
+					CancelledCallbacks.Emplace(Req.Value.Callbacks, MoveTemp(Response));
+				}
+			}
+		}
+		HttpRequests.Empty();
+	}
+	for (auto& Cancelled : CancelledCallbacks)
+	{
+		Cancelled.Key->OnComplete.Execute(Cancelled.Value);
+	}
+}
+
+void UHTTPSubsystem::OnHTTPRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr RequestResponse, bool bWasSuccessful, int32 ReqId)
+{
+	YNNK_HTTP_TRACE_SCOPE("UHTTPSubsystem::OnHTTPRequestComplete");
+
+	FYnnkNamedHttpRequest* NamedRequest = HttpRequests.Find(ReqId);
+	if (!NamedRequest)
+	{
+		return;
+	}
+	YNNK_HTTP_TRACE_EVENT(Completed, ReqId, NamedRequest->Name, RequestResponse.IsValid() ? RequestResponse->GetContentLength() : 0, RequestResponse.IsValid() ? RequestResponse->GetResponseCode() : 0);
+	if (RequestResponse.IsValid() && Request.IsValid())
+	{
+		MarkHostActivity(Request->GetURL());
+	}
+
+	const bool bIsHedge = NamedRequest->HedgeRequest.IsValid() && Request == NamedRequest->HedgeRequest;
+	if (!bIsHedge && Request != NamedRequest->HttpRequest)
+	{
+		// outdated attempt
+		return;
+	}
+	if (NamedRequest->StreamOwner && NamedRequest->StreamOwner != Request.Get())
+	{
+		// the other copy is already streaming the response
+		FScopeLock Lock(&RequestsLock);
+		AbandonHttpRequest(bIsHedge ? NamedRequest->HedgeRequest : NamedRequest->HttpRequest);
+		if (!NamedRequest->HttpRequest.IsValid())
+		{
+			Swap(NamedRequest->HttpRequest, NamedRequest->HedgeRequest);
+		}
+		return;
+	}
+
+	const int32 ResponseCode = RequestResponse.IsValid() ? RequestResponse->GetResponseCode() : 0;
+	const bool bFailed = !bWasSuccessful || !RequestResponse.IsValid() || NamedRequest->Options.RetryPolicy.RetryOnCodes.Contains(ResponseCode);
+
+	// data of a streamed response can't be taken back, so only silent failures are retried (downloads to file are resumed or restarted)
+	const bool bDataDelivered = NamedRequest->StreamOwner && !NamedRequest->IsFileResponse();
+	if (bFailed && !bDataDelivered && NamedRequest->Options.RetryPolicy.CanRetryCode(ResponseCode))
+	{
+		const bool bOtherCopyActive = bIsHedge || NamedRequest->HedgeRequest.IsValid();
+		if (bOtherCopyActive)
+		{
+			// wait for the other copy
+			FScopeLock Lock(&RequestsLock);
+			if (bIsHedge)
+			{
+				AbandonHttpRequest(NamedRequest->HedgeRequest);
+			}
+			else
+			{
+				NamedRequest->HttpRequest->OnProcessRequestComplete().Unbind();
+				NamedRequest->HttpRequest = NamedRequest->HedgeRequest;
+				NamedRequest->HedgeRequest = nullptr;
+			}
+			return;
+		}
+		if (ScheduleRetry(ReqId, RequestResponse))
+		{
+			return;
+		}
+	}
+
+	if (bIsHedge)
+	{
+		// hedged request won, cancel the original one
+		FScopeLock Lock(&RequestsLock);
+		AbandonHttpRequest(NamedRequest->HttpRequest);
+		Swap(NamedRequest->HttpRequest, NamedRequest->HedgeRequest);
+	}
+	else
+	{
+		FScopeLock Lock(&RequestsLock);
+		AbandonHttpRequest(NamedRequest->HedgeRequest);
+	}
+
+	FYnnkHttpResponseView Response;
+	if (RequestResponse.IsValid())
+	{
+		Response.bValid = true;
+		Response.Code = ResponseCode;
+		Response.ContentType = RequestResponse->GetContentType();
+		// parsed only if listener reads them
+		Response.Headers = FYnnkHttpHeaders(RequestResponse);
+		Response.Content = &RequestResponse->GetContent();
+		Response.HttpResponse = RequestResponse;
+	}
+
+	if (NamedRequest->Recording.IsValid())
+	{
+		SaveRecording(ReqId, Response, bWasSuccessful);
+	}
+
+	CompleteRequest(ReqId, Response, bWasSuccessful);
+}
+
+void UHTTPSubsystem::CompleteRequest(int32 ReqId, const FYnnkHttpResponseView& Response, bool bWasSuccessful)
+{
+	const int32 ResponseCode = Response.Code;
+	const FYnnkHttpRequestHandle Handle(ReqId, HttpRequests[ReqId].Serial);
+	RecordRequestMetrics(ReqId, Response.GetContentSize(), ResponseCode, bWasSuccessful);
+
+	// stream chunks can still wait for game thread
+	DispatchStreamChunks(ReqId);
+	FYnnkNamedHttpRequest* NamedRequest = FindRequest(Handle);
+	if (!NamedRequest)
+	{
+		// cancelled by stream listener
+		return;
+	}
+
+	// the rest of audio shorter than frame
+	if (NamedRequest->AudioReframer.IsValid() && NamedRequest->ResponseFormat == EExpectedResponseType::StreamAudio)
+	{
+		const FName RequestName = NamedRequest->Name;
+		const TSharedPtr<FYnnkPcmStreamReframer> Reframer = NamedRequest->AudioReframer;
+		const TSharedPtr<FYnnkHttpRequestCallbacks, ESPMode::ThreadSafe> FrameCallbacks = NamedRequest->Callbacks;
+		Reframer->Flush([this, &RequestName, &Reframer, &FrameCallbacks](TArrayView<const uint8> Frame)
+		{
+			BroadcastAudioFrame(RequestName, FrameCallbacks.Get(), Reframer->GetFormat(), Frame, DispatchData);
+		});
+		NamedRequest = FindRequest(Handle);
+		if (!NamedRequest)
+		{
+			return;
+		}
+	}
+
+	const TSharedPtr<FYnnkHttpRequestCallbacks, ESPMode::ThreadSafe> Callbacks = NamedRequest->Callbacks;
+	const bool bGlobalDelegates = NamedRequest->UseGlobalDelegates();
+	FYnnkHttpResponse CallbackResponse;
+	if (Callbacks.IsValid())
+	{
+		CallbackResponse.RequestName = NamedRequest->Name;
+		CallbackResponse.Handle = Handle;
+		CallbackResponse.Code = ResponseCode;
+		CallbackResponse.bWasSuccessful = bWasSuccessful && Response.bValid;
+		CallbackResponse.Headers = Response.Headers;
+	}
+
+	// listeners can cancel this request and send a new one to the same slot
+	auto FinishRequest = [this, ReqId, &Handle, &Callbacks, &CallbackResponse]()
+	{
+		if (FindRequest(Handle))
+		{
+			ReleaseRequest(ReqId);
+		}
+		ExecuteCompleteCallback(Callbacks, MoveTemp(CallbackResponse));
+	};
+
+	if (NamedRequest->IsFileResponse())
+	{
+		const FString FileName = NamedRequest->ResponseFileName;
+		if (OnFileRequestCompleted(ReqId, Response, bWasSuccessful))
+		{
+			CallbackResponse.FileName = FileName;
+		}
+		FinishRequest();
+		return;
+	}
+
+	if (!Response.bValid)
+	{
+		UE_LOG(LogTemp, Log, TEXT("HTTP-request %s failed without response"), *NamedRequest->Name.ToString());
+		if (bGlobalDelegates)
+		{
+			OnStringRequestCompleted(ReqId, FString(), FYnnkHttpHeaders(), 0, false);
+		}
+		FinishRequest();
+		return;
+	}
+
+	const FString& Type = Response.ContentType;
+	const FYnnkHttpHeaders& Headers = Response.Headers;
+	if (bGlobalDelegates && OnResponseHeaders.IsBound())
+	{
+		OnResponseHeaders.Broadcast(NamedRequest->Name, ResponseCode, Headers);
+		NamedRequest = FindRequest(Handle);
+		if (!NamedRequest)
+		{
+			// cancelled by listener
+			return;
+		}
+	}
+
+	// decode compressed body unless http module already did it
+	static const TArray<uint8> EmptyContent;
+	const TArray<uint8>* Content = Response.Content ? Response.Content : &EmptyContent;
+	TArray<uint8> DecodedContent;
+	if (NamedRequest->Options.bDecompressResponse && YnnkHttpCompression::IsCompressedResponse(Headers.GetValue(TEXT("Content-Encoding")), Content->GetData(), Content->Num()))
+	{
+		FYnnkStreamInflater ContentInflater;
+		if (ContentInflater.Inflate(Content->GetData(), Content->Num(), DecodedContent))
+		{
+			Content = &DecodedContent;
+		}
+	}
+	auto GetContentString = [&]() -> FString
+	{
+		if (Content == Response.Content && Response.HttpResponse.IsValid())
+		{
+			return Response.HttpResponse->GetContentAsString();
+		}
+		FString Result;
+		FFileHelper::BufferToString(Result, Content->GetData(), Content->Num());
+		return Result;
+	};
+
+	if (Type.Contains(TEXT("audio/")) || NamedRequest->FormatAudio())
+	{
+		UE_LOG(LogTemp, Log, TEXT("HTTP-request returned data of type: %s (binary). Length = %d"), *Type, Content->Num());
+		if (bGlobalDelegates)
+		{
+			OnDataRequestCompleted(ReqId, *Content, Headers, ResponseCode, bWasSuccessful);
+		}
+		if (Callbacks.IsValid())
+		{
+			CallbackResponse.Data = *Content;
+		}
+	}
+	else
+	{
+		if (Type.Contains(TEXT("application/json")) || Type.StartsWith("text/") || NamedRequest->FormatText())
+		{
+			UE_LOG(LogTemp, Log, TEXT("HTTP-request returned data of type: %s (text). Length = %d"), *Type, Content->Num());
+		}
+		else
+		{
+			UE_LOG(LogTemp, Log, TEXT("HTTP-request returned data of type: %s (unknown). Length = %d"), *Type, Content->Num());
+		}
+
+		FString& Text = bGlobalDelegates ? StringBuffer : CallbackResponse.Text;
+		if (NamedRequest->TextAccumulator.IsValid())
+		{
+			// already decoded while streaming
+			Text = NamedRequest->TextAccumulator->TakeText();
+		}
+		else
+		{
+			Text = GetContentString();
+		}
+		UE_LOG(LogTemp, VeryVerbose, TEXT("Response body: [%s]"), *Text);
+
+		if (bGlobalDelegates)
+		{
+			OnStringRequestCompleted(ReqId, StringBuffer, Headers, ResponseCode, bWasSuccessful);
+			if (Callbacks.IsValid())
+			{
+				CallbackResponse.Text = StringBuffer;
+			}
+		}
+	}
+
+	FinishRequest();
+}
+
+bool UHTTPSubsystem::StreamChunkReceivedWrapper(void* Ptr, int64 Length, int32 ReqId, const IHttpRequest* Source)
+{
+	YNNK_HTTP_TRACE_SCOPE("UHTTPSubsystem::StreamChunkReceived");
+
+	FScopeLock Lock(&RequestsLock);
+
+	if (HttpRequests.Contains(ReqId) && Length > 0)
+	{
+		auto& Req = HttpRequests[ReqId];
+
+		// late chunk of cancelled request, slot can already be used by another one
+		if (Source != Req.HttpRequest.Get() && Source != Req.HedgeRequest.Get())
+		{
+			return false;
+		}
+
+		// with hedging two requests can stream the same response, the first one to send data wins
+		if (Req.StreamOwner && Req.StreamOwner != Source)
+		{
+			return true;
+		}
+		if (!Req.StreamOwner)
+		{
+			Req.StreamOwner = Source;
+			Req.bFirstByteReceived = true;
+			if (Req.HedgeRequest.IsValid())
+			{
+				AsyncTask(ENamedThreads::GameThread, [this, ReqId, Source]()
+				{
+					FScopeLock Lock(&RequestsLock);
+					if (FYnnkNamedHttpRequest* NamedRequest = HttpRequests.Find(ReqId))
+					{
+						if (NamedRequest->HedgeRequest.Get() == Source)
+						{
+							AbandonHttpRequest(NamedRequest->HttpRequest);
+							Swap(NamedRequest->HttpRequest, NamedRequest->HedgeRequest);
+						}
+						else
+						{
+							AbandonHttpRequest(NamedRequest->HedgeRequest);
+						}
+					}
+				});
+			}
+		}
+
+		YNNK_HTTP_TRACE_EVENT(Chunk, ReqId, Req.Name, Length, 0);
+		if (bCollectMetrics)
+		{
+			Req.Timing.AddChunk(FPlatformTime::Seconds(), Length);
+		}
+		if (Req.Recording.IsValid())
+		{
+			Req.Recording->AddChunk(FPlatformTime::Seconds() - Req.Timing.SendTime, (const uint8*)Ptr, Length);
+		}
+
+		if (!Req.bStreamEncodingChecked)
+		{
+			Req.bStreamEncodingChecked = true;
+			if (Req.Options.bDecompressResponse && YnnkHttpCompression::IsCompressedResponse(GetStreamResponseHeader(Req, Source, TEXT("Content-Encoding")), (const uint8*)Ptr, Length))
+			{
+				Req.Inflater = MakeShared<FYnnkStreamInflater>();
+			}
+		}
+
+		if (Req.IsFileResponse())
+		{
+			Req.TempBinaryData.Reset();
+			if (Req.Inflater.IsValid() && !Req.Inflater->Inflate((const uint8*)Ptr, Length, Req.TempBinaryData))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("HTTP-request %s: unable to decode compressed stream, writing raw data"), *Req.Name.ToString());
+				Req.Inflater.Reset();
+			}
+			if (Req.Inflater.IsValid())
+			{
+				WriteResponseFileChunk(Req, Source, Req.TempBinaryData.GetData(), Req.TempBinaryData.Num());
+			}
+			else
+			{
+				WriteResponseFileChunk(Req, Source, (const uint8*)Ptr, Length);
+			}
+			return true;
+		}
+
+		const uint8* ChunkData = (const uint8*)Ptr;
+		int32 ChunkSize = (int32)Length;
+		if (Req.Inflater.IsValid())
+		{
+			Req.TempBinaryData.Reset();
+			if (!Req.Inflater->Inflate(ChunkData, Length, Req.TempBinaryData))
+			{
+				// don't lose the rest of response
+				UE_LOG(LogTemp, Warning, TEXT("HTTP-request %s: unable to decode compressed stream, passing raw data"), *Req.Name.ToString());
+				Req.Inflater.Reset();
+				Req.TempBinaryData.Reset();
+			}
+		}
+		if (Req.Inflater.IsValid())
+		{
+			if (Req.TempBinaryData.Num() == 0)
+			{
+				// header or incomplete block
+				return true;
+			}
+			ChunkData = Req.TempBinaryData.GetData();
+			ChunkSize = Req.TempBinaryData.Num();
+		}
+
+		if (Req.Timing.FirstTokenTime == 0.0 && Req.FormatText())
+		{
+			Req.Timing.FirstTokenTime = FPlatformTime::Seconds();
+		}
+		if (Req.TextAccumulator.IsValid())
+		{
+			Req.TextAccumulator->Append(ChunkData, ChunkSize);
+		}
+
+		if (Req.ResponseFormat == EExpectedResponseType::StreamAudio)
+		{
+			// reframer is only used by http thread until request is completed
+			const FName RequestName = Req.Name;
+			const TSharedPtr<FYnnkPcmStreamReframer> Reframer = Req.AudioReframer;
+			if (!Reframer.IsValid())
+			{
+				return true;
+			}
+
+			if (bResponseInGameThread && !IsInGameThread())
+			{
+				// frames are read from buffer by game thread, so don't block it while waiting for free space
+				const TSharedPtr<FYnnkStreamRingBuffer, ESPMode::ThreadSafe> StreamBuffer = Req.StreamBuffer;
+				const EYnnkStreamOverflowPolicy OverflowPolicy = Req.Options.StreamOverflowPolicy;
+				const TSharedPtr<FYnnkStreamScratch, ESPMode::ThreadSafe> Scratch = GetStreamScratch(Req);
+				if (ChunkData == Req.TempBinaryData.GetData())
+				{
+					Swap(Scratch->AudioChunk, Req.TempBinaryData);
+					ChunkData = Scratch->AudioChunk.GetData();
+				}
+				Lock.Unlock();
+				Reframer->Process(ChunkData, ChunkSize, [&](TArrayView<const uint8> Frame)
+				{
+					QueueStreamChunk(*StreamBuffer, RequestName, Frame.GetData(), Frame.Num(), OverflowPolicy, true);
+				});
+			}
+			else if (IsInGameThread())
+			{
+				// listeners in game thread can add requests and move Req
+				const TSharedPtr<FYnnkHttpRequestCallbacks, ESPMode::ThreadSafe> Callbacks = Req.Callbacks;
+				if (ChunkData == Req.TempBinaryData.GetData())
+				{
+					Swap(DispatchChunk, Req.TempBinaryData);
+					ChunkData = DispatchChunk.GetData();
+				}
+				Lock.Unlock();
+				Reframer->Process(ChunkData, ChunkSize, [&](TArrayView<const uint8> Frame)
+				{
+					BroadcastAudioFrame(RequestName, Callbacks.Get(), Reframer->GetFormat(), Frame, DispatchData);
+				});
+			}
+			else
+			{
+				// listeners are called without lock: they can cancel this request or send new ones
+				const TSharedPtr<FYnnkHttpRequestCallbacks, ESPMode::ThreadSafe> Callbacks = Req.Callbacks;
+				const TSharedPtr<FYnnkStreamScratch, ESPMode::ThreadSafe> Scratch = GetStreamScratch(Req);
+				if (ChunkData == Req.TempBinaryData.GetData())
+				{
+					Swap(Scratch->AudioChunk, Req.TempBinaryData);
+					ChunkData = Scratch->AudioChunk.GetData();
+				}
+				Lock.Unlock();
+				Reframer->Process(ChunkData, ChunkSize, [&](TArrayView<const uint8> Frame)
+				{
+					BroadcastAudioFrame(RequestName, Callbacks.Get(), Reframer->GetFormat(), Frame, Scratch->Data);
+				});
+			}
+		}
+		else if (bResponseInGameThread && !IsInGameThread())
+		{
+			// game thread reads the chunk from buffer in the next tick
+			const FName RequestName = Req.Name;
+			const TSharedPtr<FYnnkStreamRingBuffer, ESPMode::ThreadSafe> StreamBuffer = Req.StreamBuffer;
+			const EYnnkStreamOverflowPolicy OverflowPolicy = Req.Options.StreamOverflowPolicy;
+			// request can be cancelled by game thread while decoded chunk is copied
+			const TSharedPtr<FYnnkStreamScratch, ESPMode::ThreadSafe> Scratch = GetStreamScratch(Req);
+			if (ChunkData == Req.TempBinaryData.GetData())
+			{
+				Swap(Scratch->Data, Req.TempBinaryData);
+				ChunkData = Scratch->Data.GetData();
+			}
+			Lock.Unlock();
+			if (StreamBuffer.IsValid())
+			{
+				QueueStreamChunk(*StreamBuffer, RequestName, ChunkData, ChunkSize, OverflowPolicy, false);
+			}
+		}
+		else if (IsInGameThread())
+		{
+			// listeners in game thread can add requests and move Req, so decoded chunk is kept in subsystem buffer
+			if (ChunkData == Req.TempBinaryData.GetData())
+			{
+				Swap(DispatchData, Req.TempBinaryData);
+				ChunkData = DispatchData.GetData();
+			}
+			const FName RequestName = Req.Name;
+			const TSharedPtr<FYnnkHttpRequestCallbacks, ESPMode::ThreadSafe> Callbacks = Req.Callbacks;
+			const TSharedPtr<FYnnkUtf8StreamDecoder> TextDecoder = Req.TextDecoder;
+			Lock.Unlock();
+			BroadcastStreamChunk(RequestName, Callbacks.Get(), TextDecoder.Get(), TArrayView<const uint8>(ChunkData, ChunkSize), DispatchString, DispatchData);
+		}
+		else
+		{
+			// listeners are called without lock: they can cancel this request or send new ones
+			const FName RequestName = Req.Name;
+			const TSharedPtr<FYnnkHttpRequestCallbacks, ESPMode::ThreadSafe> Callbacks = Req.Callbacks;
+			const TSharedPtr<FYnnkUtf8StreamDecoder> TextDecoder = Req.TextDecoder;
+			const TSharedPtr<FYnnkStreamScratch, ESPMode::ThreadSafe> Scratch = GetStreamScratch(Req);
+			if (ChunkData == Req.TempBinaryData.GetData())
+			{
+				Swap(Scratch->Data, Req.TempBinaryData);
+				ChunkData = Scratch->Data.GetData();
+			}
+			Lock.Unlock();
+			BroadcastStreamChunk(RequestName, Callbacks.Get(), TextDecoder.Get(), TArrayView<const uint8>(ChunkData, ChunkSize), Scratch->Text, Scratch->Data);
+		}
+	}
+
+	return (Ptr != NULL && Length > 0);
+}
+
+void UHTTPSubsystem::StreamChunkReceivedWrapperV2(void* Ptr, int64& InOutLength, int32 ReqId, const IHttpRequest* Source)
+{
+	StreamChunkReceivedWrapper(Ptr, InOutLength, ReqId, Source);
+}
+
+void UHTTPSubsystem::QueueStreamChunk(FYnnkStreamRingBuffer& StreamBuffer, FName RequestName, const uint8* Data, int32 Size, EYnnkStreamOverflowPolicy Policy, bool bAudioFrame)
+{
+	if (bAudioFrame && Size > StreamBuffer.GetMaxChunkSize())
+	{
+		// a part of frame would be misaligned for listeners
+		StreamBackpressure->NumDroppedFrames++;
+		UE_LOG(LogTemp, Warning, TEXT("HTTP-request %s: audio frame (%d bytes) doesn't fit stream buffer, increase StreamBufferSize"), *RequestName.ToString(), Size);
+		return;
+	}
+
+	// large chunks are split to fit the buffer; audio frames are kept whole
+	const int32 MaxPartSize = bAudioFrame ? Size : StreamBuffer.GetMaxChunkSize() / 2;
+	while (Size > 0)
+	{
+		const int32 PartSize = FMath::Min(Size, MaxPartSize);
+
+		if (!StreamBuffer.Push(Data, PartSize))
+		{
+			if (bAudioFrame && Policy == EYnnkStreamOverflowPolicy::DropAudioFrames)
+			{
+				// late frames are worse than a gap in audio
+				StreamBackpressure->NumDroppedFrames++;
+				return;
+			}
+
+			// http thread is shared by all requests and can't wait here, and the connection can't be paused:
+			// chunk waits for game thread in parking space of the request (part always fits the empty buffer)
+			StreamBuffer.Park(Data, PartSize);
+		}
+
+		Data += PartSize;
+		Size -= PartSize;
+	}
+}
+
+void UHTTPSubsystem::DispatchStreamChunks(int32 ReqId)
+{
+	const FYnnkNamedHttpRequest* Req = HttpRequests.Find(ReqId);
+	if (!Req || !Req->StreamBuffer.IsValid())
+	{
+		return;
+	}
+
+	// listeners can send new requests, so don't keep reference to map element
+	const FName RequestName = Req->Name;
+	const TSharedPtr<FYnnkUtf8StreamDecoder> TextDecoder = Req->TextDecoder;
+	const TSharedPtr<FYnnkStreamRingBuffer, ESPMode::ThreadSafe> StreamBuffer = Req->StreamBuffer;
+	const TSharedPtr<FYnnkPcmStreamReframer> Reframer = Req->ResponseFormat == EExpectedResponseType::StreamAudio ? Req->AudioReframer : nullptr;
+	const TSharedPtr<FYnnkHttpRequestCallbacks, ESPMode::ThreadSafe> Callbacks = Req->Callbacks;
+	const bool bCoalesce = Req->Options.StreamOverflowPolicy == EYnnkStreamOverflowPolicy::Coalesce && !Reframer.IsValid();
+
+	YNNK_HTTP_TRACE_SCOPE("UHTTPSubsystem::DispatchStreamChunks");
+
+	// checked before parked chunks are moved: coalescing is only needed when game thread can't keep up
+	const bool bUnderPressure = bCoalesce && StreamBuffer->IsNearlyFull(StreamCoalesceThreshold);
+
+	// chunks parked while buffer was full of other requests' data
+	StreamBuffer->MoveParked();
+
+	if (bUnderPressure && StreamBuffer->Num() > 1)
+	{
+		// game thread is late: listeners get one update instead of a burst of stale chunks
+		DispatchData.Reset(StreamBuffer->GetUsedSize());
+		TArrayView<const uint8> Pending;
+		int32 NumPending = 0;
+		while (StreamBuffer->Peek(Pending))
+		{
+			DispatchData.Append(Pending.GetData(), Pending.Num());
+			StreamBuffer->Pop();
+			StreamBuffer->MoveParked();
+			NumPending++;
+		}
+		StreamBackpressure->NumCoalescedChunks += NumPending - 1;
+		YNNK_HTTP_TRACE_EVENT(Dispatched, ReqId, RequestName, DispatchData.Num(), 0);
+		BroadcastStreamChunk(RequestName, Callbacks.Get(), TextDecoder.Get(), DispatchData, DispatchString, DispatchData);
+		return;
+	}
+
+	TArrayView<const uint8> Chunk;
+	while (StreamBuffer->Peek(Chunk))
+	{
+		YNNK_HTTP_TRACE_EVENT(Dispatched, ReqId, RequestName, Chunk.Num(), 0);
+		if (Reframer.IsValid())
+		{
+			BroadcastAudioFrame(RequestName, Callbacks.Get(), Reframer->GetFormat(), Chunk, DispatchData);
+		}
+		else
+		{
+			BroadcastStreamChunk(RequestName, Callbacks.Get(), TextDecoder.Get(), Chunk, DispatchString, DispatchData);
+		}
+		StreamBuffer->Pop();
+		StreamBuffer->MoveParked();
+
+		// request can be cancelled by listener
+		const FYnnkNamedHttpRequest* Current = HttpRequests.Find(ReqId);
+		if (!Current || Current->StreamBuffer != StreamBuffer)
+		{
+			break;
+		}
+	}
+}
+
+bool UHTTPSubsystem::TickStreamDispatch(float DeltaTime)
+{
+	TArray<int32, TInlineAllocator<32>> PendingRequests;
+	for (const auto& Req : HttpRequests)
+	{
+		if (Req.Value.StreamBuffer.IsValid() && (!Req.Value.StreamBuffer->IsEmpty() || Req.Value.StreamBuffer->HasParked()))
+		{
+			PendingRequests.Add(Req.Key);
+		}
+	}
+	for (const int32 ReqId : PendingRequests)
+	{
+		DispatchStreamChunks(ReqId);
+	}
+	return true;
+}
+
+void UHTTPSubsystem::BroadcastTextChunk(FName RequestName, const FYnnkHttpRequestCallbacks* Callbacks, FString& Text)
+{
+	UJsonItemFunctionsLibrary::CleanJsonResponseInline(Text);
+
+	if (Callbacks)
+	{
+		Callbacks->OnTextChunk.ExecuteIfBound(FStringView(Text));
+	}
+	if (!Callbacks || !Callbacks->bSkipGlobalDelegates)
+	{
+		OnTextStreamChunk.Broadcast(RequestName, FStringView(Text));
+		OnTextStreamResponse.Broadcast(RequestName, Text);
+		Subscriptions.Broadcast(RequestName, &FYnnkHttpSubscriptions::FSubscribers::TextStream, Text);
+	}
+}
+
+void UHTTPSubsystem::BroadcastStreamChunk(FName RequestName, const FYnnkHttpRequestCallbacks* Callbacks, FYnnkUtf8StreamDecoder* TextDecoder, TArrayView<const uint8> Chunk, FString& StringScratch, TArray<uint8>& DataScratch)
+{
+	const bool bGlobalDelegates = !Callbacks || !Callbacks->bSkipGlobalDelegates;
+	if (TextDecoder)
+	{
+		if (!bGlobalDelegates && !Callbacks->OnTextChunk.IsBound())
+		{
+			// nobody listens, but split character must be kept for the next chunk
+			TextDecoder->Skip(Chunk.GetData(), Chunk.Num());
+			return;
+		}
+		TextDecoder->Decode(Chunk.GetData(), Chunk.Num(), StringScratch);
+		if (StringScratch.IsEmpty())
+		{
+			// chunk is a part of multibyte character
+			return;
+		}
+		BroadcastTextChunk(RequestName, Callbacks, StringScratch);
+	}
+	else
+	{
+		if (Callbacks)
+		{
+			Callbacks->OnDataChunk.ExecuteIfBound(Chunk);
+		}
+		if (!bGlobalDelegates)
+		{
+			return;
+		}
+		OnDataStreamChunk.Broadcast(RequestName, Chunk);
+		const bool bSubscribed = Subscriptions.HasSubscribers(RequestName, &FYnnkHttpSubscriptions::FSubscribers::DataStream);
+		if (OnDataStreamResponse.IsBound() || bSubscribed)
+		{
+			// blueprint event needs an array, its memory is reused
+			if (DataScratch.GetData() != Chunk.GetData())
+			{
+				DataScratch.Reset();
+				DataScratch.Append(Chunk.GetData(), Chunk.Num());
+			}
+			OnDataStreamResponse.Broadcast(RequestName, DataScratch);
+			if (bSubscribed)
+			{
+				Subscriptions.Broadcast(RequestName, &FYnnkHttpSubscriptions::FSubscribers::DataStream, DataScratch);
+			}
+		}
+	}
+}
+
+void UHTTPSubsystem::BroadcastAudioFrame(FName RequestName, const FYnnkHttpRequestCallbacks* Callbacks, const FYnnkPcmFormat& Format, TArrayView<const uint8> Frame, TArray<uint8>& DataScratch)
+{
+	if (Callbacks)
+	{
+		Callbacks->OnAudioFrame.ExecuteIfBound(Format, Frame);
+		if (Callbacks->bSkipGlobalDelegates)
+		{
+			return;
+		}
+	}
+	OnAudioFrame.Broadcast(RequestName, Format, Frame);
+	if (OnAudioStreamFrame.IsBound())
+	{
+		DataScratch.Reset();
+		DataScratch.Append(Frame.GetData(), Frame.Num());
+		OnAudioStreamFrame.Broadcast(RequestName, Format, DataScratch);
+	}
+}
+
+void UHTTPSubsystem::OnStringRequestCompleted(int32 ReqId, const FString& Content, const FYnnkHttpHeaders& Headers, const int32 ResponseCode, const bool bWasSuccessful)
+{
+	const FName Keyword = HttpRequests.Contains(ReqId) ? HttpRequests[ReqId].Name : TEXT("Default");
+
+	if (bWasSuccessful)
+	{
+		// headers are shared until delegate with header array has listeners
+		auto Broadcast = [this, Keyword, ResponseCode, Headers](const FString& Text)
+		{
+			const bool bSubscribers = Subscriptions.HasSubscribers(Keyword, &FYnnkHttpSubscriptions::FSubscribers::TextResponse);
+			const TArray<FString> HeaderLines = OnTextResponse.IsBound() || bSubscribers ? Headers.ToArray() : TArray<FString>();
+			OnTextResponse.Broadcast(Keyword, ResponseCode, HeaderLines, Text);
+			Subscriptions.Broadcast(Keyword, &FYnnkHttpSubscriptions::FSubscribers::TextResponse, ResponseCode, HeaderLines, Text);
+		};
+
+		if (bResponseInGameThread && !IsInGameThread())
+		{
+			StringBuffer = Content;
+			AsyncTask(ENamedThreads::GameThread, [this, Broadcast]()
+			{
+				Broadcast(StringBuffer);
+			});
+		}
+		else
+		{
+			Broadcast(Content);
+		}
+	}
+	else
+	{
+		if (bResponseInGameThread && !IsInGameThread())
+		{
+			AsyncTask(ENamedThreads::GameThread, [this, Keyword, ResponseCode]()
+			{
+				OnResponseError.Broadcast(Keyword, ResponseCode);
+				Subscriptions.Broadcast(Keyword, &FYnnkHttpSubscriptions::FSubscribers::Error, ResponseCode);
+			});
+		}
+		else
+		{
+			OnResponseError.Broadcast(Keyword, ResponseCode);
+			Subscriptions.Broadcast(Keyword, &FYnnkHttpSubscriptions::FSubscribers::Error, ResponseCode);
+		}
+	}
+}
+
+void UHTTPSubsystem::OnDataRequestCompleted(int32 ReqId, const TArray<uint8>& Content, const FYnnkHttpHeaders& Headers, const int32 ResponseCode, const bool bWasSuccessful)
+{
+	const FName Keyword = HttpRequests.Contains(ReqId) ? HttpRequests[ReqId].Name : TEXT("Default");
+
+	if (bWasSuccessful)
+	{
+		DataBuffer.SetNum(Content.Num());
+		FMemory::Memcpy(DataBuffer.GetData(), Content.GetData(), DataBuffer.Num());
+
+		// headers are shared until delegate with header array has listeners
+		auto Broadcast = [this, Keyword, ResponseCode, Headers]()
+		{
+			const bool bSubscribers = Subscriptions.HasSubscribers(Keyword, &FYnnkHttpSubscriptions::FSubscribers::DataResponse);
+			const TArray<FString> HeaderLines = OnDataResponse.IsBound() || bSubscribers ? Headers.ToArray() : TArray<FString>();
+			OnDataResponse.Broadcast(Keyword, ResponseCode, HeaderLines, DataBuffer);
+			Subscriptions.Broadcast(Keyword, &FYnnkHttpSubscriptions::FSubscribers::DataResponse, ResponseCode, HeaderLines, DataBuffer);
+		};
+
+		if (bResponseInGameThread && !IsInGameThread())
+		{
+			AsyncTask(ENamedThreads::GameThread, Broadcast);
+		}
+		else
+		{
+			Broadcast();
+		}
+	}
+	else
+	{
+		if (bResponseInGameThread && !IsInGameThread())
+		{
+			AsyncTask(ENamedThreads::GameThread, [this, Keyword, ResponseCode]()
+			{
+				OnResponseError.Broadcast(Keyword, ResponseCode);
+				Subscriptions.Broadcast(Keyword, &FYnnkHttpSubscriptions::FSubscribers::Error, ResponseCode);
+			});
+		}
+		else
+		{
+			OnResponseError.Broadcast(Keyword, ResponseCode);
+			Subscriptions.Broadcast(Keyword, &FYnnkHttpSubscriptions::FSubscribers::Error, ResponseCode);
+		}
+	}
+}
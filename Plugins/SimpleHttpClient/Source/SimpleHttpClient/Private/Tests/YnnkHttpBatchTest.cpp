@@ -0,0 +1,147 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkHttpTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && !UE_BUILD_SHIPPING
+
+#include "YnnkHttpLoopbackServer.h"
+
+namespace
+{
+	static const FName BatchTestKeyword = TEXT("SimpleHttpBatchTest");
+
+	/** Responses of batch in order of delivery. Batch handlers are called in game thread. */
+	struct FBatchTestContext
+	{
+		FYnnkHttpLoopbackServer Server;
+		double StartTime = 0.0;
+		TArray<int32> DeliveredItems;
+		TArray<FYnnkHttpResponse> Responses;
+		TArray<double> DeliveryTimes;
+		TOptional<int32> NumSucceeded;
+		// batch was completed when the last item was delivered
+		int32 NumDeliveredBeforeCompletion = 0;
+	};
+
+	int32 OpenTestBatch(UHTTPSubsystem* HttpSubsystem, const TSharedRef<FBatchTestContext>& Context, int32 MaxParallel)
+	{
+		Context->StartTime = FPlatformTime::Seconds();
+		return HttpSubsystem->OpenHttpBatch(BatchTestKeyword, MaxParallel, YnnkHttpTest::MakeOptions(),
+			[Context](int32 ItemIndex, const FYnnkHttpResponse& Response)
+			{
+				Context->DeliveredItems.Add(ItemIndex);
+				Context->Responses.Add(Response);
+				Context->DeliveryTimes.Add(FPlatformTime::Seconds() - Context->StartTime);
+			},
+			[Context](int32 NumSucceeded)
+			{
+				Context->NumSucceeded = NumSucceeded;
+				Context->NumDeliveredBeforeCompletion = Context->DeliveredItems.Num();
+			});
+	}
+
+	FYnnkHttpBatchItem MakeBatchItem(const FString& URL)
+	{
+		FYnnkHttpBatchItem Item;
+		Item.URL = URL;
+		Item.Verb = ERequestMethod::Get;
+		Item.ExpectedResponseFormat = EExpectedResponseType::Text;
+		return Item;
+	}
+}
+
+/**
+* Responses of parallel requests finished in reverse order are delivered in order of items.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkHttpBatchOrderTest, "SimpleHttpClient.Batch.OrderedDelivery", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkHttpBatchOrderTest::RunTest(const FString& Parameters)
+{
+	UHTTPSubsystem* HttpSubsystem = YnnkHttpTest::GetSubsystem();
+	if (!TestNotNull(TEXT("HTTP subsystem"), HttpSubsystem))
+	{
+		return false;
+	}
+	const TSharedRef<FBatchTestContext> Context = MakeShared<FBatchTestContext>();
+	Context->Server.AddDefaultRoutes();
+	if (!TestTrue(TEXT("Loopback server started"), Context->Server.Start()))
+	{
+		return false;
+	}
+
+	// the first item is the slowest one
+	const int32 BatchId = OpenTestBatch(HttpSubsystem, Context, 4);
+	HttpSubsystem->AddBatchItem(BatchId, MakeBatchItem(Context->Server.GetUrl(TEXT("/fixed?size=10&delay=0.8"))));
+	HttpSubsystem->AddBatchItem(BatchId, MakeBatchItem(Context->Server.GetUrl(TEXT("/fixed?size=20&delay=0.4"))));
+	HttpSubsystem->AddBatchItem(BatchId, MakeBatchItem(Context->Server.GetUrl(TEXT("/fixed?size=30"))));
+	HttpSubsystem->AddBatchItem(BatchId, MakeBatchItem(Context->Server.GetUrl(TEXT("/fixed?size=40&delay=0.2"))));
+	HttpSubsystem->CloseBatch(BatchId);
+
+	ADD_LATENT_AUTOMATION_COMMAND(FYnnkHttpWaitCommand(this, TEXT("batch"), 15.f, [Context]() { return Context->NumSucceeded.IsSet(); }));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Context]()
+	{
+		if (Context->NumSucceeded.IsSet())
+		{
+			TestTrue(TEXT("Order of delivery"), Context->DeliveredItems == TArray<int32>({ 0, 1, 2, 3 }));
+			for (int32 Index = 0; Index < Context->Responses.Num(); Index++)
+			{
+				TestEqual(*FString::Printf(TEXT("Size of response %d"), Index), Context->Responses[Index].Text.Len(), (Context->DeliveredItems[Index] + 1) * 10);
+			}
+			TestEqual(TEXT("Succeeded items"), Context->NumSucceeded.GetValue(), 4);
+			TestEqual(TEXT("Items delivered before completion"), Context->NumDeliveredBeforeCompletion, 4);
+
+			// requests are sent at once: the whole batch takes about as long as the slowest item
+			const double TotalTime = Context->DeliveryTimes.Last();
+			TestTrue(FString::Printf(TEXT("The first item waited for its response (%.2f s)"), Context->DeliveryTimes[0]), Context->DeliveryTimes[0] >= 0.75);
+			TestTrue(FString::Printf(TEXT("Requests are sent in parallel (%.2f s)"), TotalTime), TotalTime < 1.3);
+		}
+		Context->Server.Shutdown();
+		return true;
+	}));
+	return true;
+}
+
+/**
+* Item which fails inside AddBatchItem is delivered in the next tick and doesn't break order.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkHttpBatchFailureTest, "SimpleHttpClient.Batch.DeferredFailure", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkHttpBatchFailureTest::RunTest(const FString& Parameters)
+{
+	UHTTPSubsystem* HttpSubsystem = YnnkHttpTest::GetSubsystem();
+	if (!TestNotNull(TEXT("HTTP subsystem"), HttpSubsystem))
+	{
+		return false;
+	}
+	const TSharedRef<FBatchTestContext> Context = MakeShared<FBatchTestContext>();
+	Context->Server.AddDefaultRoutes();
+	if (!TestTrue(TEXT("Loopback server started"), Context->Server.Start()))
+	{
+		return false;
+	}
+
+	// empty URL is rejected by http module
+	const int32 BatchId = OpenTestBatch(HttpSubsystem, Context, 1);
+	HttpSubsystem->AddBatchItem(BatchId, MakeBatchItem(FString()));
+	HttpSubsystem->AddBatchItem(BatchId, MakeBatchItem(Context->Server.GetUrl(TEXT("/fixed?size=16"))));
+	HttpSubsystem->CloseBatch(BatchId);
+	TestEqual(TEXT("Responses delivered before returning"), Context->DeliveredItems.Num(), 0);
+
+	ADD_LATENT_AUTOMATION_COMMAND(FYnnkHttpWaitCommand(this, TEXT("batch"), 15.f, [Context]() { return Context->NumSucceeded.IsSet(); }));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Context]()
+	{
+		if (Context->NumSucceeded.IsSet())
+		{
+			TestTrue(TEXT("Order of delivery"), Context->DeliveredItems == TArray<int32>({ 0, 1 }));
+			TestFalse(TEXT("Item with empty URL failed"), Context->Responses[0].IsOk());
+			TestTrue(TEXT("Next item is ok"), Context->Responses[1].IsOk());
+			TestEqual(TEXT("Succeeded items"), Context->NumSucceeded.GetValue(), 1);
+		}
+		Context->Server.Shutdown();
+		return true;
+	}));
+	return true;
+}
+
+#endif
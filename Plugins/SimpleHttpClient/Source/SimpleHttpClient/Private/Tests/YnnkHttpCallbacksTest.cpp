@@ -0,0 +1,218 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkHttpTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && !UE_BUILD_SHIPPING
+
+#include "YnnkHttpLoopbackServer.h"
+#include "Misc/ScopeLock.h"
+#include <atomic>
+
+namespace
+{
+	static const FName CallbacksTestKeyword = TEXT("SimpleHttpCallbacksTest");
+	static const FName CallbacksTestGlobalKeyword = TEXT("SimpleHttpCallbacksTestGlobal");
+
+	/** Stream text of one request and number of OnComplete calls */
+	struct FCallbacksTestRequest
+	{
+		FYnnkHttpRequestHandle Handle;
+		FCriticalSection Lock;
+		FString Text;
+		int32 NumCompleted = 0;
+		FYnnkHttpResponse Response;
+
+		bool IsCompleted()
+		{
+			FScopeLock ScopeLock(&Lock);
+			return NumCompleted > 0;
+		}
+	};
+
+	struct FCallbacksTestContext
+	{
+		FYnnkHttpLoopbackServer Server;
+		TArray<TSharedRef<FCallbacksTestRequest, ESPMode::ThreadSafe>> Requests;
+		FDelegateHandle GlobalChunkHandle;
+
+		// chunks of requests broadcasted by OnTextStreamChunk
+		std::atomic<int32> NumGlobalChunks{ 0 };
+		std::atomic<int32> NumSkippedGlobalChunks{ 0 };
+
+		bool AreFinished()
+		{
+			for (const TSharedRef<FCallbacksTestRequest, ESPMode::ThreadSafe>& Request : Requests)
+			{
+				if (!Request->IsCompleted())
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		void Send(UHTTPSubsystem* HttpSubsystem, FName Keyword, const FString& PathAndQuery, bool bSkipGlobalDelegates)
+		{
+			const TSharedRef<FCallbacksTestRequest, ESPMode::ThreadSafe> Request = MakeShared<FCallbacksTestRequest, ESPMode::ThreadSafe>();
+			FYnnkHttpRequestCallbacks Callbacks;
+			Callbacks.bSkipGlobalDelegates = bSkipGlobalDelegates;
+			Callbacks.OnTextChunk.BindLambda([Request](FStringView Text)
+			{
+				FScopeLock Lock(&Request->Lock);
+				Request->Text.Append(Text.GetData(), Text.Len());
+			});
+			Callbacks.OnComplete.BindLambda([Request](const FYnnkHttpResponse& Response)
+			{
+				FScopeLock Lock(&Request->Lock);
+				Request->NumCompleted++;
+				Request->Response = Response;
+			});
+			Request->Handle = HttpSubsystem->SendRequest(Keyword, Server.GetUrl(PathAndQuery), ERequestMethod::Get, {}, FString(), EExpectedResponseType::StreamText, YnnkHttpTest::MakeOptions(), MoveTemp(Callbacks));
+			Requests.Add(Request);
+		}
+	};
+}
+
+/**
+* Stream chunks and completion go only to callbacks of their own request.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkHttpCallbacksTest, "SimpleHttpClient.Callbacks.PerRequest", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkHttpCallbacksTest::RunTest(const FString& Parameters)
+{
+	UHTTPSubsystem* HttpSubsystem = YnnkHttpTest::GetSubsystem();
+	if (!TestNotNull(TEXT("HTTP subsystem"), HttpSubsystem))
+	{
+		return false;
+	}
+	const TSharedRef<FCallbacksTestContext, ESPMode::ThreadSafe> Context = MakeShared<FCallbacksTestContext, ESPMode::ThreadSafe>();
+	Context->Server.AddDefaultRoutes();
+	if (!TestTrue(TEXT("Loopback server started"), Context->Server.Start()))
+	{
+		return false;
+	}
+
+	Context->GlobalChunkHandle = HttpSubsystem->OnTextStreamChunk.AddLambda([WeakContext = TWeakPtr<FCallbacksTestContext, ESPMode::ThreadSafe>(Context)](FName RequestName, FStringView Text)
+	{
+		if (const TSharedPtr<FCallbacksTestContext, ESPMode::ThreadSafe> PinnedContext = WeakContext.Pin())
+		{
+			if (RequestName == CallbacksTestGlobalKeyword)
+			{
+				PinnedContext->NumGlobalChunks++;
+			}
+			else if (RequestName == CallbacksTestKeyword)
+			{
+				PinnedContext->NumSkippedGlobalChunks++;
+			}
+		}
+	});
+
+	// different sizes, so every request must receive its own stream
+	Context->Send(HttpSubsystem, CallbacksTestKeyword, TEXT("/sse?size=300&chunk=50&interval=0.005"), true);
+	Context->Send(HttpSubsystem, CallbacksTestKeyword, TEXT("/sse?size=700&chunk=50&interval=0.005"), true);
+	Context->Send(HttpSubsystem, CallbacksTestGlobalKeyword, TEXT("/sse?size=200&chunk=50&interval=0.005"), false);
+	TestTrue(TEXT("Handles are different"), Context->Requests[0]->Handle.IsValid() && !(Context->Requests[0]->Handle == Context->Requests[1]->Handle));
+
+	ADD_LATENT_AUTOMATION_COMMAND(FYnnkHttpWaitCommand(this, TEXT("stream responses"), 15.f, [Context]() { return Context->AreFinished(); }));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, HttpSubsystem, Context]()
+	{
+		HttpSubsystem->OnTextStreamChunk.Remove(Context->GlobalChunkHandle);
+		if (Context->AreFinished())
+		{
+			TArray<int32> TextSizes;
+			for (const TSharedRef<FCallbacksTestRequest, ESPMode::ThreadSafe>& Request : Context->Requests)
+			{
+				FScopeLock Lock(&Request->Lock);
+				TestEqual(TEXT("OnComplete calls"), Request->NumCompleted, 1);
+				TestTrue(TEXT("Response is ok"), Request->Response.IsOk());
+				TestTrue(TEXT("Handle of response"), Request->Response.Handle == Request->Handle);
+				TestTrue(TEXT("Stream is finished"), Request->Text.Contains(TEXT("[DONE]")));
+				TextSizes.Add(Request->Text.Len());
+			}
+			TestTrue(TEXT("Streams aren't mixed"), TextSizes[0] < TextSizes[1]);
+			TestEqual(TEXT("Request name"), Context->Requests[0]->Response.RequestName, CallbacksTestKeyword);
+			TestEqual(TEXT("Global delegates of requests with bSkipGlobalDelegates"), Context->NumSkippedGlobalChunks.load(), 0);
+			TestTrue(TEXT("Global delegates of request without bSkipGlobalDelegates"), Context->NumGlobalChunks.load() > 0);
+		}
+		Context->Server.Shutdown();
+		return true;
+	}));
+	return true;
+}
+
+/**
+* Future is set with response, continuation and failure without response.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkHttpFutureTest, "SimpleHttpClient.Callbacks.Future", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkHttpFutureTest::RunTest(const FString& Parameters)
+{
+	UHTTPSubsystem* HttpSubsystem = YnnkHttpTest::GetSubsystem();
+	if (!TestNotNull(TEXT("HTTP subsystem"), HttpSubsystem))
+	{
+		return false;
+	}
+
+	struct FFutureTestContext
+	{
+		FYnnkHttpLoopbackServer Server;
+		TFuture<FYnnkHttpResponse> Response;
+		TFuture<int32> ContinuedSize;
+		TFuture<FYnnkHttpResponse> Refused;
+	};
+	const TSharedRef<FFutureTestContext, ESPMode::ThreadSafe> Context = MakeShared<FFutureTestContext, ESPMode::ThreadSafe>();
+	Context->Server.AddDefaultRoutes();
+	if (!TestTrue(TEXT("Loopback server started"), Context->Server.Start()))
+	{
+		return false;
+	}
+
+	// port of stopped server refuses connections
+	FString RefusedUrl;
+	{
+		FYnnkHttpLoopbackServer StoppedServer;
+		if (!TestTrue(TEXT("Second loopback server started"), StoppedServer.Start()))
+		{
+			return false;
+		}
+		RefusedUrl = StoppedServer.GetUrl(TEXT("/fixed"));
+		StoppedServer.Shutdown();
+	}
+
+	const FYnnkHttpRequestOptions Options = YnnkHttpTest::MakeOptions();
+	Context->Response = HttpSubsystem->SendRequestAsync(CallbacksTestKeyword, Context->Server.GetUrl(TEXT("/fixed?size=100")), ERequestMethod::Get, {}, FString(), EExpectedResponseType::Text, Options);
+	Context->ContinuedSize = HttpSubsystem->SendRequestAsync(CallbacksTestKeyword, Context->Server.GetUrl(TEXT("/fixed?size=200")), ERequestMethod::Get, {}, FString(), EExpectedResponseType::Data, Options)
+		.Then([](TFuture<FYnnkHttpResponse> Result)
+		{
+			return Result.Get().Data.Num();
+		});
+	Context->Refused = HttpSubsystem->SendRequestAsync(CallbacksTestKeyword, RefusedUrl, ERequestMethod::Get, {}, FString(), EExpectedResponseType::Text, Options);
+
+	ADD_LATENT_AUTOMATION_COMMAND(FYnnkHttpWaitCommand(this, TEXT("futures"), 15.f, [Context]()
+	{
+		return Context->Response.IsReady() && Context->ContinuedSize.IsReady() && Context->Refused.IsReady();
+	}));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Context]()
+	{
+		if (Context->Response.IsReady())
+		{
+			TestTrue(TEXT("Response is ok"), Context->Response.Get().IsOk());
+			TestEqual(TEXT("Size of text"), Context->Response.Get().Text.Len(), 100);
+		}
+		if (Context->ContinuedSize.IsReady())
+		{
+			TestEqual(TEXT("Result of continuation"), Context->ContinuedSize.Get(), 200);
+		}
+		if (Context->Refused.IsReady())
+		{
+			TestFalse(TEXT("Refused request isn't successful"), Context->Refused.Get().bWasSuccessful);
+			TestFalse(TEXT("Refused request isn't cancelled"), Context->Refused.Get().bCancelled);
+		}
+		Context->Server.Shutdown();
+		return true;
+	}));
+	return true;
+}
+
+#endif
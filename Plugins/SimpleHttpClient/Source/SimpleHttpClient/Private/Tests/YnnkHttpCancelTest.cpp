@@ -0,0 +1,183 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkHttpTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && !UE_BUILD_SHIPPING
+
+#include "YnnkHttpLoopbackServer.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+	static const FName CancelTestKeyword = TEXT("SimpleHttpCancelTest");
+	static const FName CancelTestOtherKeyword = TEXT("SimpleHttpCancelTestOther");
+
+	// about 3 seconds
+	static const TCHAR* SlowPath = TEXT("/drip?size=4096&chunk=64&interval=0.05");
+
+	/** All OnComplete calls of one request */
+	struct FCancelTestRequest
+	{
+		FYnnkHttpRequestHandle Handle;
+		FCriticalSection Lock;
+		TArray<FYnnkHttpResponse> Responses;
+
+		int32 GetNumCompleted()
+		{
+			FScopeLock ScopeLock(&Lock);
+			return Responses.Num();
+		}
+
+		FYnnkHttpResponse GetResponse()
+		{
+			FScopeLock ScopeLock(&Lock);
+			return Responses.Num() > 0 ? Responses[0] : FYnnkHttpResponse();
+		}
+	};
+
+	struct FCancelTestContext
+	{
+		FYnnkHttpLoopbackServer Server;
+		TArray<TSharedRef<FCancelTestRequest, ESPMode::ThreadSafe>> Requests;
+
+		TSharedRef<FCancelTestRequest, ESPMode::ThreadSafe> Send(UHTTPSubsystem* HttpSubsystem, FName Keyword, const FString& PathAndQuery, bool bReplacePrevious = false)
+		{
+			const TSharedRef<FCancelTestRequest, ESPMode::ThreadSafe> Request = MakeShared<FCancelTestRequest, ESPMode::ThreadSafe>();
+			FYnnkHttpRequestOptions Options = YnnkHttpTest::MakeOptions();
+			Options.bReplacePrevious = bReplacePrevious;
+
+			FYnnkHttpRequestCallbacks Callbacks;
+			Callbacks.OnComplete.BindLambda([Request](const FYnnkHttpResponse& Response)
+			{
+				FScopeLock Lock(&Request->Lock);
+				Request->Responses.Add(Response);
+			});
+			Request->Handle = HttpSubsystem->SendRequest(Keyword, Server.GetUrl(PathAndQuery), ERequestMethod::Get, {}, FString(), EExpectedResponseType::Data, Options, MoveTemp(Callbacks));
+			Requests.Add(Request);
+			return Request;
+		}
+	};
+
+	TSharedPtr<FCancelTestContext, ESPMode::ThreadSafe> StartCancelTest(FAutomationTestBase& Test, UHTTPSubsystem*& OutHttpSubsystem)
+	{
+		OutHttpSubsystem = YnnkHttpTest::GetSubsystem();
+		if (!Test.TestNotNull(TEXT("HTTP subsystem"), OutHttpSubsystem))
+		{
+			return nullptr;
+		}
+		const TSharedPtr<FCancelTestContext, ESPMode::ThreadSafe> Context = MakeShared<FCancelTestContext, ESPMode::ThreadSafe>();
+		Context->Server.AddDefaultRoutes();
+		if (!Test.TestTrue(TEXT("Loopback server started"), Context->Server.Start()))
+		{
+			return nullptr;
+		}
+		return Context;
+	}
+
+	void TestCancelled(FAutomationTestBase& Test, const FString& What, FCancelTestRequest& Request)
+	{
+		const FYnnkHttpResponse Response = Request.GetResponse();
+		Test.TestEqual(*(What + TEXT(": OnComplete calls")), Request.GetNumCompleted(), 1);
+		Test.TestTrue(*(What + TEXT(": cancelled status")), Response.bCancelled);
+		Test.TestFalse(*(What + TEXT(": response isn't ok")), Response.IsOk());
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkHttpCancelByHandleTest, "SimpleHttpClient.Cancel.ByHandle", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkHttpCancelByHandleTest::RunTest(const FString& Parameters)
+{
+	UHTTPSubsystem* HttpSubsystem = nullptr;
+	const TSharedPtr<FCancelTestContext, ESPMode::ThreadSafe> Context = StartCancelTest(*this, HttpSubsystem);
+	if (!Context.IsValid())
+	{
+		return false;
+	}
+
+	const TSharedRef<FCancelTestRequest, ESPMode::ThreadSafe> Request = Context->Send(HttpSubsystem, CancelTestKeyword, SlowPath);
+	TestTrue(TEXT("Request is active"), HttpSubsystem->IsRequestActive(Request->Handle));
+
+	// completion is reported before CancelRequest returns
+	TestTrue(TEXT("Request is cancelled"), HttpSubsystem->CancelRequest(Request->Handle));
+	TestCancelled(*this, TEXT("Cancelled request"), *Request);
+	TestTrue(TEXT("Handle of cancelled response"), Request->GetResponse().Handle == Request->Handle);
+	TestFalse(TEXT("Request isn't active"), HttpSubsystem->IsRequestActive(Request->Handle));
+	TestFalse(TEXT("Request can't be cancelled again"), HttpSubsystem->CancelRequest(Request->Handle));
+
+	// abandoned response must not be reported
+	ADD_LATENT_AUTOMATION_COMMAND(FWaitLatentCommand(1.f));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Context, Request]()
+	{
+		TestEqual(TEXT("OnComplete calls after response time"), Request->GetNumCompleted(), 1);
+		Context->Server.Shutdown();
+		return true;
+	}));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkHttpCancelByKeywordTest, "SimpleHttpClient.Cancel.ByKeyword", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkHttpCancelByKeywordTest::RunTest(const FString& Parameters)
+{
+	UHTTPSubsystem* HttpSubsystem = nullptr;
+	const TSharedPtr<FCancelTestContext, ESPMode::ThreadSafe> Context = StartCancelTest(*this, HttpSubsystem);
+	if (!Context.IsValid())
+	{
+		return false;
+	}
+
+	for (int32 Index = 0; Index < 3; Index++)
+	{
+		Context->Send(HttpSubsystem, CancelTestKeyword, SlowPath);
+	}
+	const TSharedRef<FCancelTestRequest, ESPMode::ThreadSafe> Other = Context->Send(HttpSubsystem, CancelTestOtherKeyword, TEXT("/fixed?size=256"));
+
+	TestEqual(TEXT("Cancelled requests"), HttpSubsystem->CancelRequestsByKeyword(CancelTestKeyword), 3);
+	for (int32 Index = 0; Index < 3; Index++)
+	{
+		TestCancelled(*this, FString::Printf(TEXT("Request %d"), Index), *Context->Requests[Index]);
+	}
+	TestEqual(TEXT("Nothing left to cancel"), HttpSubsystem->CancelRequestsByKeyword(CancelTestKeyword), 0);
+
+	ADD_LATENT_AUTOMATION_COMMAND(FYnnkHttpWaitCommand(this, TEXT("request with other keyword"), 10.f, [Other]() { return Other->GetNumCompleted() > 0; }));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Context, Other]()
+	{
+		const FYnnkHttpResponse Response = Other->GetResponse();
+		TestTrue(TEXT("Request with other keyword is ok"), Response.IsOk());
+		TestFalse(TEXT("Request with other keyword isn't cancelled"), Response.bCancelled);
+		TestEqual(TEXT("Size of response"), Response.Data.Num(), 256);
+		Context->Server.Shutdown();
+		return true;
+	}));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkHttpReplacePreviousTest, "SimpleHttpClient.Cancel.ReplacePrevious", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkHttpReplacePreviousTest::RunTest(const FString& Parameters)
+{
+	UHTTPSubsystem* HttpSubsystem = nullptr;
+	const TSharedPtr<FCancelTestContext, ESPMode::ThreadSafe> Context = StartCancelTest(*this, HttpSubsystem);
+	if (!Context.IsValid())
+	{
+		return false;
+	}
+
+	const TSharedRef<FCancelTestRequest, ESPMode::ThreadSafe> Previous = Context->Send(HttpSubsystem, CancelTestKeyword, SlowPath);
+	const TSharedRef<FCancelTestRequest, ESPMode::ThreadSafe> Next = Context->Send(HttpSubsystem, CancelTestKeyword, TEXT("/fixed?size=128"), true);
+	TestCancelled(*this, TEXT("Replaced request"), *Previous);
+	TestTrue(TEXT("New request is active"), HttpSubsystem->IsRequestActive(Next->Handle));
+
+	ADD_LATENT_AUTOMATION_COMMAND(FYnnkHttpWaitCommand(this, TEXT("replacing request"), 10.f, [Next]() { return Next->GetNumCompleted() > 0; }));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Context, Previous, Next]()
+	{
+		TestTrue(TEXT("Replacing request is ok"), Next->GetResponse().IsOk());
+		TestEqual(TEXT("Replaced request is completed once"), Previous->GetNumCompleted(), 1);
+		Context->Server.Shutdown();
+		return true;
+	}));
+	return true;
+}
+
+#endif
@@ -0,0 +1,66 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkHttpTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && !UE_BUILD_SHIPPING
+
+#include "YnnkHttpHeaders.h"
+#include "Misc/DateTime.h"
+
+namespace
+{
+	float GetRetryAfter(const FString& Value)
+	{
+		return FYnnkHttpHeaders(TArray<FString>({ TEXT("Retry-After: ") + Value })).GetRetryAfter();
+	}
+}
+
+/**
+* Header lines are parsed to case-insensitive map with joined duplicates.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkHttpHeadersTest, "SimpleHttpClient.Headers.Parse", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkHttpHeadersTest::RunTest(const FString& Parameters)
+{
+	const TArray<FString> Lines =
+	{
+		TEXT("Content-Type: text/event-stream; charset=utf-8"),
+		TEXT("content-length:  1024 "),
+		TEXT("Set-Cookie: a=1"),
+		TEXT("set-cookie: b=2"),
+		TEXT("X-Time: 12:30:00"),
+		TEXT("Malformed line")
+	};
+	const FYnnkHttpHeaders Headers(Lines);
+
+	TestFalse(TEXT("Headers aren't empty"), Headers.IsEmpty());
+	TestNotNull(TEXT("Name is case-insensitive"), Headers.Find(TEXT("CONTENT-TYPE")));
+	TestNull(TEXT("Missing header"), Headers.Find(TEXT("Retry-After")));
+	TestEqual(TEXT("Content type without parameters"), Headers.GetContentType(), FString(TEXT("text/event-stream")));
+	TestEqual(TEXT("Content length"), Headers.GetContentLength(), (int64)1024);
+	TestEqual(TEXT("Duplicate headers are joined"), Headers.GetValue(TEXT("Set-Cookie")), FString(TEXT("a=1, b=2")));
+	TestEqual(TEXT("Value is split at the first colon"), Headers.GetValue(TEXT("x-time")), FString(TEXT("12:30:00")));
+	TestEqual(TEXT("Lines without colon are skipped"), Headers.GetMap().Num(), 4);
+	TestTrue(TEXT("Source lines"), Headers.ToArray() == Lines);
+	TestEqual(TEXT("Retry-After isn't specified"), Headers.GetRetryAfter(), -1.f);
+
+	// copies share parsed map
+	const FYnnkHttpHeaders Copy = Headers;
+	TestTrue(TEXT("Copy shares map"), &Copy.GetMap() == &Headers.GetMap());
+
+	const FYnnkHttpHeaders Empty;
+	TestTrue(TEXT("Default headers are empty"), Empty.IsEmpty());
+	TestEqual(TEXT("Content length isn't specified"), Empty.GetContentLength(), (int64)-1);
+	TestTrue(TEXT("Content type isn't specified"), Empty.GetContentType().IsEmpty());
+	TestEqual(TEXT("Not numeric content length"), FYnnkHttpHeaders(TArray<FString>({ TEXT("Content-Length: many") })).GetContentLength(), (int64)-1);
+
+	TestEqual(TEXT("Retry-After in seconds"), GetRetryAfter(TEXT("30")), 30.f);
+	TestEqual(TEXT("Retry-After in the past"), GetRetryAfter((FDateTime::UtcNow() - FTimespan::FromHours(1.0)).ToHttpDate()), 0.f);
+	const float RetryAfterDate = GetRetryAfter((FDateTime::UtcNow() + FTimespan::FromSeconds(120.0)).ToHttpDate());
+	TestTrue(FString::Printf(TEXT("Retry-After as http-date (%.1f s)"), RetryAfterDate), RetryAfterDate > 110.f && RetryAfterDate <= 120.f);
+	TestEqual(TEXT("Invalid Retry-After"), GetRetryAfter(TEXT("soon")), -1.f);
+	return true;
+}
+
+#endif
@@ -0,0 +1,222 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkHttpTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && !UE_BUILD_SHIPPING
+
+#include "YnnkHttpLoopbackServer.h"
+#include "YnnkHttpBenchmark.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+	static const FName LoopbackTestKeyword = TEXT("SimpleHttpLoopbackTest");
+
+	/** Loopback server and results of requests sent to it; shared by latent commands of one test */
+	struct FLoopbackTestContext
+	{
+		FYnnkHttpLoopbackServer Server;
+		TArray<TFuture<FYnnkHttpResponse>> Responses;
+
+		// stream callbacks can be called in http thread
+		FCriticalSection ChunksLock;
+		TArray<FString> TextChunks;
+		int64 DataSize = 0;
+
+		bool IsFinished() const
+		{
+			for (const TFuture<FYnnkHttpResponse>& Response : Responses)
+			{
+				if (!Response.IsReady())
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/** Bind OnComplete of callbacks to a new entry of Responses */
+		void AddResponse(FYnnkHttpRequestCallbacks& Callbacks)
+		{
+			const TSharedRef<TPromise<FYnnkHttpResponse>, ESPMode::ThreadSafe> Promise = MakeShared<TPromise<FYnnkHttpResponse>, ESPMode::ThreadSafe>();
+			Responses.Add(Promise->GetFuture());
+			Callbacks.OnComplete.BindLambda([Promise](const FYnnkHttpResponse& Response)
+			{
+				Promise->SetValue(Response);
+			});
+		}
+
+		FString GetStreamedText()
+		{
+			FScopeLock Lock(&ChunksLock);
+			return FString::Join(TextChunks, TEXT(""));
+		}
+	};
+
+	TSharedPtr<FLoopbackTestContext, ESPMode::ThreadSafe> StartContext(FAutomationTestBase& Test)
+	{
+		TSharedPtr<FLoopbackTestContext, ESPMode::ThreadSafe> Context = MakeShared<FLoopbackTestContext, ESPMode::ThreadSafe>();
+		Context->Server.AddDefaultRoutes();
+		if (!Test.TestTrue(TEXT("Loopback server started"), Context->Server.Start()))
+		{
+			return nullptr;
+		}
+		return Context;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkHttpLoopbackFixedTest, "SimpleHttpClient.Loopback.Fixed", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkHttpLoopbackFixedTest::RunTest(const FString& Parameters)
+{
+	UHTTPSubsystem* HttpSubsystem = YnnkHttpTest::GetSubsystem();
+	const TSharedPtr<FLoopbackTestContext, ESPMode::ThreadSafe> Context = StartContext(*this);
+	if (!TestNotNull(TEXT("HTTP subsystem"), HttpSubsystem) || !Context.IsValid())
+	{
+		return false;
+	}
+
+	const FYnnkHttpRequestOptions Options = YnnkHttpTest::MakeOptions();
+	Context->Responses.Add(HttpSubsystem->SendRequestAsync(LoopbackTestKeyword, Context->Server.GetUrl(TEXT("/fixed?size=5000")), ERequestMethod::Get, {}, FString(), EExpectedResponseType::Text, Options));
+	Context->Responses.Add(HttpSubsystem->SendRequestAsync(LoopbackTestKeyword, Context->Server.GetUrl(TEXT("/fixed?size=0&status=404")), ERequestMethod::Get, {}, FString(), EExpectedResponseType::Text, Options));
+	Context->Responses.Add(HttpSubsystem->SendRequestAsync(LoopbackTestKeyword, Context->Server.GetUrl(TEXT("/drip?size=2048&chunk=256&interval=0.01")), ERequestMethod::Get, {}, FString(), EExpectedResponseType::Data, Options));
+
+	ADD_LATENT_AUTOMATION_COMMAND(FYnnkHttpWaitCommand(this, TEXT("loopback responses"), 15.f, [Context]() { return Context->IsFinished(); }));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Context]()
+	{
+		if (!Context->IsFinished())
+		{
+			return true;
+		}
+		const FYnnkHttpResponse& Fixed = Context->Responses[0].Get();
+		TestTrue(TEXT("Fixed response is ok"), Fixed.IsOk());
+		TestEqual(TEXT("Fixed response size"), Fixed.Text.Len(), 5000);
+		TestEqual(TEXT("Content-Length header"), Fixed.Headers.GetContentLength(), (int64)5000);
+
+		const FYnnkHttpResponse& NotFound = Context->Responses[1].Get();
+		TestEqual(TEXT("Status from query"), NotFound.Code, 404);
+		TestFalse(TEXT("404 response isn't ok"), NotFound.IsOk());
+
+		const FYnnkHttpResponse& Drip = Context->Responses[2].Get();
+		TestTrue(TEXT("Slow-drip response is ok"), Drip.IsOk());
+		TestEqual(TEXT("Slow-drip response size"), Drip.Data.Num(), 2048);
+		return true;
+	}));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkHttpLoopbackStreamTest, "SimpleHttpClient.Loopback.Stream", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkHttpLoopbackStreamTest::RunTest(const FString& Parameters)
+{
+	UHTTPSubsystem* HttpSubsystem = YnnkHttpTest::GetSubsystem();
+	const TSharedPtr<FLoopbackTestContext, ESPMode::ThreadSafe> Context = StartContext(*this);
+	if (!TestNotNull(TEXT("HTTP subsystem"), HttpSubsystem) || !Context.IsValid())
+	{
+		return false;
+	}
+
+	const FYnnkHttpRequestOptions Options = YnnkHttpTest::MakeOptions();
+	FYnnkHttpRequestCallbacks SseCallbacks;
+	Context->AddResponse(SseCallbacks);
+	SseCallbacks.OnTextChunk.BindLambda([WeakContext = TWeakPtr<FLoopbackTestContext, ESPMode::ThreadSafe>(Context)](FStringView Text)
+	{
+		if (const TSharedPtr<FLoopbackTestContext, ESPMode::ThreadSafe> PinnedContext = WeakContext.Pin())
+		{
+			FScopeLock Lock(&PinnedContext->ChunksLock);
+			PinnedContext->TextChunks.Add(FString(Text));
+		}
+	});
+	HttpSubsystem->SendRequest(LoopbackTestKeyword, Context->Server.GetUrl(TEXT("/sse?size=1024&chunk=96&interval=0.005")), ERequestMethod::Get, {}, FString(), EExpectedResponseType::StreamText, Options, MoveTemp(SseCallbacks));
+
+	FYnnkHttpRequestCallbacks ChunkedCallbacks;
+	Context->AddResponse(ChunkedCallbacks);
+	ChunkedCallbacks.OnDataChunk.BindLambda([WeakContext = TWeakPtr<FLoopbackTestContext, ESPMode::ThreadSafe>(Context)](TArrayView<const uint8> Data)
+	{
+		if (const TSharedPtr<FLoopbackTestContext, ESPMode::ThreadSafe> PinnedContext = WeakContext.Pin())
+		{
+			FScopeLock Lock(&PinnedContext->ChunksLock);
+			PinnedContext->DataSize += Data.Num();
+		}
+	});
+	HttpSubsystem->SendRequest(LoopbackTestKeyword, Context->Server.GetUrl(TEXT("/chunked?size=65536&chunk=4096")), ERequestMethod::Get, {}, FString(), EExpectedResponseType::StreamData, Options, MoveTemp(ChunkedCallbacks));
+
+	ADD_LATENT_AUTOMATION_COMMAND(FYnnkHttpWaitCommand(this, TEXT("stream responses"), 15.f, [Context]() { return Context->IsFinished(); }));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Context]()
+	{
+		if (!Context->IsFinished())
+		{
+			return true;
+		}
+		TestTrue(TEXT("SSE response is ok"), Context->Responses[0].Get().IsOk());
+		TestTrue(TEXT("Chunked response is ok"), Context->Responses[1].Get().IsOk());
+
+		const FString Text = Context->GetStreamedText();
+		FScopeLock Lock(&Context->ChunksLock);
+		TestTrue(TEXT("SSE events are streamed in several chunks"), Context->TextChunks.Num() > 1);
+		TestTrue(TEXT("Last SSE event is received"), Text.Contains(TEXT("[DONE]")));
+		TestEqual(TEXT("Size of streamed chunked response"), Context->DataSize, (int64)65536);
+		return true;
+	}));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkHttpBenchmarkTest, "SimpleHttpClient.Loopback.Benchmark", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkHttpBenchmarkTest::RunTest(const FString& Parameters)
+{
+	UHTTPSubsystem* HttpSubsystem = YnnkHttpTest::GetSubsystem();
+	if (!TestNotNull(TEXT("HTTP subsystem"), HttpSubsystem))
+	{
+		return false;
+	}
+
+	// fixed, chunked and SSE responses at 1/16/128 concurrent requests
+	struct FBenchmarkState
+	{
+		TSharedPtr<FYnnkHttpBenchmark> Benchmark;
+		TOptional<TArray<FYnnkHttpBenchmarkResult>> Results;
+	};
+	const TSharedRef<FBenchmarkState> State = MakeShared<FBenchmarkState>();
+	State->Benchmark = MakeShared<FYnnkHttpBenchmark>(HttpSubsystem);
+	const TArray<FYnnkHttpBenchmarkScenario> Scenarios = FYnnkHttpBenchmark::GetDefaultScenarios(32);
+	const bool bStarted = State->Benchmark->Start(Scenarios, FYnnkHttpBenchmark::FOnBenchmarkFinished::CreateLambda([State](const TArray<FYnnkHttpBenchmarkResult>& Results)
+	{
+		State->Results = Results;
+	}));
+	if (!TestTrue(TEXT("Benchmark started"), bStarted))
+	{
+		return false;
+	}
+
+	ADD_LATENT_AUTOMATION_COMMAND(FYnnkHttpWaitCommand(this, TEXT("benchmark"), 120.f, [State]() { return State->Results.IsSet(); }));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, State, NumScenarios = Scenarios.Num()]()
+	{
+		if (!State->Results.IsSet())
+		{
+			State->Benchmark->Cancel();
+			return true;
+		}
+
+		const TArray<FYnnkHttpBenchmarkResult>& Results = State->Results.GetValue();
+		TestEqual(TEXT("Number of finished scenarios"), Results.Num(), NumScenarios);
+		for (const FYnnkHttpBenchmarkResult& Result : Results)
+		{
+			TestEqual(*FString::Printf(TEXT("%s: failed requests"), *Result.Scenario.Name), Result.NumFailed, 0);
+			TestEqual(*FString::Printf(TEXT("%s: succeeded requests"), *Result.Scenario.Name), Result.NumSucceeded, Result.Scenario.NumRequests);
+			TestTrue(*FString::Printf(TEXT("%s: latency is measured"), *Result.Scenario.Name), Result.LatencyP50 > 0.f && Result.LatencyP99 >= Result.LatencyP50);
+		}
+
+		FYnnkHttpBenchmark::LogResults(Results);
+		const FString FileName = FYnnkHttpBenchmark::GetDefaultResultsFileName();
+		if (TestTrue(TEXT("Results saved"), FYnnkHttpBenchmark::SaveResults(Results, FileName)))
+		{
+			AddInfo(FString::Printf(TEXT("Benchmark results saved to %s"), *FileName));
+		}
+		return true;
+	}));
+	return true;
+}
+
+#endif
@@ -0,0 +1,229 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkHttpTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && !UE_BUILD_SHIPPING
+
+#include "YnnkHttpLoopbackServer.h"
+#include "YnnkMultipartBody.h"
+#include "HttpModule.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+	static const FName ReplayFixedKeyword = TEXT("SimpleHttpReplayFixed");
+	static const FName ReplayStreamKeyword = TEXT("SimpleHttpReplayStream");
+
+	/** Streamed text and result of one request */
+	struct FReplayedRequest
+	{
+		FCriticalSection TextLock;
+		FString Text;
+		TFuture<FYnnkHttpResponse> Response;
+
+		FString GetText()
+		{
+			FScopeLock Lock(&TextLock);
+			return Text;
+		}
+	};
+
+	struct FReplayTestContext
+	{
+		FYnnkHttpLoopbackServer Server;
+		FString Directory;
+		TOptional<YnnkHttpTest::FTransportState> PrevTransport;
+		int32 NumServerRequests = 0;
+		bool bFinished = false;
+
+		// fixed, stream, fixed with other URL
+		TArray<TSharedRef<FReplayedRequest, ESPMode::ThreadSafe>> Recorded;
+		TArray<TSharedRef<FReplayedRequest, ESPMode::ThreadSafe>> Replayed;
+
+		static bool AreFinished(const TArray<TSharedRef<FReplayedRequest, ESPMode::ThreadSafe>>& Requests)
+		{
+			for (const TSharedRef<FReplayedRequest, ESPMode::ThreadSafe>& Request : Requests)
+			{
+				if (!Request->Response.IsReady())
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		int32 GetNumRecordings() const
+		{
+			TArray<FString> Files;
+			IFileManager::Get().FindFilesRecursive(Files, *Directory, TEXT("*.ynnkrec"), true, false);
+			return Files.Num();
+		}
+	};
+
+	TSharedRef<FReplayedRequest, ESPMode::ThreadSafe> SendReplayTestRequest(UHTTPSubsystem* HttpSubsystem, FName Keyword, const FString& URL, EExpectedResponseType ResponseType)
+	{
+		const TSharedRef<FReplayedRequest, ESPMode::ThreadSafe> Request = MakeShared<FReplayedRequest, ESPMode::ThreadSafe>();
+		const TSharedRef<TPromise<FYnnkHttpResponse>, ESPMode::ThreadSafe> Promise = MakeShared<TPromise<FYnnkHttpResponse>, ESPMode::ThreadSafe>();
+		Request->Response = Promise->GetFuture();
+
+		FYnnkHttpRequestCallbacks Callbacks;
+		Callbacks.OnTextChunk.BindLambda([Request](FStringView Text)
+		{
+			FScopeLock Lock(&Request->TextLock);
+			Request->Text.Append(Text.GetData(), Text.Len());
+		});
+		Callbacks.OnComplete.BindLambda([Promise](const FYnnkHttpResponse& Response)
+		{
+			Promise->SetValue(Response);
+		});
+		HttpSubsystem->SendRequest(Keyword, URL, ERequestMethod::Get, {}, FString(), ResponseType, YnnkHttpTest::MakeOptions(), MoveTemp(Callbacks));
+		return Request;
+	}
+
+	void SendReplayTestRequests(UHTTPSubsystem* HttpSubsystem, FReplayTestContext& Context, TArray<TSharedRef<FReplayedRequest, ESPMode::ThreadSafe>>& OutRequests, bool bReplay)
+	{
+		OutRequests.Add(SendReplayTestRequest(HttpSubsystem, ReplayFixedKeyword, Context.Server.GetUrl(TEXT("/fixed?size=300")), EExpectedResponseType::Text));
+		OutRequests.Add(SendReplayTestRequest(HttpSubsystem, ReplayStreamKeyword, Context.Server.GetUrl(TEXT("/sse?size=512&chunk=64&interval=0.01")), EExpectedResponseType::StreamText));
+		if (bReplay)
+		{
+			// URL wasn't recorded, so the recording is found by keyword
+			OutRequests.Add(SendReplayTestRequest(HttpSubsystem, ReplayFixedKeyword, Context.Server.GetUrl(TEXT("/fixed?size=301")), EExpectedResponseType::Text));
+		}
+	}
+
+	void FinishReplayTest(UHTTPSubsystem* HttpSubsystem, FReplayTestContext& Context)
+	{
+		Context.bFinished = true;
+		if (Context.PrevTransport.IsSet())
+		{
+			Context.PrevTransport->Restore(HttpSubsystem);
+		}
+		Context.Server.Shutdown();
+		IFileManager::Get().DeleteDirectory(*Context.Directory, false, true);
+	}
+}
+
+/**
+* Responses recorded from loopback server are replayed through the same callbacks without network.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkHttpRecordReplayTest, "SimpleHttpClient.Replay.RecordAndReplay", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkHttpRecordReplayTest::RunTest(const FString& Parameters)
+{
+	UHTTPSubsystem* HttpSubsystem = YnnkHttpTest::GetSubsystem();
+	if (!TestNotNull(TEXT("HTTP subsystem"), HttpSubsystem))
+	{
+		return false;
+	}
+
+	const TSharedRef<FReplayTestContext, ESPMode::ThreadSafe> Context = MakeShared<FReplayTestContext, ESPMode::ThreadSafe>();
+	Context->Server.AddDefaultRoutes();
+	if (!TestTrue(TEXT("Loopback server started"), Context->Server.Start()))
+	{
+		return false;
+	}
+	Context->Directory = FPaths::ConvertRelativePathToFull(FPaths::AutomationTransientDir() / TEXT("SimpleHttpReplayTest"));
+	IFileManager::Get().DeleteDirectory(*Context->Directory, false, true);
+	Context->PrevTransport.Emplace(HttpSubsystem);
+
+	HttpSubsystem->SetTransportMode(EYnnkHttpTransportMode::Record, Context->Directory);
+	SendReplayTestRequests(HttpSubsystem, *Context, Context->Recorded, false);
+
+	ADD_LATENT_AUTOMATION_COMMAND(FYnnkHttpWaitCommand(this, TEXT("recorded responses"), 15.f, [Context]() { return FReplayTestContext::AreFinished(Context->Recorded); }));
+	// recordings are written in background
+	ADD_LATENT_AUTOMATION_COMMAND(FYnnkHttpWaitCommand(this, TEXT("recording files"), 10.f, [Context]() { return Context->GetNumRecordings() >= 2; }));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, HttpSubsystem, Context]()
+	{
+		if (!FReplayTestContext::AreFinished(Context->Recorded) || Context->GetNumRecordings() < 2)
+		{
+			FinishReplayTest(HttpSubsystem, *Context);
+			return true;
+		}
+		TestEqual(TEXT("Recording files"), Context->GetNumRecordings(), 2);
+
+		Context->NumServerRequests = Context->Server.GetNumRequests(TEXT("/fixed?size=300")) + Context->Server.GetNumRequests(TEXT("/sse?size=512&chunk=64&interval=0.01"));
+		HttpSubsystem->SetTransportMode(EYnnkHttpTransportMode::Replay, Context->Directory);
+		HttpSubsystem->ReplaySpeed = 0.f;
+		SendReplayTestRequests(HttpSubsystem, *Context, Context->Replayed, true);
+		return true;
+	}));
+	ADD_LATENT_AUTOMATION_COMMAND(FYnnkHttpWaitCommand(this, TEXT("replayed responses"), 10.f, [Context]() { return Context->bFinished || FReplayTestContext::AreFinished(Context->Replayed); }));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, HttpSubsystem, Context]()
+	{
+		if (Context->bFinished)
+		{
+			return true;
+		}
+		if (FReplayTestContext::AreFinished(Context->Replayed))
+		{
+			const FYnnkHttpResponse& RecordedFixed = Context->Recorded[0]->Response.Get();
+			const FYnnkHttpResponse& ReplayedFixed = Context->Replayed[0]->Response.Get();
+			TestTrue(TEXT("Recorded response is ok"), RecordedFixed.IsOk());
+			TestTrue(TEXT("Replayed response is ok"), ReplayedFixed.IsOk());
+			TestEqual(TEXT("Replayed body"), ReplayedFixed.Text, RecordedFixed.Text);
+			TestEqual(TEXT("Replayed Content-Length header"), ReplayedFixed.Headers.GetContentLength(), (int64)300);
+
+			const FString RecordedStream = Context->Recorded[1]->GetText();
+			TestTrue(TEXT("Recorded stream response is ok"), Context->Recorded[1]->Response.Get().IsOk());
+			TestTrue(TEXT("Replayed stream response is ok"), Context->Replayed[1]->Response.Get().IsOk());
+			TestTrue(TEXT("Stream text is recorded"), RecordedStream.Contains(TEXT("[DONE]")));
+			TestEqual(TEXT("Replayed stream text"), Context->Replayed[1]->GetText(), RecordedStream);
+
+			TestEqual(TEXT("Request with other URL is replayed by keyword"), Context->Replayed[2]->Response.Get().Text, RecordedFixed.Text);
+
+			const int32 NumServerRequests = Context->Server.GetNumRequests(TEXT("/fixed?size=300")) + Context->Server.GetNumRequests(TEXT("/sse?size=512&chunk=64&interval=0.01"))
+				+ Context->Server.GetNumRequests(TEXT("/fixed?size=301"));
+			TestEqual(TEXT("Replayed requests aren't sent to server"), NumServerRequests, Context->NumServerRequests);
+		}
+		FinishReplayTest(HttpSubsystem, *Context);
+		return true;
+	}));
+	return true;
+}
+
+/**
+* Streamed bodies are hashed by content, not by empty content of http request.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkHttpReplayHashTest, "SimpleHttpClient.Replay.RequestHash", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkHttpReplayHashTest::RunTest(const FString& Parameters)
+{
+	auto MakeRequest = [](const FString& ContentType)
+	{
+		TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = FHttpModule::Get().CreateRequest();
+		Request->SetVerb(TEXT("POST"));
+		Request->SetURL(TEXT("http://127.0.0.1/upload"));
+		Request->SetHeader(TEXT("Content-Type"), ContentType);
+		return Request;
+	};
+	auto HashMultipart = [&MakeRequest](const FString& Value)
+	{
+		FYnnkMultipartBody Body;
+		Body.AddText(TEXT("text"), Value);
+		return FYnnkHttpRecording::MakeRequestHash(*MakeRequest(Body.GetContentType()), FString(), &Body.CreateReader().Get());
+	};
+
+	// every body has its own boundary
+	TestEqual(TEXT("Equal multipart bodies"), HashMultipart(TEXT("first")), HashMultipart(TEXT("first")));
+	TestNotEqual(TEXT("Different multipart bodies"), HashMultipart(TEXT("first")), HashMultipart(TEXT("second")));
+
+	const FString Directory = FPaths::ConvertRelativePathToFull(FPaths::AutomationTransientDir() / TEXT("SimpleHttpReplayHashTest"));
+	const FString FirstFile = Directory / TEXT("first.bin");
+	const FString SecondFile = Directory / TEXT("second.bin");
+	FFileHelper::SaveStringToFile(TEXT("file body"), *FirstFile);
+	FFileHelper::SaveStringToFile(TEXT("file body"), *SecondFile);
+
+	const TSharedRef<IHttpRequest, ESPMode::ThreadSafe> FileRequest = MakeRequest(TEXT("application/octet-stream"));
+	const FString EmptyBodyHash = FYnnkHttpRecording::MakeRequestHash(*FileRequest);
+	const FString FirstFileHash = FYnnkHttpRecording::MakeRequestHash(*FileRequest, FirstFile);
+	TestEqual(TEXT("Same file"), FYnnkHttpRecording::MakeRequestHash(*FileRequest, FirstFile), FirstFileHash);
+	TestNotEqual(TEXT("Other file"), FYnnkHttpRecording::MakeRequestHash(*FileRequest, SecondFile), FirstFileHash);
+	TestNotEqual(TEXT("File and empty body"), EmptyBodyHash, FirstFileHash);
+
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	return true;
+}
+
+#endif
@@ -0,0 +1,164 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkHttpTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && !UE_BUILD_SHIPPING
+
+#include "YnnkHttpLoopbackServer.h"
+
+namespace
+{
+	static const FName RetryTestKeyword = TEXT("SimpleHttpRetryTest");
+
+	/** Response and time (seconds since request was sent) when it was finished */
+	struct FTimedResponse
+	{
+		FYnnkHttpResponse Response;
+		double Time = 0.0;
+	};
+
+	struct FRetryTestContext
+	{
+		FYnnkHttpLoopbackServer Server;
+		FString PathAndQuery;
+		TFuture<FTimedResponse> Result;
+	};
+
+	/**
+	* Send request to loopback server with fault injection in query (status, delay, retryafter) and call Check when it's finished.
+	* Every test uses its own server, so number of requests received by the server only counts attempts of this request.
+	*/
+	bool RunRetryCase(FAutomationTestBase* Test, const FString& PathAndQuery, const FYnnkRetryPolicy& Policy, float Timeout,
+		TFunction<void(const FRetryTestContext&, const FTimedResponse&)> Check)
+	{
+		UHTTPSubsystem* HttpSubsystem = YnnkHttpTest::GetSubsystem();
+		if (!Test->TestNotNull(TEXT("HTTP subsystem"), HttpSubsystem))
+		{
+			return false;
+		}
+
+		const TSharedRef<FRetryTestContext, ESPMode::ThreadSafe> Context = MakeShared<FRetryTestContext, ESPMode::ThreadSafe>();
+		Context->PathAndQuery = PathAndQuery;
+		Context->Server.AddDefaultRoutes();
+		if (!Test->TestTrue(TEXT("Loopback server started"), Context->Server.Start()))
+		{
+			return false;
+		}
+
+		FYnnkHttpRequestOptions Options = YnnkHttpTest::MakeOptions();
+		Options.RetryPolicy = Policy;
+		if (Options.RetryPolicy.AttemptTimeout <= 0.f)
+		{
+			Options.RetryPolicy.AttemptTimeout = 10.f;
+		}
+
+		const TSharedRef<TPromise<FTimedResponse>, ESPMode::ThreadSafe> Promise = MakeShared<TPromise<FTimedResponse>, ESPMode::ThreadSafe>();
+		Context->Result = Promise->GetFuture();
+		const double StartTime = FPlatformTime::Seconds();
+
+		FYnnkHttpRequestCallbacks Callbacks;
+		Callbacks.OnComplete.BindLambda([Promise, StartTime](const FYnnkHttpResponse& Response)
+		{
+			FTimedResponse Result;
+			Result.Response = Response;
+			Result.Time = FPlatformTime::Seconds() - StartTime;
+			Promise->SetValue(MoveTemp(Result));
+		});
+		HttpSubsystem->SendRequest(RetryTestKeyword, Context->Server.GetUrl(PathAndQuery), ERequestMethod::Get, {}, FString(), EExpectedResponseType::Text, Options, MoveTemp(Callbacks));
+
+		ADD_LATENT_AUTOMATION_COMMAND(FYnnkHttpWaitCommand(Test, PathAndQuery, Timeout, [Context]() { return Context->Result.IsReady(); }));
+		ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([Context, Check]()
+		{
+			if (Context->Result.IsReady())
+			{
+				Check(*Context, Context->Result.Get());
+			}
+			Context->Server.Shutdown();
+			return true;
+		}));
+		return true;
+	}
+
+	/** Short backoff without jitter */
+	FYnnkRetryPolicy MakeRetryPolicy(int32 MaxAttempts)
+	{
+		FYnnkRetryPolicy Policy;
+		Policy.MaxAttempts = MaxAttempts;
+		Policy.InitialBackoff = 0.05f;
+		Policy.BackoffMultiplier = 1.f;
+		Policy.Jitter = 0.f;
+		return Policy;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkHttpRetryServerErrorTest, "SimpleHttpClient.Retry.ServerError", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkHttpRetryServerErrorTest::RunTest(const FString& Parameters)
+{
+	return RunRetryCase(this, TEXT("/fixed?size=16&status=503,500,200"), MakeRetryPolicy(3), 10.f, [this](const FRetryTestContext& Context, const FTimedResponse& Result)
+	{
+		TestTrue(TEXT("Response is ok after retries"), Result.Response.IsOk());
+		TestEqual(TEXT("Attempts received by server"), Context.Server.GetNumRequests(Context.PathAndQuery), 3);
+		TestEqual(TEXT("Response of the last attempt"), Result.Response.Headers.GetValue(TEXT("X-Loopback-Request")), FString(TEXT("2")));
+	});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkHttpRetryAfterTest, "SimpleHttpClient.Retry.RetryAfter", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkHttpRetryAfterTest::RunTest(const FString& Parameters)
+{
+	// backoff is 0.05 s, so the delay can only come from Retry-After header of 429 response
+	return RunRetryCase(this, TEXT("/fixed?size=16&status=429,200&retryafter=1"), MakeRetryPolicy(2), 10.f, [this](const FRetryTestContext& Context, const FTimedResponse& Result)
+	{
+		TestTrue(TEXT("Response is ok after retry"), Result.Response.IsOk());
+		TestEqual(TEXT("Attempts received by server"), Context.Server.GetNumRequests(Context.PathAndQuery), 2);
+		TestTrue(FString::Printf(TEXT("Retry waited for Retry-After (%.2f s)"), Result.Time), Result.Time >= 0.95);
+	});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkHttpRetryGiveUpTest, "SimpleHttpClient.Retry.GiveUp", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkHttpRetryGiveUpTest::RunTest(const FString& Parameters)
+{
+	return RunRetryCase(this, TEXT("/fixed?size=16&status=503"), MakeRetryPolicy(2), 10.f, [this](const FRetryTestContext& Context, const FTimedResponse& Result)
+	{
+		TestFalse(TEXT("Response isn't ok"), Result.Response.IsOk());
+		TestEqual(TEXT("Code of the last attempt"), Result.Response.Code, 503);
+		TestEqual(TEXT("Attempts received by server"), Context.Server.GetNumRequests(Context.PathAndQuery), 2);
+	});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkHttpHedgeWinsTest, "SimpleHttpClient.Retry.HedgeWins", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkHttpHedgeWinsTest::RunTest(const FString& Parameters)
+{
+	// the first request is answered in 2 s, hedged one - immediately
+	FYnnkRetryPolicy Policy = MakeRetryPolicy(1);
+	Policy.HedgeDelay = 0.2f;
+	return RunRetryCase(this, TEXT("/fixed?size=16&delay=2,0"), Policy, 10.f, [this](const FRetryTestContext& Context, const FTimedResponse& Result)
+	{
+		TestTrue(TEXT("Response is ok"), Result.Response.IsOk());
+		TestEqual(TEXT("Requests received by server"), Context.Server.GetNumRequests(Context.PathAndQuery), 2);
+		TestEqual(TEXT("Hedged request won"), Result.Response.Headers.GetValue(TEXT("X-Loopback-Request")), FString(TEXT("1")));
+		TestTrue(FString::Printf(TEXT("Finished before the first request (%.2f s)"), Result.Time), Result.Time < 1.5);
+	});
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkHttpPrimaryWinsTest, "SimpleHttpClient.Retry.PrimaryWins", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkHttpPrimaryWinsTest::RunTest(const FString& Parameters)
+{
+	// hedged request is sent after 0.1 s, but answered in 3 s; the first request is answered in 0.5 s
+	FYnnkRetryPolicy Policy = MakeRetryPolicy(1);
+	Policy.HedgeDelay = 0.1f;
+	return RunRetryCase(this, TEXT("/fixed?size=16&delay=0.5,3"), Policy, 10.f, [this](const FRetryTestContext& Context, const FTimedResponse& Result)
+	{
+		TestTrue(TEXT("Response is ok"), Result.Response.IsOk());
+		TestEqual(TEXT("Requests received by server"), Context.Server.GetNumRequests(Context.PathAndQuery), 2);
+		TestEqual(TEXT("The first request won"), Result.Response.Headers.GetValue(TEXT("X-Loopback-Request")), FString(TEXT("0")));
+		TestTrue(FString::Printf(TEXT("Hedged request wasn't awaited (%.2f s)"), Result.Time), Result.Time < 2.5);
+	});
+}
+
+#endif
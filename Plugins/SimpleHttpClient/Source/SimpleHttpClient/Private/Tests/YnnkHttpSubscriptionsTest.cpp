@@ -0,0 +1,138 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkHttpTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && !UE_BUILD_SHIPPING
+
+#include "YnnkHttpTestListener.h"
+#include "YnnkHttpLoopbackServer.h"
+#include "UObject/StrongObjectPtr.h"
+
+namespace
+{
+	static const FName SubscriptionStreamKeyword = TEXT("SimpleHttpSubscriptionStream");
+	static const FName SubscriptionOtherStreamKeyword = TEXT("SimpleHttpSubscriptionOtherStream");
+	static const FName SubscriptionResponseKeyword = TEXT("SimpleHttpSubscriptionResponse");
+
+	struct FSubscriptionTestContext
+	{
+		FYnnkHttpLoopbackServer Server;
+		TStrongObjectPtr<UYnnkHttpTestListener> Listener;
+		TStrongObjectPtr<UYnnkHttpTestListener> OtherListener;
+		// subscribed after Listener unsubscribed
+		TStrongObjectPtr<UYnnkHttpTestListener> LateListener;
+		FString ListenerText;
+	};
+
+	void SubscribeToStream(UHTTPSubsystem* HttpSubsystem, FName Keyword, UYnnkHttpTestListener* Listener)
+	{
+		FHttpKeywordTextEvent Event;
+		Event.BindDynamic(Listener, &UYnnkHttpTestListener::HandleTextChunk);
+		HttpSubsystem->SubscribeToTextStream(Keyword, Event);
+	}
+
+	bool SendSubscriptionTestRequest(UHTTPSubsystem* HttpSubsystem, FName Keyword, const FString& URL, EExpectedResponseType ResponseType)
+	{
+		return HttpSubsystem->SendHttpRequestWithOptions(Keyword, URL, ERequestMethod::Get, {}, FString(), YnnkHttpTest::MakeOptions(), ResponseType);
+	}
+
+	bool IsStreamFinished(const UYnnkHttpTestListener* Listener, int32 NumStreams = 1)
+	{
+		int32 NumFinished = 0;
+		const FString Text = Listener->GetStreamedText();
+		for (int32 Index = Text.Find(TEXT("[DONE]")); Index != INDEX_NONE; Index = Text.Find(TEXT("[DONE]"), ESearchCase::CaseSensitive, ESearchDir::FromStart, Index + 1))
+		{
+			NumFinished++;
+		}
+		return NumFinished >= NumStreams;
+	}
+}
+
+/**
+* Subscribers only receive events of their keywords and nothing after Unsubscribe.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkHttpSubscriptionsTest, "SimpleHttpClient.Subscriptions.KeywordRouting", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkHttpSubscriptionsTest::RunTest(const FString& Parameters)
+{
+	UHTTPSubsystem* HttpSubsystem = YnnkHttpTest::GetSubsystem();
+	if (!TestNotNull(TEXT("HTTP subsystem"), HttpSubsystem))
+	{
+		return false;
+	}
+	const TSharedRef<FSubscriptionTestContext> Context = MakeShared<FSubscriptionTestContext>();
+	Context->Server.AddDefaultRoutes();
+	if (!TestTrue(TEXT("Loopback server started"), Context->Server.Start()))
+	{
+		return false;
+	}
+
+	// port of stopped server refuses connections
+	FString RefusedUrl;
+	{
+		FYnnkHttpLoopbackServer StoppedServer;
+		if (!TestTrue(TEXT("Second loopback server started"), StoppedServer.Start()))
+		{
+			return false;
+		}
+		RefusedUrl = StoppedServer.GetUrl(TEXT("/fixed"));
+		StoppedServer.Shutdown();
+	}
+
+	Context->Listener.Reset(NewObject<UYnnkHttpTestListener>());
+	Context->OtherListener.Reset(NewObject<UYnnkHttpTestListener>());
+	Context->LateListener.Reset(NewObject<UYnnkHttpTestListener>());
+	UYnnkHttpTestListener* Listener = Context->Listener.Get();
+
+	SubscribeToStream(HttpSubsystem, SubscriptionStreamKeyword, Listener);
+	SubscribeToStream(HttpSubsystem, SubscriptionOtherStreamKeyword, Context->OtherListener.Get());
+	FHttpKeywordTextResponseEvent ResponseEvent;
+	ResponseEvent.BindDynamic(Listener, &UYnnkHttpTestListener::HandleTextResponse);
+	HttpSubsystem->SubscribeToTextResponse(SubscriptionResponseKeyword, ResponseEvent);
+	FHttpKeywordErrorEvent ErrorEvent;
+	ErrorEvent.BindDynamic(Listener, &UYnnkHttpTestListener::HandleError);
+	HttpSubsystem->SubscribeToError(SubscriptionResponseKeyword, ErrorEvent);
+
+	// streams of different size, so mixed chunks would be visible
+	SendSubscriptionTestRequest(HttpSubsystem, SubscriptionStreamKeyword, Context->Server.GetUrl(TEXT("/sse?size=300&chunk=50&interval=0.005")), EExpectedResponseType::StreamText);
+	SendSubscriptionTestRequest(HttpSubsystem, SubscriptionOtherStreamKeyword, Context->Server.GetUrl(TEXT("/sse?size=700&chunk=50&interval=0.005")), EExpectedResponseType::StreamText);
+	SendSubscriptionTestRequest(HttpSubsystem, SubscriptionResponseKeyword, Context->Server.GetUrl(TEXT("/fixed?size=50")), EExpectedResponseType::Text);
+	SendSubscriptionTestRequest(HttpSubsystem, SubscriptionResponseKeyword, RefusedUrl, EExpectedResponseType::Text);
+
+	auto IsFirstPhaseFinished = [Context]()
+	{
+		return IsStreamFinished(Context->Listener.Get()) && IsStreamFinished(Context->OtherListener.Get())
+			&& Context->Listener->GetNumResponses() > 0 && Context->Listener->GetNumErrors() > 0;
+	};
+	ADD_LATENT_AUTOMATION_COMMAND(FYnnkHttpWaitCommand(this, TEXT("subscribed events"), 15.f, IsFirstPhaseFinished));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, HttpSubsystem, Context, IsFirstPhaseFinished]()
+	{
+		if (IsFirstPhaseFinished())
+		{
+			Context->ListenerText = Context->Listener->GetStreamedText();
+			TestTrue(TEXT("Listener received only its stream"), Context->ListenerText.Len() < Context->OtherListener->GetStreamedText().Len());
+			TestFalse(TEXT("Other listener received only its stream"), IsStreamFinished(Context->OtherListener.Get(), 2));
+			TestEqual(TEXT("Text responses"), Context->Listener->GetNumResponses(), 1);
+			TestEqual(TEXT("Text of response"), Context->Listener->GetResponseText().Len(), 50);
+			TestEqual(TEXT("Errors"), Context->Listener->GetNumErrors(), 1);
+		}
+
+		HttpSubsystem->Unsubscribe(Context->Listener.Get());
+		SubscribeToStream(HttpSubsystem, SubscriptionStreamKeyword, Context->LateListener.Get());
+		SendSubscriptionTestRequest(HttpSubsystem, SubscriptionStreamKeyword, Context->Server.GetUrl(TEXT("/sse?size=300&chunk=50&interval=0.005")), EExpectedResponseType::StreamText);
+		return true;
+	}));
+	ADD_LATENT_AUTOMATION_COMMAND(FYnnkHttpWaitCommand(this, TEXT("stream after unsubscribe"), 15.f, [Context]() { return IsStreamFinished(Context->LateListener.Get()); }));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, HttpSubsystem, Context]()
+	{
+		TestEqual(TEXT("Unsubscribed listener didn't receive stream"), Context->Listener->GetStreamedText(), Context->ListenerText);
+		HttpSubsystem->Unsubscribe(Context->OtherListener.Get());
+		HttpSubsystem->Unsubscribe(Context->LateListener.Get());
+		Context->Server.Shutdown();
+		return true;
+	}));
+	return true;
+}
+
+#endif
@@ -0,0 +1,104 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "HTTPSubsystem.h"
+#include "YnnkHttpRecording.h"
+#include "Engine/Engine.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryWriter.h"
+
+#define YNNK_HTTP_TEST_FLAGS (EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+namespace YnnkHttpTest
+{
+	inline UHTTPSubsystem* GetSubsystem()
+	{
+		return GEngine ? GEngine->GetEngineSubsystem<UHTTPSubsystem>() : nullptr;
+	}
+
+	/** Options of request which must not wait for subsystem defaults */
+	inline FYnnkHttpRequestOptions MakeOptions(float AttemptTimeout = 10.f)
+	{
+		FYnnkHttpRequestOptions Options;
+		Options.RetryPolicy.AttemptTimeout = AttemptTimeout;
+		return Options;
+	}
+
+	/** Write recording to directory of replayed sessions. Request hash doesn't have to match: recording is also found by keyword. */
+	inline bool SaveRecording(const FString& Directory, FName Keyword, FYnnkHttpRecording& Recording, int32 Index = 0)
+	{
+		Recording.Keyword = Keyword.ToString();
+		TArray<uint8> Data;
+		FMemoryWriter Writer(Data);
+		Recording.Serialize(Writer);
+
+		const FString FileName = FYnnkHttpReplayIndex::MakeFileName(Directory, Keyword, Recording.RequestHash, TEXT("test"), Index);
+		IFileManager::Get().MakeDirectory(*FPaths::GetPath(FileName), true);
+		return FFileHelper::SaveArrayToFile(Data, *FileName);
+	}
+
+	/** Transport settings of subsystem, restored when test is finished */
+	struct FTransportState
+	{
+		EYnnkHttpTransportMode Mode;
+		FString Directory;
+		float ReplaySpeed;
+
+		explicit FTransportState(const UHTTPSubsystem* HttpSubsystem)
+			: Mode(HttpSubsystem->TransportMode)
+			, Directory(HttpSubsystem->GetRecordingDirectory())
+			, ReplaySpeed(HttpSubsystem->ReplaySpeed)
+		{}
+
+		void Restore(UHTTPSubsystem* HttpSubsystem) const
+		{
+			HttpSubsystem->SetTransportMode(Mode, Directory);
+			HttpSubsystem->ReplaySpeed = ReplaySpeed;
+		}
+	};
+}
+
+/**
+* Waits until Predicate returns true in game thread. Test fails if it doesn't happen in Timeout seconds.
+*/
+class FYnnkHttpWaitCommand : public IAutomationLatentCommand
+{
+public:
+	FYnnkHttpWaitCommand(FAutomationTestBase* InTest, const FString& InDescription, float InTimeout, TFunction<bool()> InPredicate)
+		: Test(InTest)
+		, Description(InDescription)
+		, Timeout(InTimeout)
+		, Predicate(MoveTemp(InPredicate))
+	{}
+
+	virtual bool Update() override
+	{
+		if (Predicate())
+		{
+			return true;
+		}
+		if (GetCurrentRunTime() > Timeout)
+		{
+			Test->AddError(FString::Printf(TEXT("Timeout (%.1f s) waiting for %s"), Timeout, *Description));
+			return true;
+		}
+		return false;
+	}
+
+private:
+	FAutomationTestBase* Test;
+	FString Description;
+	float Timeout;
+	TFunction<bool()> Predicate;
+};
+
+#endif
@@ -0,0 +1,72 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "Misc/ScopeLock.h"
+#include "YnnkHttpTestListener.generated.h"
+
+/**
+* Receiver of keyword subscriptions in automation tests. Events can be called in http thread.
+*/
+UCLASS(Transient)
+class UYnnkHttpTestListener : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION()
+	void HandleTextChunk(const FName& RequestName, const FString& Text)
+	{
+		FScopeLock Lock(&EventsLock);
+		StreamedText += Text;
+	}
+
+	UFUNCTION()
+	void HandleTextResponse(const FName& RequestName, int32 Code, const TArray<FString>& Headers, const FString& Data)
+	{
+		FScopeLock Lock(&EventsLock);
+		NumResponses++;
+		ResponseText = Data;
+	}
+
+	UFUNCTION()
+	void HandleError(const FName& RequestName, int32 Code)
+	{
+		FScopeLock Lock(&EventsLock);
+		NumErrors++;
+	}
+
+	FString GetStreamedText() const
+	{
+		FScopeLock Lock(&EventsLock);
+		return StreamedText;
+	}
+
+	FString GetResponseText() const
+	{
+		FScopeLock Lock(&EventsLock);
+		return ResponseText;
+	}
+
+	int32 GetNumResponses() const
+	{
+		FScopeLock Lock(&EventsLock);
+		return NumResponses;
+	}
+
+	int32 GetNumErrors() const
+	{
+		FScopeLock Lock(&EventsLock);
+		return NumErrors;
+	}
+
+private:
+	mutable FCriticalSection EventsLock;
+	FString StreamedText;
+	FString ResponseText;
+	int32 NumResponses = 0;
+	int32 NumErrors = 0;
+};
@@ -0,0 +1,112 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkHttpTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && !UE_BUILD_SHIPPING
+
+#include "YnnkHttpLoopbackServer.h"
+
+namespace
+{
+	static const FName WarmHostKeyword = TEXT("SimpleHttpWarmupTestWarm");
+	static const FName ColdHostKeyword = TEXT("SimpleHttpWarmupTestCold");
+
+	// not routed: any response code means connection is open
+	static const TCHAR* WarmupPath = TEXT("/health");
+
+	struct FWarmupTestContext
+	{
+		FYnnkHttpLoopbackServer Server;
+		// never warmed up
+		FYnnkHttpLoopbackServer ColdServer;
+		bool bPrevCollectMetrics = true;
+		FYnnkHttpMetricsSnapshot WarmBefore;
+		FYnnkHttpMetricsSnapshot ColdBefore;
+		TFuture<FYnnkHttpResponse> WarmResponse;
+		TFuture<FYnnkHttpResponse> ColdResponse;
+	};
+
+	/** Metrics are accumulated over all runs, so test compares snapshots */
+	FYnnkHttpMetricsSnapshot GetSnapshot(const UHTTPSubsystem* HttpSubsystem, FName Keyword)
+	{
+		FYnnkHttpMetricsSnapshot Snapshot;
+		HttpSubsystem->GetKeywordMetrics(Keyword, Snapshot);
+		return Snapshot;
+	}
+}
+
+/**
+* Warm-up endpoint makes its host warm before the first request, and requests to warm host are counted as reused connections.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkHttpWarmupTest, "SimpleHttpClient.Connections.Warmup", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkHttpWarmupTest::RunTest(const FString& Parameters)
+{
+	UHTTPSubsystem* HttpSubsystem = YnnkHttpTest::GetSubsystem();
+	if (!TestNotNull(TEXT("HTTP subsystem"), HttpSubsystem))
+	{
+		return false;
+	}
+	const TSharedRef<FWarmupTestContext, ESPMode::ThreadSafe> Context = MakeShared<FWarmupTestContext, ESPMode::ThreadSafe>();
+	Context->Server.AddDefaultRoutes();
+	Context->ColdServer.AddDefaultRoutes();
+	if (!TestTrue(TEXT("Loopback server started"), Context->Server.Start()) || !TestTrue(TEXT("Second loopback server started"), Context->ColdServer.Start()))
+	{
+		return false;
+	}
+
+	const FString WarmupUrl = Context->Server.GetUrl(WarmupPath);
+	TestFalse(TEXT("New host isn't warm"), HttpSubsystem->IsHostWarm(WarmupUrl));
+
+	Context->bPrevCollectMetrics = HttpSubsystem->bCollectMetrics;
+	HttpSubsystem->bCollectMetrics = true;
+	Context->WarmBefore = GetSnapshot(HttpSubsystem, WarmHostKeyword);
+	Context->ColdBefore = GetSnapshot(HttpSubsystem, ColdHostKeyword);
+
+	HttpSubsystem->AddWarmupEndpoint(WarmupUrl);
+	TestTrue(TEXT("Endpoint is added"), HttpSubsystem->WarmupEndpoints.Contains(WarmupUrl));
+
+	// host is the same for all paths of server
+	const FString RequestUrl = Context->Server.GetUrl(TEXT("/fixed?size=64"));
+	ADD_LATENT_AUTOMATION_COMMAND(FYnnkHttpWaitCommand(this, TEXT("warm-up"), 10.f, [HttpSubsystem, RequestUrl]() { return HttpSubsystem->IsHostWarm(RequestUrl); }));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([HttpSubsystem, Context, RequestUrl]()
+	{
+		const FYnnkHttpRequestOptions Options = YnnkHttpTest::MakeOptions();
+		Context->WarmResponse = HttpSubsystem->SendRequestAsync(WarmHostKeyword, RequestUrl, ERequestMethod::Get, {}, FString(), EExpectedResponseType::Text, Options);
+		Context->ColdResponse = HttpSubsystem->SendRequestAsync(ColdHostKeyword, Context->ColdServer.GetUrl(TEXT("/fixed?size=64")), ERequestMethod::Get, {}, FString(), EExpectedResponseType::Text, Options);
+		return true;
+	}));
+	ADD_LATENT_AUTOMATION_COMMAND(FYnnkHttpWaitCommand(this, TEXT("requests"), 10.f, [Context]()
+	{
+		return Context->WarmResponse.IsValid() && Context->WarmResponse.IsReady() && Context->ColdResponse.IsReady();
+	}));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, HttpSubsystem, Context, WarmupUrl]()
+	{
+		if (Context->WarmResponse.IsValid() && Context->WarmResponse.IsReady() && Context->ColdResponse.IsReady())
+		{
+			TestTrue(TEXT("Warm-up request received"), Context->Server.GetNumRequests(WarmupPath) > 0);
+			TestTrue(TEXT("Response of warm host"), Context->WarmResponse.Get().IsOk());
+			TestTrue(TEXT("Response of cold host"), Context->ColdResponse.Get().IsOk());
+
+			// metrics are recorded before completion
+			const FYnnkHttpMetricsSnapshot Warm = GetSnapshot(HttpSubsystem, WarmHostKeyword);
+			const FYnnkHttpMetricsSnapshot Cold = GetSnapshot(HttpSubsystem, ColdHostKeyword);
+			TestEqual(TEXT("Requests to warm host"), Warm.NumRequests - Context->WarmBefore.NumRequests, 1);
+			TestEqual(TEXT("Reused connections of warm host"), Warm.NumReusedConnections - Context->WarmBefore.NumReusedConnections, 1);
+			TestEqual(TEXT("Requests to cold host"), Cold.NumRequests - Context->ColdBefore.NumRequests, 1);
+			TestEqual(TEXT("Reused connections of cold host"), Cold.NumReusedConnections - Context->ColdBefore.NumReusedConnections, 0);
+			TestTrue(TEXT("Cold host is warm after response"), HttpSubsystem->IsHostWarm(Context->ColdServer.GetUrl(TEXT("/fixed"))));
+		}
+
+		HttpSubsystem->RemoveWarmupEndpoint(WarmupUrl);
+		TestFalse(TEXT("Endpoint is removed"), HttpSubsystem->WarmupEndpoints.Contains(WarmupUrl));
+		HttpSubsystem->bCollectMetrics = Context->bPrevCollectMetrics;
+		Context->Server.Shutdown();
+		Context->ColdServer.Shutdown();
+		return true;
+	}));
+	return true;
+}
+
+#endif
@@ -0,0 +1,229 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkHttpTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && !UE_BUILD_SHIPPING
+
+#include "YnnkStreamRingBuffer.h"
+#include "YnnkUtf8Decoder.h"
+#include "YnnkCountingMalloc.h"
+#include "JsonItemFunctionsLibrary.h"
+
+namespace
+{
+	static const FName ReplayTestKeyword = TEXT("SimpleHttpAllocationTest");
+
+	FString MakeStreamText()
+	{
+		FString Stream;
+		for (int32 Index = 0; Index < 64; Index++)
+		{
+			const FString Token = FString::ChrN(1 + (Index * 53) % 300, TEXT('a')) + TEXT(" \u041C\u0438\u0440 \u4E16\u754C");
+			Stream += FString::Printf(TEXT("data: {\"choices\":[{\"delta\":{\"content\":\"%s\"}}]}\n\n"), *Token);
+		}
+		return Stream;
+	}
+
+	/** Stream of server-sent events cut into chunks of different sizes, so multibyte characters are split between chunks */
+	TArray<TArray<uint8>> MakeStreamChunks()
+	{
+		const FString Stream = MakeStreamText();
+		FTCHARToUTF8 Utf8(*Stream);
+		const uint8* Data = (const uint8*)Utf8.Get();
+
+		TArray<TArray<uint8>> Chunks;
+		for (int32 Offset = 0; Offset < Utf8.Length(); )
+		{
+			const int32 Size = FMath::Min(1 + (Chunks.Num() * 37) % 700, Utf8.Length() - Offset);
+			Chunks.Emplace(Data + Offset, Size);
+			Offset += Size;
+		}
+		return Chunks;
+	}
+
+	/** Same work as UHTTPSubsystem does for a text stream chunk: buffer, decode to reused string, clean */
+	int32 ProcessChunks(FYnnkStreamRingBuffer& Buffer, FYnnkUtf8StreamDecoder& Decoder, FString& Text, const TArray<TArray<uint8>>& Chunks, int32 ChunksPerRead)
+	{
+		int32 NumRead = 0;
+		for (int32 Index = 0; Index < Chunks.Num(); Index++)
+		{
+			if (!Buffer.Push(Chunks[Index].GetData(), Chunks[Index].Num()))
+			{
+				return INDEX_NONE;
+			}
+			// reader is behind writer for a few chunks, so write position wraps at different offsets
+			if ((Index + 1) % ChunksPerRead != 0 && Index + 1 < Chunks.Num())
+			{
+				continue;
+			}
+
+			TArrayView<const uint8> Chunk;
+			while (Buffer.Peek(Chunk))
+			{
+				Decoder.Decode(Chunk.GetData(), Chunk.Num(), Text);
+				UJsonItemFunctionsLibrary::CleanJsonResponseInline(Text);
+				Buffer.Pop();
+				NumRead++;
+			}
+		}
+		return NumRead;
+	}
+}
+
+/**
+* Stream chunks don't allocate memory once the buffer and string scratch of a request reached their size.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkStreamRingBufferAllocationTest, "SimpleHttpClient.StreamBuffer.ZeroAllocations", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkStreamRingBufferAllocationTest::RunTest(const FString& Parameters)
+{
+	const TArray<TArray<uint8>> Chunks = MakeStreamChunks();
+	const TSharedPtr<FYnnkStreamBackpressure, ESPMode::ThreadSafe> Backpressure = MakeShared<FYnnkStreamBackpressure, ESPMode::ThreadSafe>();
+	Backpressure->SetMaxBytes(1024 * 1024);
+	FYnnkStreamRingBuffer Buffer(16384, Backpressure);
+	FYnnkUtf8StreamDecoder Decoder;
+	FString Text;
+
+	// warm-up: string scratch grows to the largest chunk
+	if (!TestEqual(TEXT("Chunks read in warm-up"), ProcessChunks(Buffer, Decoder, Text, Chunks, 4), Chunks.Num()))
+	{
+		return false;
+	}
+
+	constexpr int32 NumRounds = 50;
+	int32 NumRead = 0;
+	FYnnkAllocationCounter Allocations;
+	{
+		FYnnkAllocationScope AllocationScope(Allocations);
+		for (int32 Round = 0; Round < NumRounds; Round++)
+		{
+			NumRead += ProcessChunks(Buffer, Decoder, Text, Chunks, 1 + Round % 5);
+		}
+	}
+
+	TestEqual(TEXT("Chunks read"), NumRead, Chunks.Num() * NumRounds);
+	TestTrue(TEXT("Buffer is empty"), Buffer.IsEmpty());
+	TestEqual(TEXT("Budget is released"), Backpressure->GetUsedBytes(), (int64)0);
+	TestEqual(TEXT("Allocations in steady state"), Allocations.NumAllocations, (int64)0);
+	return true;
+}
+
+namespace
+{
+	/** Replayed request and allocations between its stream callbacks */
+	struct FReplayAllocationContext
+	{
+		FYnnkAllocationCounter Allocations;
+		FString Text;
+		int32 NumCountedGaps = 0;
+		bool bCount = false;
+		TOptional<FYnnkHttpResponse> Response;
+	};
+
+	/**
+	* Replayed chunks go through StreamChunkReceivedWrapper and BroadcastStreamChunk in game thread, all in one tick.
+	* Allocations are counted from the end of one callback to the start of the next one, so only work of subsystem is counted.
+	*/
+	void SendReplayedRequest(UHTTPSubsystem* HttpSubsystem, const TSharedRef<FReplayAllocationContext>& Context, bool bCount)
+	{
+		Context->bCount = bCount;
+		Context->Response.Reset();
+		Context->Text.Reset();
+
+		FYnnkHttpRequestCallbacks Callbacks;
+		Callbacks.OnTextChunk.BindLambda([Context](FStringView Text)
+		{
+			FYnnkCountingMalloc::SetThreadCounter(nullptr);
+			Context->Text.Append(Text.GetData(), Text.Len());
+			// counting isn't continued after the last event, because request is completed after it
+			if (Context->bCount && !Context->Text.EndsWith(TEXT("[DONE]\n\n")))
+			{
+				FYnnkCountingMalloc::SetThreadCounter(&Context->Allocations);
+				Context->NumCountedGaps++;
+			}
+		});
+		Callbacks.OnComplete.BindLambda([Context](const FYnnkHttpResponse& Response)
+		{
+			FYnnkCountingMalloc::SetThreadCounter(nullptr);
+			Context->Response = Response;
+		});
+		HttpSubsystem->SendRequest(ReplayTestKeyword, TEXT("http://127.0.0.1/replayed"), ERequestMethod::Get, {}, FString(), EExpectedResponseType::StreamText, YnnkHttpTest::MakeOptions(), MoveTemp(Callbacks));
+	}
+}
+
+/**
+* Text stream chunks don't allocate memory in subsystem once scratch buffers reached their size.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkStreamChunkAllocationTest, "SimpleHttpClient.StreamBuffer.ReplayZeroAllocations", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkStreamChunkAllocationTest::RunTest(const FString& Parameters)
+{
+	UHTTPSubsystem* HttpSubsystem = YnnkHttpTest::GetSubsystem();
+	if (!TestNotNull(TEXT("HTTP subsystem"), HttpSubsystem))
+	{
+		return false;
+	}
+
+	FYnnkHttpRecording Recording;
+	Recording.Verb = TEXT("GET");
+	Recording.URL = TEXT("http://127.0.0.1/replayed");
+	Recording.RequestHash = TEXT("0000000000000000");
+	Recording.bHasResponse = true;
+	Recording.bSucceeded = true;
+	Recording.ResponseCode = 200;
+	Recording.ContentType = TEXT("text/event-stream");
+	for (const TArray<uint8>& Chunk : MakeStreamChunks())
+	{
+		Recording.AddChunk(0.0, Chunk.GetData(), Chunk.Num());
+	}
+	const FTCHARToUTF8 Done(TEXT("data: [DONE]\n\n"));
+	Recording.AddChunk(0.0, (const uint8*)Done.Get(), Done.Length());
+
+	const FString Directory = FPaths::ConvertRelativePathToFull(FPaths::AutomationTransientDir() / TEXT("SimpleHttpAllocationTest"));
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+	if (!TestTrue(TEXT("Recording saved"), YnnkHttpTest::SaveRecording(Directory, ReplayTestKeyword, Recording)))
+	{
+		return false;
+	}
+
+	FYnnkCountingMalloc::Install();
+	const YnnkHttpTest::FTransportState PrevTransport(HttpSubsystem);
+	HttpSubsystem->SetTransportMode(EYnnkHttpTransportMode::Replay, Directory);
+	HttpSubsystem->ReplaySpeed = 0.f;
+
+	// the first request grows scratch buffers of subsystem
+	const TSharedRef<FReplayAllocationContext> Context = MakeShared<FReplayAllocationContext>();
+	SendReplayedRequest(HttpSubsystem, Context, false);
+
+	const FString ExpectedText = MakeStreamText() + TEXT("data: [DONE]\n\n");
+	ADD_LATENT_AUTOMATION_COMMAND(FYnnkHttpWaitCommand(this, TEXT("warm-up replay"), 10.f, [Context]() { return Context->Response.IsSet(); }));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, HttpSubsystem, Context, ExpectedText]()
+	{
+		if (Context->Response.IsSet())
+		{
+			TestEqual(TEXT("Warm-up replay text"), Context->Text, ExpectedText);
+			SendReplayedRequest(HttpSubsystem, Context, true);
+		}
+		return true;
+	}));
+	ADD_LATENT_AUTOMATION_COMMAND(FYnnkHttpWaitCommand(this, TEXT("counted replay"), 10.f, [Context]() { return Context->Response.IsSet(); }));
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, HttpSubsystem, Context, PrevTransport, ExpectedText, Directory, NumRecorded = Recording.Chunks.Num()]()
+	{
+		FYnnkCountingMalloc::SetThreadCounter(nullptr);
+		PrevTransport.Restore(HttpSubsystem);
+		IFileManager::Get().DeleteDirectory(*Directory, false, true);
+
+		if (Context->Response.IsSet())
+		{
+			TestTrue(TEXT("Replayed response is ok"), Context->Response->IsOk());
+			TestEqual(TEXT("Replayed text"), Context->Text, ExpectedText);
+			TestTrue(TEXT("Chunks are broadcasted separately"), Context->NumCountedGaps > NumRecorded / 2);
+			TestEqual(TEXT("Allocations between stream chunks"), Context->Allocations.NumAllocations, (int64)0);
+		}
+		return true;
+	}));
+	return true;
+}
+
+#endif
@@ -0,0 +1,125 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkHttpTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && !UE_BUILD_SHIPPING
+
+#include "YnnkTextSegmenter.h"
+
+namespace
+{
+	/** Segments of text received in chunks of ChunkSize characters (the whole text if ChunkSize is 0) */
+	TArray<FString> SegmentText(const FString& Text, int32 MinLength, int32 MaxLength, int32 ChunkSize)
+	{
+		FYnnkSentenceSegmenter Segmenter(MinLength, MaxLength);
+		TArray<FString> Segments;
+		const int32 Step = ChunkSize > 0 ? ChunkSize : Text.Len();
+		for (int32 Offset = 0; Offset < Text.Len(); Offset += Step)
+		{
+			Segmenter.Append(FStringView(Text).Mid(Offset, Step), Segments);
+		}
+		Segmenter.Flush(Segments);
+		return Segments;
+	}
+
+	/** Segmenting doesn't depend on how text is split to chunks */
+	void TestSegments(FAutomationTestBase& Test, const FString& What, const FString& Text, int32 MinLength, int32 MaxLength, const TArray<FString>& Expected)
+	{
+		for (const int32 ChunkSize : { 0, 1, 2, 3, 7 })
+		{
+			const TArray<FString> Segments = SegmentText(Text, MinLength, MaxLength, ChunkSize);
+			if (!Test.TestTrue(*FString::Printf(TEXT("%s (chunks of %d)"), *What, ChunkSize), Segments == Expected))
+			{
+				Test.AddInfo(FString::Printf(TEXT("Segments: [%s]"), *FString::Join(Segments, TEXT("|"))));
+			}
+		}
+	}
+
+	FString MakeTokenStream()
+	{
+		return FString(TEXT("data: {\"choices\":[{\"delta\":{\"role\":\"assistant\"}}]}\r\n\r\n"))
+			+ TEXT("data: {\"choices\":[{\"delta\":{\"content\":\"Hello\"}}]}\n\n")
+			+ TEXT(": keep-alive\n\n")
+			+ TEXT("data:{\"choices\":[{\"delta\":{\"content\":\", \\u4E16\\u754C\"}}]}\r\n\r\n")
+			+ TEXT("data: {\"choices\":[{\"delta\":{},\"finish_reason\":\"stop\"}]}\n\n")
+			+ TEXT("data: [DONE]\n\n");
+	}
+}
+
+/**
+* Sentences are emitted as soon as they are complete, short ones are merged and long ones are split.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkSentenceSegmenterTest, "SimpleHttpClient.TextSegmenter.Sentences", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkSentenceSegmenterTest::RunTest(const FString& Parameters)
+{
+	// "3.50" isn't end of sentence, line break ends sentence
+	TestSegments(*this, TEXT("Sentences"), TEXT("Hello there. It costs 3.50 now! Short.\nOk."), 5, 200,
+		{ TEXT("Hello there."), TEXT("It costs 3.50 now!"), TEXT("Short."), TEXT("Ok.") });
+
+	TestSegments(*this, TEXT("Closing quote"), TEXT("He said \"Stop.\" Then he left. "), 5, 200,
+		{ TEXT("He said \"Stop.\""), TEXT("Then he left.") });
+
+	TestSegments(*this, TEXT("Short sentences are merged"), TEXT("Hi. Yes. This sentence is long enough. "), 20, 100,
+		{ TEXT("Hi. Yes. This sentence is long enough.") });
+
+	// clause punctuation is preferred to space
+	TestSegments(*this, TEXT("Long text is split"), TEXT("one two three, four five six seven eight"), 5, 20,
+		{ TEXT("one two three,"), TEXT("four five six"), TEXT("seven eight") });
+
+	TestSegments(*this, TEXT("Full-width punctuation"), TEXT("\u4F60\u597D\u3002\u4E16\u754C\uFF01"), 1, 100,
+		{ TEXT("\u4F60\u597D\u3002"), TEXT("\u4E16\u754C\uFF01") });
+
+	// segment is emitted before the end of text
+	FYnnkSentenceSegmenter Segmenter(5, 200);
+	TArray<FString> Segments;
+	Segmenter.Append(TEXT("First sentence. Second"), Segments);
+	TestTrue(TEXT("Completed sentence is emitted"), Segments == TArray<FString>({ TEXT("First sentence.") }));
+	Segmenter.Reset();
+	Segmenter.Append(TEXT("Next."), Segments);
+	Segmenter.Flush(Segments);
+	TestTrue(TEXT("Text is dropped by Reset"), Segments == TArray<FString>({ TEXT("First sentence."), TEXT("Next.") }));
+	return true;
+}
+
+/**
+* Tokens are read from server-sent events split at any character.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkStreamTokenReaderTest, "SimpleHttpClient.TextSegmenter.StreamTokens", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkStreamTokenReaderTest::RunTest(const FString& Parameters)
+{
+	const FString Stream = MakeTokenStream();
+	const FString Expected = TEXT("Hello, \u4E16\u754C");
+
+	FYnnkStreamTokenReader Reader(TEXT("choices[0].delta.content"));
+	for (int32 Split = 0; Split <= Stream.Len(); Split++)
+	{
+		FString Text;
+		Reader.Append(FStringView(Stream).Left(Split), Text);
+		Reader.Append(FStringView(Stream).RightChop(Split), Text);
+		if (!TestEqual(*FString::Printf(TEXT("Tokens of stream split at %d"), Split), Text, Expected))
+		{
+			break;
+		}
+	}
+
+	// incomplete line is waiting for the rest
+	FString Text;
+	Reader.Append(TEXT("data: {\"choices\":[{\"delta\":{\"content\":\"x\"}}]}"), Text);
+	TestTrue(TEXT("Incomplete event isn't read"), Text.IsEmpty());
+	Reader.Reset();
+	Reader.Append(TEXT("\n"), Text);
+	TestTrue(TEXT("Incomplete event is dropped by Reset"), Text.IsEmpty());
+
+	// without token path chunks are tokens
+	FYnnkStreamTokenReader PlainReader(FString());
+	Text.Reset();
+	PlainReader.Append(TEXT("data: plain"), Text);
+	PlainReader.Append(TEXT(" text"), Text);
+	TestEqual(TEXT("Chunks without token path"), Text, FString(TEXT("data: plain text")));
+	return true;
+}
+
+#endif
@@ -0,0 +1,178 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkHttpTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "YnnkUtf8Decoder.h"
+#include "YnnkHttpPrivate.h"
+
+namespace
+{
+	struct FCorpus
+	{
+		FString Name;
+		TArray<uint8> Bytes;
+		FString Expected;
+	};
+
+	void AddText(TArray<FCorpus>& Corpora, const TCHAR* Name, const FString& Text)
+	{
+		FTCHARToUTF8 Utf8(*Text);
+		FCorpus& Corpus = Corpora.AddDefaulted_GetRef();
+		Corpus.Name = Name;
+		Corpus.Bytes.Append((const uint8*)Utf8.Get(), Utf8.Length());
+		Corpus.Expected = Text;
+	}
+
+	void AddBytes(TArray<FCorpus>& Corpora, const TCHAR* Name, TArray<uint8> Bytes, const TCHAR* Expected)
+	{
+		FCorpus& Corpus = Corpora.AddDefaulted_GetRef();
+		Corpus.Name = Name;
+		Corpus.Bytes = MoveTemp(Bytes);
+		Corpus.Expected = Expected;
+	}
+
+	TArray<FCorpus> MakeCorpora()
+	{
+		TArray<FCorpus> Corpora;
+		AddText(Corpora, TEXT("ascii"), FString::ChrN(3, TCHAR('-')) +
+			TEXT("data: {\"choices\":[{\"delta\":{\"content\":\"The traveller asks about the road to the old mill.\"}}]}\n\n"));
+		AddText(Corpora, TEXT("cyrillic"), TEXT("\u041F\u0440\u0438\u0432\u0435\u0442, \u043C\u0438\u0440! \u041A\u0430\u043A \u0434\u0435\u043B\u0430?"));
+		AddText(Corpora, TEXT("cjk"), TEXT("\u4F60\u597D\u4E16\u754C\u3002\u3053\u3093\u306B\u3061\u306F\u3001\u4E16\u754C\uFF01"));
+		AddText(Corpora, TEXT("emoji"), TEXT("Hi \U0001F600\U0001F680 ok \U0001F44D\U0001F3FD!"));
+		AddText(Corpora, TEXT("sse_mixed"),
+			TEXT("data: {\"choices\":[{\"delta\":{\"content\":\"Caf\u00E9 \u2014 \u041C\u0438\u0440 \u4E16\u754C \U0001F600 and a long ASCII tail to hit the vector path\"}}]}\n\n")
+			TEXT("data: [DONE]\n\n"));
+
+		AddBytes(Corpora, TEXT("overlong"), { 0xC0, 0xAF, 'a', 0xE0, 0x80, 0xAF, 'b' }, TEXT("\uFFFD\uFFFDa\uFFFD\uFFFD\uFFFDb"));
+		AddBytes(Corpora, TEXT("surrogate"), { 0xED, 0xA0, 0x80, 'c' }, TEXT("\uFFFD\uFFFD\uFFFDc"));
+		AddBytes(Corpora, TEXT("truncated"), { 'd', 0xF0, 0x9F, 0x98, 'e', 0xE2, 0x82 }, TEXT("d\uFFFDe\uFFFD"));
+		AddBytes(Corpora, TEXT("out_of_range"), { 0xF5, 'f', 0xF4, 0x90, 0x80, 0x80, 0xFF }, TEXT("\uFFFDf\uFFFD\uFFFD\uFFFD\uFFFD\uFFFD"));
+		AddBytes(Corpora, TEXT("lone_continuation"), { 0x80, 'g', 0xBF, 0xC2, 0xA9 }, TEXT("\uFFFDg\uFFFD\u00A9"));
+		return Corpora;
+	}
+
+	/** Decode chunks ending at SplitPoints, then the rest */
+	FString DecodeSplit(const TArray<uint8>& Bytes, TArrayView<const int32> SplitPoints)
+	{
+		FYnnkUtf8StreamDecoder Decoder;
+		FString Result, Chunk;
+		int32 Start = 0;
+		for (int32 SplitPoint : SplitPoints)
+		{
+			Decoder.Decode(Bytes.GetData() + Start, SplitPoint - Start, Chunk);
+			Result += Chunk;
+			Start = SplitPoint;
+		}
+		Decoder.Decode(Bytes.GetData() + Start, Bytes.Num() - Start, Chunk);
+		Result += Chunk;
+		if (Decoder.Flush(Chunk))
+		{
+			Result += Chunk;
+		}
+		return Result;
+	}
+
+	/** Returns description of the first mismatch or empty string */
+	FString CheckCorpus(const FCorpus& Corpus)
+	{
+		const FString Whole = DecodeSplit(Corpus.Bytes, {});
+		if (Whole != Corpus.Expected)
+		{
+			return FString::Printf(TEXT("%s decoded as \"%s\""), *Corpus.Name, *Whole);
+		}
+
+		for (int32 SplitPoint = 1; SplitPoint < Corpus.Bytes.Num(); SplitPoint++)
+		{
+			const FString Result = DecodeSplit(Corpus.Bytes, { SplitPoint });
+			if (Result != Corpus.Expected)
+			{
+				return FString::Printf(TEXT("%s split at %d decoded as \"%s\""), *Corpus.Name, SplitPoint, *Result);
+			}
+
+			// skipped chunk must leave the decoder in the same state
+			FYnnkUtf8StreamDecoder Decoded, Skipped;
+			FString First, Second, SecondAfterSkip;
+			Decoded.Decode(Corpus.Bytes.GetData(), SplitPoint, First);
+			Decoded.Decode(Corpus.Bytes.GetData() + SplitPoint, Corpus.Bytes.Num() - SplitPoint, Second);
+			Skipped.Skip(Corpus.Bytes.GetData(), SplitPoint);
+			Skipped.Decode(Corpus.Bytes.GetData() + SplitPoint, Corpus.Bytes.Num() - SplitPoint, SecondAfterSkip);
+			if (Second != SecondAfterSkip)
+			{
+				return FString::Printf(TEXT("%s skipped at %d decoded as \"%s\""), *Corpus.Name, SplitPoint, *SecondAfterSkip);
+			}
+		}
+
+		TArray<int32> EveryByte;
+		for (int32 SplitPoint = 1; SplitPoint < Corpus.Bytes.Num(); SplitPoint++)
+		{
+			EveryByte.Add(SplitPoint);
+		}
+		const FString ByteByByte = DecodeSplit(Corpus.Bytes, EveryByte);
+		if (ByteByByte != Corpus.Expected)
+		{
+			return FString::Printf(TEXT("%s byte by byte decoded as \"%s\""), *Corpus.Name, *ByteByByte);
+		}
+		return FString();
+	}
+
+	/** Decoding speed compared to stateless conversion used before */
+	FString Benchmark(const TCHAR* Name, const FString& Text)
+	{
+		FTCHARToUTF8 Utf8(*Text);
+		const uint8* Data = (const uint8*)Utf8.Get();
+		const int32 Size = Utf8.Length();
+		constexpr int32 NumIterations = 20;
+
+		FString Output;
+		FYnnkUtf8StreamDecoder Decoder;
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < NumIterations; Iteration++)
+		{
+			Decoder.Decode(Data, Size, Output);
+		}
+		const double DecoderTime = FPlatformTime::Seconds() - StartTime;
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < NumIterations; Iteration++)
+		{
+			YnnkHttp::Utf8ToString(Output, Data, Size);
+		}
+		const double ConvertTime = FPlatformTime::Seconds() - StartTime;
+
+		const double Megabytes = (double)Size * NumIterations / (1024.0 * 1024.0);
+		return FString::Printf(TEXT("%s %.0f MB/s (stateless conversion %.0f MB/s)"),
+			Name, Megabytes / FMath::Max(DecoderTime, 1e-9), Megabytes / FMath::Max(ConvertTime, 1e-9));
+	}
+}
+
+/**
+* Every corpus is decoded whole, split at every byte boundary and byte by byte.
+*/
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkUtf8DecoderTest, "SimpleHttpClient.Utf8Decoder.Corpora", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkUtf8DecoderTest::RunTest(const FString& Parameters)
+{
+	for (const FCorpus& Corpus : MakeCorpora())
+	{
+		const FString Error = CheckCorpus(Corpus);
+		if (!Error.IsEmpty())
+		{
+			AddError(Error);
+		}
+	}
+
+	FString Ascii, Mixed;
+	for (int32 Index = 0; Index < 8192; Index++)
+	{
+		Ascii += TEXT("data: {\"choices\":[{\"delta\":{\"content\":\"road\"}}]}\n\n");
+		Mixed += TEXT("data: {\"content\":\"\u041C\u0438\u0440 \u4E16\u754C road\"}\n\n");
+	}
+	AddInfo(Benchmark(TEXT("ascii"), Ascii));
+	AddInfo(Benchmark(TEXT("mixed"), Mixed));
+	return true;
+}
+
+#endif
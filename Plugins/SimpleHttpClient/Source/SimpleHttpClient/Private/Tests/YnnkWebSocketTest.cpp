@@ -0,0 +1,138 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkHttpTestHelpers.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && !UE_BUILD_SHIPPING
+
+#include "YnnkHttpLoopbackServer.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+	static const FName WebSocketEchoKeyword = TEXT("SimpleHttpWebSocketEcho");
+
+	/** Round trip of text and binary messages through loopback WebSocket echo server */
+	struct FWebSocketEchoContext
+	{
+		FYnnkHttpLoopbackServer Server;
+		int32 NumMessages = 0;
+		FString TextMessage;
+		TArray<uint8> DataMessage;
+		double StartTime = 0.0;
+		FDelegateHandle TextHandle;
+		FDelegateHandle DataHandle;
+
+		FCriticalSection Lock;
+		int32 NumReceived = 0;
+		int32 NumMismatched = 0;
+
+		void OnReceived(bool bMatched)
+		{
+			FScopeLock ScopeLock(&Lock);
+			NumReceived++;
+			NumMismatched += !bMatched;
+		}
+
+		int32 GetNumReceived()
+		{
+			FScopeLock ScopeLock(&Lock);
+			return NumReceived;
+		}
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FYnnkWebSocketEchoTest, "SimpleHttpClient.WebSocket.Echo", YNNK_HTTP_TEST_FLAGS)
+
+bool FYnnkWebSocketEchoTest::RunTest(const FString& Parameters)
+{
+	UHTTPSubsystem* HttpSubsystem = YnnkHttpTest::GetSubsystem();
+	if (!TestNotNull(TEXT("HTTP subsystem"), HttpSubsystem))
+	{
+		return false;
+	}
+
+	const TSharedRef<FWebSocketEchoContext, ESPMode::ThreadSafe> Context = MakeShared<FWebSocketEchoContext, ESPMode::ThreadSafe>();
+	Context->Server.AddDefaultRoutes();
+	if (!TestTrue(TEXT("Loopback server started"), Context->Server.Start()))
+	{
+		return false;
+	}
+
+	// even messages are text, odd messages are binary; echo must keep both type and content
+	const int32 MessageSize = 256;
+	Context->NumMessages = 1000;
+	Context->TextMessage = FString::ChrN(MessageSize, TEXT('a'));
+	Context->DataMessage.SetNumUninitialized(MessageSize);
+	for (int32 Index = 0; Index < Context->DataMessage.Num(); Index++)
+	{
+		Context->DataMessage[Index] = (uint8)Index;
+	}
+
+	const TWeakPtr<FWebSocketEchoContext, ESPMode::ThreadSafe> WeakContext = Context;
+	Context->TextHandle = HttpSubsystem->OnTextStreamChunk.AddLambda([WeakContext](FName RequestName, FStringView Text)
+	{
+		const TSharedPtr<FWebSocketEchoContext, ESPMode::ThreadSafe> PinnedContext = WeakContext.Pin();
+		if (RequestName == WebSocketEchoKeyword && PinnedContext.IsValid())
+		{
+			PinnedContext->OnReceived(Text == PinnedContext->TextMessage);
+		}
+	});
+	Context->DataHandle = HttpSubsystem->OnDataStreamChunk.AddLambda([WeakContext](FName RequestName, TArrayView<const uint8> Data)
+	{
+		const TSharedPtr<FWebSocketEchoContext, ESPMode::ThreadSafe> PinnedContext = WeakContext.Pin();
+		if (RequestName == WebSocketEchoKeyword && PinnedContext.IsValid())
+		{
+			const TArray<uint8>& Expected = PinnedContext->DataMessage;
+			PinnedContext->OnReceived(Data.Num() == Expected.Num() && FMemory::Memcmp(Data.GetData(), Expected.GetData(), Data.Num()) == 0);
+		}
+	});
+
+	FYnnkWebSocketOptions Options;
+	Options.MaxQueuedBytes = FMath::Max(Options.MaxQueuedBytes, Context->NumMessages * MessageSize * 2);
+	const bool bOpened = HttpSubsystem->OpenWebSocket(WebSocketEchoKeyword, Context->Server.GetWebSocketUrl(TEXT("/ws")), TArray<FYnnkUrlParameter>(), Options);
+	if (TestTrue(TEXT("WebSocket opened"), bOpened))
+	{
+		// messages are queued until connection
+		Context->StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Context->NumMessages; Index++)
+		{
+			if (Index % 2 == 0)
+			{
+				HttpSubsystem->SendWebSocketText(WebSocketEchoKeyword, Context->TextMessage);
+			}
+			else
+			{
+				HttpSubsystem->SendWebSocketData(WebSocketEchoKeyword, Context->DataMessage);
+			}
+		}
+		ADD_LATENT_AUTOMATION_COMMAND(FYnnkHttpWaitCommand(this, TEXT("WebSocket echo"), 30.f, [Context]() { return Context->GetNumReceived() >= Context->NumMessages; }));
+	}
+
+	// listeners can't be removed while they're executed, so they're removed in latent command
+	const TWeakObjectPtr<UHTTPSubsystem> WeakSubsystem = HttpSubsystem;
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, Context, WeakSubsystem, bOpened]()
+	{
+		if (UHTTPSubsystem* Subsystem = WeakSubsystem.Get())
+		{
+			Subsystem->OnTextStreamChunk.Remove(Context->TextHandle);
+			Subsystem->OnDataStreamChunk.Remove(Context->DataHandle);
+			Subsystem->CloseWebSocket(WebSocketEchoKeyword);
+		}
+		Context->Server.Shutdown();
+
+		if (bOpened)
+		{
+			FScopeLock ScopeLock(&Context->Lock);
+			TestEqual(TEXT("Received messages"), Context->NumReceived, Context->NumMessages);
+			TestEqual(TEXT("Mismatched messages"), Context->NumMismatched, 0);
+
+			const double Time = FPlatformTime::Seconds() - Context->StartTime;
+			AddInfo(FString::Printf(TEXT("WebSocket echo: %d messages in %.3f s (%.1f msg/s)"), Context->NumReceived, Time, Context->NumReceived / FMath::Max(Time, 0.000001)));
+		}
+		return true;
+	}));
+	return true;
+}
+
+#endif
@@ -0,0 +1,257 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkConversation.h"
+#include "YnnkHttpPrivate.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace
+{
+	void AppendAscii(TArray<uint8>& Data, const ANSICHAR* Text)
+	{
+		Data.Append((const uint8*)Text, FCStringAnsi::Strlen(Text));
+	}
+
+	/** Append quoted json string. Only ASCII bytes are escaped, so UTF-8 sequences are copied as is. */
+	void AppendJsonString(TArray<uint8>& Data, const FString& Value)
+	{
+		const FTCHARToUTF8 Utf8(*Value);
+		const uint8* Src = (const uint8*)Utf8.Get();
+		const int32 Size = Utf8.Length();
+
+		Data.Reserve(Data.Num() + Size + 2);
+		Data.Add('"');
+		int32 RunStart = 0;
+		for (int32 Index = 0; Index < Size; Index++)
+		{
+			const uint8 Char = Src[Index];
+			if (Char >= 0x20 && Char != '"' && Char != '\\')
+			{
+				continue;
+			}
+			Data.Append(Src + RunStart, Index - RunStart);
+			RunStart = Index + 1;
+			switch (Char)
+			{
+				case '"': AppendAscii(Data, "\\\""); break;
+				case '\\': AppendAscii(Data, "\\\\"); break;
+				case '\n': AppendAscii(Data, "\\n"); break;
+				case '\r': AppendAscii(Data, "\\r"); break;
+				case '\t': AppendAscii(Data, "\\t"); break;
+				case '\b': AppendAscii(Data, "\\b"); break;
+				case '\f': AppendAscii(Data, "\\f"); break;
+				default:
+				{
+					static const ANSICHAR* HexDigits = "0123456789abcdef";
+					const ANSICHAR Escaped[] = { '\\', 'u', '0', '0', HexDigits[Char >> 4], HexDigits[Char & 0xF], 0 };
+					AppendAscii(Data, Escaped);
+				}
+			}
+		}
+		Data.Append(Src + RunStart, Size - RunStart);
+		Data.Add('"');
+	}
+}
+
+UYnnkConversation* UYnnkConversation::CreateConversation(const FJsonItem& RequestTemplate, int32 InTokenBudget, const FString& InMessagesField)
+{
+	UYnnkConversation* Conversation = NewObject<UYnnkConversation>();
+	Conversation->TokenBudget = InTokenBudget;
+	Conversation->MessagesField = InMessagesField.IsEmpty() ? TEXT("messages") : InMessagesField;
+	Conversation->SetRequestTemplate(RequestTemplate);
+	return Conversation;
+}
+
+bool UYnnkConversation::SetRequestTemplate(const FJsonItem& RequestTemplate)
+{
+	BodyPrefix.Reset();
+	AppendAscii(BodyPrefix, "{");
+
+	bool bSuccess = true;
+	const FString TemplateString = RequestTemplate.AsString();
+	if (!TemplateString.TrimStartAndEnd().IsEmpty())
+	{
+		TSharedPtr<FJsonObject> JsonObject;
+		const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(TemplateString);
+		if (FJsonSerializer::Deserialize(Reader, JsonObject) && JsonObject.IsValid())
+		{
+			// parsed once, so messages can be appended to serialized fields
+			JsonObject->RemoveField(MessagesField);
+			FString Fields;
+			const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Fields);
+			FJsonSerializer::Serialize(JsonObject.ToSharedRef(), Writer);
+
+			// strip brackets of the object
+			Fields.TrimStartAndEndInline();
+			if (Fields.Len() > 2)
+			{
+				const FTCHARToUTF8 Utf8(*Fields.Mid(1, Fields.Len() - 2));
+				BodyPrefix.Append((const uint8*)Utf8.Get(), Utf8.Length());
+				AppendAscii(BodyPrefix, ",");
+			}
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("UYnnkConversation: request template isn't a valid json object"));
+			bSuccess = false;
+		}
+	}
+
+	AppendJsonString(BodyPrefix, MessagesField);
+	AppendAscii(BodyPrefix, ":[");
+	return bSuccess;
+}
+
+void UYnnkConversation::AddMessage(const FString& Role, const FString& Content, bool bPinned)
+{
+	TArray<uint8> Message;
+	Message.Reserve(Content.Len() + Role.Len() + 32);
+	AppendAscii(Message, "{\"role\":");
+	AppendJsonString(Message, Role);
+	AppendAscii(Message, ",\"content\":");
+	AppendJsonString(Message, Content);
+	AppendAscii(Message, "}");
+	AppendMessage(Message.GetData(), Message.Num(), bPinned);
+}
+
+bool UYnnkConversation::AddMessageJson(const FJsonItem& Message, bool bPinned)
+{
+	const FString Json = Message.AsString().TrimStartAndEnd();
+	if (!Json.StartsWith(TEXT("{")) || !Json.EndsWith(TEXT("}")))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("UYnnkConversation: message isn't a json object"));
+		return false;
+	}
+	const FTCHARToUTF8 Utf8(*Json);
+	AppendMessage((const uint8*)Utf8.Get(), Utf8.Length(), bPinned);
+	return true;
+}
+
+void UYnnkConversation::AppendMessage(const uint8* Data, int32 Size, bool bPinned)
+{
+	if (bPinned)
+	{
+		if (NumPinned > 0)
+		{
+			PinnedData.Add(',');
+		}
+		PinnedData.Append(Data, Size);
+		NumPinned++;
+		return;
+	}
+
+	FMessage& NewMessage = Messages.AddDefaulted_GetRef();
+	NewMessage.Offset = MessageData.Num();
+	NewMessage.Size = Size;
+	NewMessage.BytesBefore = Messages.Num() > 1 ? Messages.Last(1).BytesBefore + Messages.Last(1).Size : 0;
+	MessageData.Append(Data, Size);
+}
+
+bool UYnnkConversation::RemoveLastMessage()
+{
+	if (Messages.Num() == 0)
+	{
+		return false;
+	}
+	MessageData.SetNum(Messages.Last().Offset, YNNK_NO_SHRINK);
+	Messages.Pop(YNNK_NO_SHRINK);
+	return true;
+}
+
+void UYnnkConversation::ClearMessages(bool bRemovePinned)
+{
+	Messages.Reset();
+	MessageData.Reset();
+	if (bRemovePinned)
+	{
+		PinnedData.Reset();
+		NumPinned = 0;
+	}
+}
+
+int32 UYnnkConversation::EstimateTokens(int64 Bytes) const
+{
+	return FMath::CeilToInt(Bytes / FMath::Max(BytesPerToken, 1.f));
+}
+
+int32 UYnnkConversation::GetFirstIncludedMessage() const
+{
+	if (TokenBudget <= 0 || Messages.Num() == 0)
+	{
+		return 0;
+	}
+
+	const FMessage& Last = Messages.Last();
+	const int64 TotalBytes = Last.BytesBefore + Last.Size;
+	const int64 BudgetBytes = (int64)(TokenBudget * FMath::Max(BytesPerToken, 1.f)) - PinnedData.Num();
+
+	// the first message which leaves the rest within budget; BytesBefore is sorted
+	int32 Low = 0;
+	int32 High = Messages.Num() - 1;
+	while (Low < High)
+	{
+		const int32 Middle = (Low + High) / 2;
+		if (TotalBytes - Messages[Middle].BytesBefore <= BudgetBytes)
+		{
+			High = Middle;
+		}
+		else
+		{
+			Low = Middle + 1;
+		}
+	}
+	return Low;
+}
+
+int32 UYnnkConversation::GetNumTruncatedMessages() const
+{
+	return GetFirstIncludedMessage();
+}
+
+int32 UYnnkConversation::GetEstimatedTokens() const
+{
+	int64 Bytes = PinnedData.Num();
+	if (Messages.Num() > 0)
+	{
+		Bytes += MessageData.Num() - Messages[GetFirstIncludedMessage()].Offset;
+	}
+	return EstimateTokens(Bytes);
+}
+
+void UYnnkConversation::BuildRequestBody(TArray<uint8>& OutData) const
+{
+	const int32 FirstMessage = GetFirstIncludedMessage();
+	const int32 NumMessages = Messages.Num() - FirstMessage;
+
+	OutData.Reset(BodyPrefix.Num() + PinnedData.Num() + (MessageData.Num() - (NumMessages > 0 ? Messages[FirstMessage].Offset : 0)) + NumMessages + 3);
+	OutData.Append(BodyPrefix);
+	OutData.Append(PinnedData);
+	for (int32 Index = FirstMessage; Index < Messages.Num(); Index++)
+	{
+		if (Index > FirstMessage || NumPinned > 0)
+		{
+			OutData.Add(',');
+		}
+		OutData.Append(MessageData.GetData() + Messages[Index].Offset, Messages[Index].Size);
+	}
+	AppendAscii(OutData, "]}");
+}
+
+FString UYnnkConversation::GetRequestBody() const
+{
+	TArray<uint8> Data;
+	BuildRequestBody(Data);
+	FString Body;
+	YnnkHttp::Utf8ToString(Body, Data.GetData(), Data.Num());
+	return Body;
+}
+
+TArray<uint8> UYnnkConversation::GetRequestBodyData() const
+{
+	TArray<uint8> Data;
+	BuildRequestBody(Data);
+	return Data;
+}
@@ -0,0 +1,144 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/MemoryBase.h"
+
+#if !UE_BUILD_SHIPPING
+
+/**
+* Allocations counted for threads which set it with FYnnkCountingMalloc::SetThreadCounter
+*/
+struct FYnnkAllocationCounter
+{
+	int64 NumAllocations = 0;
+	int64 AllocatedSize = 0;
+};
+
+/**
+* Forwards to the real allocator and counts allocations of threads which have a counter.
+* Installed to GMalloc once and never removed, so threads which already read GMalloc
+* can't call a destroyed allocator. Other threads only pay for reading a thread-local pointer.
+*/
+class FYnnkCountingMalloc final : public FMalloc
+{
+public:
+	/** Wrap GMalloc. Called in game thread before the first counter is set. */
+	static void Install()
+	{
+		check(IsInGameThread());
+		// intentionally leaked: allocator must stay valid until exit
+		static FYnnkCountingMalloc* Instance = nullptr;
+		if (!Instance)
+		{
+			Instance = new FYnnkCountingMalloc(GMalloc);
+			GMalloc = Instance;
+		}
+	}
+
+	/** Count allocations of the current thread to Counter, nullptr to stop. Returns previous counter of the thread. */
+	static FYnnkAllocationCounter* SetThreadCounter(FYnnkAllocationCounter* Counter)
+	{
+		FYnnkAllocationCounter* Prev = ThreadCounter;
+		ThreadCounter = Counter;
+		return Prev;
+	}
+
+	virtual void* Malloc(SIZE_T Size, uint32 Alignment) override
+	{
+		AddAllocation(Size);
+		return Inner->Malloc(Size, Alignment);
+	}
+	virtual void* TryMalloc(SIZE_T Size, uint32 Alignment) override
+	{
+		AddAllocation(Size);
+		return Inner->TryMalloc(Size, Alignment);
+	}
+	virtual void* Realloc(void* Original, SIZE_T Size, uint32 Alignment) override
+	{
+		if (Size > 0)
+		{
+			AddAllocation(Size);
+		}
+		return Inner->Realloc(Original, Size, Alignment);
+	}
+	virtual void Free(void* Original) override
+	{
+		Inner->Free(Original);
+	}
+	virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override
+	{
+		return Inner->QuantizeSize(Count, Alignment);
+	}
+	virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+	{
+		return Inner->GetAllocationSize(Original, SizeOut);
+	}
+	virtual void Trim(bool bTrimThreadCaches) override
+	{
+		Inner->Trim(bTrimThreadCaches);
+	}
+	virtual void SetupTLSCachesOnCurrentThread() override
+	{
+		Inner->SetupTLSCachesOnCurrentThread();
+	}
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+	{
+		Inner->ClearAndDisableTLSCachesOnCurrentThread();
+	}
+	virtual bool IsInternallyThreadSafe() const override
+	{
+		return Inner->IsInternallyThreadSafe();
+	}
+	virtual bool ValidateHeap() override
+	{
+		return Inner->ValidateHeap();
+	}
+	virtual const TCHAR* GetDescriptiveName() override
+	{
+		return TEXT("YnnkCountingMalloc");
+	}
+
+private:
+	FYnnkCountingMalloc(FMalloc* InInner)
+		: Inner(InInner)
+	{}
+
+	void AddAllocation(SIZE_T Size)
+	{
+		if (FYnnkAllocationCounter* Counter = ThreadCounter)
+		{
+			Counter->NumAllocations++;
+			Counter->AllocatedSize += Size;
+		}
+	}
+
+	static inline thread_local FYnnkAllocationCounter* ThreadCounter = nullptr;
+
+	FMalloc* Inner;
+};
+
+/**
+* Counts allocations of the current thread while in scope
+*/
+class FYnnkAllocationScope
+{
+public:
+	explicit FYnnkAllocationScope(FYnnkAllocationCounter& Counter)
+	{
+		FYnnkCountingMalloc::Install();
+		Prev = FYnnkCountingMalloc::SetThreadCounter(&Counter);
+	}
+
+	~FYnnkAllocationScope()
+	{
+		FYnnkCountingMalloc::SetThreadCounter(Prev);
+	}
+
+private:
+	FYnnkAllocationCounter* Prev = nullptr;
+};
+
+#endif
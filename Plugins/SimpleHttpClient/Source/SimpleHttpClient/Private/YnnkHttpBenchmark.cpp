@@ -0,0 +1,518 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkHttpBenchmark.h"
+
+#if !UE_BUILD_SHIPPING
+
+#include "HTTPSubsystem.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/DateTime.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/Parse.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+
+// scenario is aborted if no request is finished in this time (seconds)
+constexpr double BenchmarkStallTimeout = 30.0;
+
+static const FName BenchmarkKeyword = TEXT("SimpleHttpBenchmark");
+
+namespace
+{
+	float GetPercentile(TArray<float>& Values, float Percentile)
+	{
+		if (Values.Num() == 0)
+		{
+			return 0.f;
+		}
+		Values.Sort();
+		const int32 Index = FMath::Clamp(FMath::RoundToInt(Percentile * (Values.Num() - 1)), 0, Values.Num() - 1);
+		return Values[Index];
+	}
+}
+
+FYnnkHttpBenchmark::FYnnkHttpBenchmark(UHTTPSubsystem* InSubsystem)
+	: Subsystem(InSubsystem)
+{
+	Server.AddDefaultRoutes();
+}
+
+FYnnkHttpBenchmark::~FYnnkHttpBenchmark()
+{
+	Cancel();
+}
+
+TArray<FYnnkHttpBenchmarkScenario> FYnnkHttpBenchmark::GetDefaultScenarios(int32 NumRequests)
+{
+	TArray<FYnnkHttpBenchmarkScenario> Result;
+	for (const int32 Concurrency : { 1, 16, 128 })
+	{
+		FYnnkHttpBenchmarkScenario Scenario;
+		Scenario.Concurrency = Concurrency;
+		Scenario.NumRequests = FMath::Max(NumRequests, Concurrency);
+
+		Scenario.Name = FString::Printf(TEXT("fixed_1k_c%d"), Concurrency);
+		Scenario.Path = TEXT("/fixed?size=1024");
+		Scenario.ResponseType = EExpectedResponseType::Text;
+		Result.Add(Scenario);
+
+		Scenario.Name = FString::Printf(TEXT("chunked_64k_c%d"), Concurrency);
+		Scenario.Path = TEXT("/chunked?size=65536&chunk=4096");
+		Scenario.ResponseType = EExpectedResponseType::StreamData;
+		Result.Add(Scenario);
+
+		Scenario.Name = FString::Printf(TEXT("sse_c%d"), Concurrency);
+		Scenario.Path = TEXT("/sse?size=2048&chunk=96&interval=0.005");
+		Scenario.ResponseType = EExpectedResponseType::StreamText;
+		Result.Add(Scenario);
+	}
+	return Result;
+}
+
+bool FYnnkHttpBenchmark::LoadScenarios(const FString& FileName, TArray<FYnnkHttpBenchmarkScenario>& OutScenarios)
+{
+	FString Content;
+	if (!FFileHelper::LoadFileToString(Content, *FileName))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SimpleHttp benchmark: unable to read %s"), *FileName);
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> Root;
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Content);
+	const TArray<TSharedPtr<FJsonValue>>* Items = nullptr;
+	if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid() || !Root->TryGetArrayField(TEXT("scenarios"), Items))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("SimpleHttp benchmark: %s doesn't contain scenarios array"), *FileName);
+		return false;
+	}
+
+	const UEnum* ResponseTypeEnum = StaticEnum<EExpectedResponseType>();
+	for (const TSharedPtr<FJsonValue>& Item : *Items)
+	{
+		const TSharedPtr<FJsonObject> Object = Item->AsObject();
+		if (!Object.IsValid())
+		{
+			continue;
+		}
+
+		FYnnkHttpBenchmarkScenario& Scenario = OutScenarios.AddDefaulted_GetRef();
+		Scenario.Name = FString::Printf(TEXT("scenario_%d"), OutScenarios.Num());
+		Object->TryGetStringField(TEXT("name"), Scenario.Name);
+		Object->TryGetStringField(TEXT("path"), Scenario.Path);
+		Object->TryGetStringField(TEXT("url"), Scenario.URL);
+		Object->TryGetNumberField(TEXT("concurrency"), Scenario.Concurrency);
+		Object->TryGetNumberField(TEXT("requests"), Scenario.NumRequests);
+		Object->TryGetNumberField(TEXT("rate"), Scenario.RequestsPerSecond);
+		Object->TryGetNumberField(TEXT("duration"), Scenario.Duration);
+		Scenario.Concurrency = FMath::Max(Scenario.Concurrency, 1);
+
+		FString Verb;
+		if (Object->TryGetStringField(TEXT("verb"), Verb))
+		{
+			Scenario.Verb = Verb.Equals(TEXT("POST"), ESearchCase::IgnoreCase) ? ERequestMethod::Post : ERequestMethod::Get;
+		}
+
+		FString ResponseType;
+		if (Object->TryGetStringField(TEXT("response"), ResponseType))
+		{
+			const int64 Value = ResponseTypeEnum->GetValueByNameString(ResponseType);
+			if (Value == INDEX_NONE)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("SimpleHttp benchmark: unknown response type %s in scenario %s"), *ResponseType, *Scenario.Name);
+			}
+			else
+			{
+				Scenario.ResponseType = (EExpectedResponseType)Value;
+			}
+		}
+
+		const TSharedPtr<FJsonObject>* Headers = nullptr;
+		if (Object->TryGetObjectField(TEXT("headers"), Headers))
+		{
+			for (const auto& Header : (*Headers)->Values)
+			{
+				Scenario.HeaderParams.Add(FYnnkUrlParameter(Header.Key, Header.Value->AsString()));
+			}
+		}
+
+		// body can be written as json object
+		const TSharedPtr<FJsonObject>* BodyObject = nullptr;
+		if (Object->TryGetObjectField(TEXT("body"), BodyObject))
+		{
+			const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Scenario.Body);
+			FJsonSerializer::Serialize(BodyObject->ToSharedRef(), Writer);
+		}
+		else
+		{
+			Object->TryGetStringField(TEXT("body"), Scenario.Body);
+		}
+
+		if (Scenario.Path.IsEmpty() && Scenario.URL.IsEmpty())
+		{
+			Scenario.Path = TEXT("/fixed");
+		}
+	}
+	return OutScenarios.Num() > 0;
+}
+
+bool FYnnkHttpBenchmark::Start(const TArray<FYnnkHttpBenchmarkScenario>& InScenarios, FOnBenchmarkFinished InOnFinished)
+{
+	if (IsRunning() || !Subsystem.IsValid() || InScenarios.Num() == 0)
+	{
+		return false;
+	}
+	if (!Server.Start())
+	{
+		return false;
+	}
+
+	Scenarios = InScenarios;
+	Results.Reset();
+	OnFinished = InOnFinished;
+	ScenarioIndex = INDEX_NONE;
+
+	bPrevCollectMetrics = Subsystem->bCollectMetrics;
+	Subsystem->bCollectMetrics = true;
+	MetricsHandle = Subsystem->OnMetricsRecorded.AddSP(this, &FYnnkHttpBenchmark::OnMetricsRecorded);
+	TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FYnnkHttpBenchmark::Tick));
+
+	FinishScenario();
+	return true;
+}
+
+void FYnnkHttpBenchmark::Cancel()
+{
+	if (TickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+		TickerHandle.Reset();
+	}
+	if (Subsystem.IsValid() && MetricsHandle.IsValid())
+	{
+		Subsystem->OnMetricsRecorded.Remove(MetricsHandle);
+		Subsystem->bCollectMetrics = bPrevCollectMetrics;
+	}
+	MetricsHandle.Reset();
+	Server.Shutdown();
+}
+
+void FYnnkHttpBenchmark::StartScenario()
+{
+	const FYnnkHttpBenchmarkScenario& Scenario = Scenarios[ScenarioIndex];
+	const FString Load = Scenario.RequestsPerSecond > 0.f
+		? FString::Printf(TEXT("%.1f requests/s"), Scenario.RequestsPerSecond)
+		: FString::Printf(TEXT("concurrency %d"), Scenario.Concurrency);
+	if (Scenario.Duration > 0.f)
+	{
+		UE_LOG(LogTemp, Log, TEXT("SimpleHttp benchmark: %s (%.1f s, %s)"), *Scenario.Name, Scenario.Duration, *Load);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Log, TEXT("SimpleHttp benchmark: %s (%d requests, %s)"), *Scenario.Name, Scenario.NumRequests, *Load);
+	}
+
+	ScenarioUrl = Scenario.GetUrl(Server);
+	Latencies.Reset(Scenario.Duration > 0.f ? 0 : Scenario.NumRequests);
+	FirstChunkTimes.Reset(Scenario.Duration > 0.f ? 0 : Scenario.NumRequests);
+	NumSent = 0;
+	NumFinished = 0;
+	NumFailed = 0;
+	ErrorsByCode.Reset();
+
+	MemoryBefore = FPlatformMemory::GetStats().UsedPhysical;
+	PeakMemory = MemoryBefore;
+	InFlightMemory = MemoryBefore;
+	MaxInFlight = 0;
+	StartTime = FPlatformTime::Seconds();
+	LastActivityTime = StartTime;
+	NextSendTime = StartTime;
+
+	SendPendingRequests();
+}
+
+void FYnnkHttpBenchmark::SampleMemory()
+{
+	const uint64 UsedMemory = FPlatformMemory::GetStats().UsedPhysical;
+	PeakMemory = FMath::Max(PeakMemory, UsedMemory);
+
+	// requests just sent haven't allocated their responses yet, so samples of later ticks are used too
+	const int32 InFlight = NumSent - NumFinished;
+	if (InFlight > MaxInFlight)
+	{
+		MaxInFlight = InFlight;
+		InFlightMemory = UsedMemory;
+	}
+	else if (InFlight == MaxInFlight)
+	{
+		InFlightMemory = FMath::Max(InFlightMemory, UsedMemory);
+	}
+}
+
+bool FYnnkHttpBenchmark::IsSendingFinished() const
+{
+	const FYnnkHttpBenchmarkScenario& Scenario = Scenarios[ScenarioIndex];
+	return Scenario.Duration > 0.f
+		? FPlatformTime::Seconds() - StartTime >= Scenario.Duration
+		: NumSent >= Scenario.NumRequests;
+}
+
+void FYnnkHttpBenchmark::SendPendingRequests()
+{
+	const FYnnkHttpBenchmarkScenario& Scenario = Scenarios[ScenarioIndex];
+	if (Scenario.RequestsPerSecond > 0.f)
+	{
+		// open loop: slow responses don't delay the schedule
+		const double Now = FPlatformTime::Seconds();
+		while (NextSendTime <= Now && !IsSendingFinished())
+		{
+			NextSendTime += 1.0 / Scenario.RequestsPerSecond;
+			SendRequest();
+		}
+		return;
+	}
+
+	while (NumSent - NumFinished < Scenario.Concurrency && !IsSendingFinished())
+	{
+		SendRequest();
+	}
+}
+
+void FYnnkHttpBenchmark::SendRequest()
+{
+	const FYnnkHttpBenchmarkScenario& Scenario = Scenarios[ScenarioIndex];
+	NumSent++;
+
+	FYnnkHttpRequestOptions Options = Subsystem->DefaultOptions;
+	Options.RetryPolicy.MaxAttempts = 1;
+	Options.RetryPolicy.HedgeDelay = 0.f;
+	if (!Subsystem->SendHttpRequestWithOptions(BenchmarkKeyword, ScenarioUrl, Scenario.Verb, Scenario.HeaderParams, Scenario.Body, Options, Scenario.ResponseType))
+	{
+		NumFinished++;
+		NumFailed++;
+		ErrorsByCode.FindOrAdd(0)++;
+	}
+}
+
+void FYnnkHttpBenchmark::OnMetricsRecorded(FName RequestName, const FYnnkHttpRequestMetrics& Metrics)
+{
+	if (RequestName != BenchmarkKeyword || !Scenarios.IsValidIndex(ScenarioIndex))
+	{
+		return;
+	}
+
+	NumFinished++;
+	LastActivityTime = FPlatformTime::Seconds();
+	if (Metrics.bSucceeded)
+	{
+		Latencies.Add(Metrics.TotalTime);
+		FirstChunkTimes.Add(Metrics.TimeToFirstByte);
+	}
+	else
+	{
+		NumFailed++;
+		ErrorsByCode.FindOrAdd(Metrics.ResponseCode)++;
+	}
+
+	// keep the same number of requests in flight
+	SendPendingRequests();
+}
+
+bool FYnnkHttpBenchmark::Tick(float DeltaTime)
+{
+	// listener can release this object in OnFinished
+	const TSharedRef<FYnnkHttpBenchmark> Self = AsShared();
+
+	if (!Subsystem.IsValid())
+	{
+		Cancel();
+		return false;
+	}
+
+	if (Scenarios.IsValidIndex(ScenarioIndex))
+	{
+		const FYnnkHttpBenchmarkScenario& Scenario = Scenarios[ScenarioIndex];
+		SendPendingRequests();
+		SampleMemory();
+
+		const bool bStalled = FPlatformTime::Seconds() - LastActivityTime > BenchmarkStallTimeout;
+		if (bStalled)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("SimpleHttp benchmark: scenario %s stalled, %d of %d requests finished"), *Scenario.Name, NumFinished, NumSent);
+			NumFailed += NumSent - NumFinished;
+			ErrorsByCode.FindOrAdd(0) += NumSent - NumFinished;
+			NumFinished = NumSent;
+			Subsystem->CancelRequestsByKeyword(BenchmarkKeyword);
+		}
+		if (IsSendingFinished() && NumFinished >= NumSent)
+		{
+			FinishScenario();
+		}
+	}
+
+	return TickerHandle.IsValid();
+}
+
+void FYnnkHttpBenchmark::FinishScenario()
+{
+	if (Scenarios.IsValidIndex(ScenarioIndex))
+	{
+		FYnnkHttpBenchmarkResult& Result = Results.AddDefaulted_GetRef();
+		Result.Scenario = Scenarios[ScenarioIndex];
+		Result.NumFailed = NumFailed;
+		Result.NumSucceeded = NumFinished - NumFailed;
+		Result.Duration = FPlatformTime::Seconds() - StartTime;
+		Result.RequestsPerSecond = Result.Duration > 0.0 ? Result.NumSucceeded / Result.Duration : 0.0;
+		Result.LatencyP50 = GetPercentile(Latencies, 0.5f);
+		Result.LatencyP99 = GetPercentile(Latencies, 0.99f);
+		Result.FirstChunkP50 = GetPercentile(FirstChunkTimes, 0.5f);
+		Result.FirstChunkP99 = GetPercentile(FirstChunkTimes, 0.99f);
+		Result.MemoryPerRequestKB = FMath::Max<int64>((int64)InFlightMemory - (int64)MemoryBefore, 0) / 1024.0 / FMath::Max(MaxInFlight, 1);
+		Result.PeakMemoryMB = PeakMemory / 1024.0 / 1024.0;
+		Result.ErrorsByCode = ErrorsByCode;
+	}
+
+	ScenarioIndex++;
+	if (Scenarios.IsValidIndex(ScenarioIndex))
+	{
+		StartScenario();
+	}
+	else
+	{
+		Finish();
+	}
+}
+
+void FYnnkHttpBenchmark::Finish()
+{
+	Cancel();
+	OnFinished.ExecuteIfBound(Results);
+}
+
+FString FYnnkHttpBenchmark::GetDefaultResultsFileName()
+{
+	return FPaths::ProjectSavedDir() / TEXT("Benchmarks") / FString::Printf(TEXT("SimpleHttp-%s.json"), *FDateTime::Now().ToString());
+}
+
+bool FYnnkHttpBenchmark::SaveResults(const TArray<FYnnkHttpBenchmarkResult>& InResults, const FString& FileName)
+{
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+	Root->SetStringField(TEXT("engine"), FEngineVersion::Current().ToString());
+	Root->SetStringField(TEXT("platform"), FPlatformProperties::IniPlatformName());
+
+	TArray<TSharedPtr<FJsonValue>> Items;
+	for (const FYnnkHttpBenchmarkResult& Result : InResults)
+	{
+		TSharedRef<FJsonObject> Item = MakeShared<FJsonObject>();
+		Item->SetStringField(TEXT("name"), Result.Scenario.Name);
+		Item->SetStringField(TEXT("path"), Result.Scenario.Path);
+		Item->SetNumberField(TEXT("concurrency"), Result.Scenario.Concurrency);
+		Item->SetNumberField(TEXT("requests"), Result.Scenario.NumRequests);
+		Item->SetNumberField(TEXT("succeeded"), Result.NumSucceeded);
+		Item->SetNumberField(TEXT("failed"), Result.NumFailed);
+		Item->SetNumberField(TEXT("duration_s"), Result.Duration);
+		Item->SetNumberField(TEXT("requests_per_second"), Result.RequestsPerSecond);
+		Item->SetNumberField(TEXT("latency_p50_ms"), Result.LatencyP50 * 1000.0);
+		Item->SetNumberField(TEXT("latency_p99_ms"), Result.LatencyP99 * 1000.0);
+		Item->SetNumberField(TEXT("first_chunk_p50_ms"), Result.FirstChunkP50 * 1000.0);
+		Item->SetNumberField(TEXT("first_chunk_p99_ms"), Result.FirstChunkP99 * 1000.0);
+		Item->SetNumberField(TEXT("memory_per_request_kb"), Result.MemoryPerRequestKB);
+		Item->SetNumberField(TEXT("peak_memory_mb"), Result.PeakMemoryMB);
+		if (!Result.Scenario.URL.IsEmpty())
+		{
+			Item->SetStringField(TEXT("url"), Result.Scenario.URL);
+		}
+		if (Result.Scenario.RequestsPerSecond > 0.f)
+		{
+			Item->SetNumberField(TEXT("rate"), Result.Scenario.RequestsPerSecond);
+		}
+		if (Result.Scenario.Duration > 0.f)
+		{
+			Item->SetNumberField(TEXT("duration"), Result.Scenario.Duration);
+		}
+		TSharedRef<FJsonObject> Errors = MakeShared<FJsonObject>();
+		for (const auto& Error : Result.ErrorsByCode)
+		{
+			Errors->SetNumberField(FString::FromInt(Error.Key), Error.Value);
+		}
+		Item->SetObjectField(TEXT("errors"), Errors);
+		Items.Add(MakeShared<FJsonValueObject>(Item));
+	}
+	Root->SetArrayField(TEXT("scenarios"), Items);
+
+	FString Output;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Output);
+	FJsonSerializer::Serialize(Root, Writer);
+	return FFileHelper::SaveStringToFile(Output, *FileName);
+}
+
+void FYnnkHttpBenchmark::LogResults(const TArray<FYnnkHttpBenchmarkResult>& InResults)
+{
+	for (const FYnnkHttpBenchmarkResult& Result : InResults)
+	{
+		UE_LOG(LogTemp, Display, TEXT("%-20s %8.1f req/s  p50 %7.2f ms  p99 %7.2f ms  first chunk p50 %7.2f ms  p99 %7.2f ms  %6.1f KB/request  peak %7.1f MB  failed %d"),
+			*Result.Scenario.Name, Result.RequestsPerSecond, Result.LatencyP50 * 1000.f, Result.LatencyP99 * 1000.f, Result.FirstChunkP50 * 1000.f, Result.FirstChunkP99 * 1000.f,
+			Result.MemoryPerRequestKB, Result.PeakMemoryMB, Result.NumFailed);
+		for (const auto& Error : Result.ErrorsByCode)
+		{
+			UE_LOG(LogTemp, Display, TEXT("%-20s   code %d: %d failed"), TEXT(""), Error.Key, Error.Value);
+		}
+	}
+}
+
+namespace
+{
+	TSharedPtr<FYnnkHttpBenchmark> ActiveBenchmark;
+
+	void RunBenchmarkCommand(const TArray<FString>& Args)
+	{
+		UHTTPSubsystem* HttpSubsystem = GEngine ? GEngine->GetEngineSubsystem<UHTTPSubsystem>() : nullptr;
+		if (!HttpSubsystem)
+		{
+			return;
+		}
+		if (ActiveBenchmark.IsValid() && ActiveBenchmark->IsRunning())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("SimpleHttp benchmark is already running"));
+			return;
+		}
+
+		const FString Params = FString::Join(Args, TEXT(" "));
+		int32 NumRequests = 200;
+		FParse::Value(*Params, TEXT("Requests="), NumRequests);
+		FString FileName = FYnnkHttpBenchmark::GetDefaultResultsFileName();
+		FParse::Value(*Params, TEXT("Out="), FileName);
+
+		ActiveBenchmark = MakeShared<FYnnkHttpBenchmark>(HttpSubsystem);
+		const bool bStarted = ActiveBenchmark->Start(FYnnkHttpBenchmark::GetDefaultScenarios(NumRequests),
+			FYnnkHttpBenchmark::FOnBenchmarkFinished::CreateLambda([FileName](const TArray<FYnnkHttpBenchmarkResult>& Results)
+			{
+				FYnnkHttpBenchmark::LogResults(Results);
+				if (FYnnkHttpBenchmark::SaveResults(Results, FileName))
+				{
+					UE_LOG(LogTemp, Display, TEXT("SimpleHttp benchmark results saved to %s"), *FileName);
+				}
+				ActiveBenchmark.Reset();
+			}));
+
+		if (!bStarted)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Unable to start SimpleHttp benchmark"));
+			ActiveBenchmark.Reset();
+		}
+	}
+}
+
+static FAutoConsoleCommand SimpleHttpBenchmarkCommand(
+	TEXT("SimpleHttp.Benchmark"),
+	TEXT("Run UHTTPSubsystem benchmark against loopback server. Usage: SimpleHttp.Benchmark [Requests=200] [Out=<file.json>]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunBenchmarkCommand));
+
+#endif
@@ -0,0 +1,145 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "YnnkHttpTypes.h"
+#include "YnnkHttpMetrics.h"
+#include "YnnkHttpLoopbackServer.h"
+
+#if !UE_BUILD_SHIPPING
+
+class UHTTPSubsystem;
+
+struct FYnnkHttpBenchmarkScenario
+{
+	FString Name;
+	// Path and query of loopback server route
+	FString Path;
+	// Endpoint used instead of loopback server if not empty
+	FString URL;
+	ERequestMethod Verb = ERequestMethod::Get;
+	TArray<FYnnkUrlParameter> HeaderParams;
+	FString Body;
+	EExpectedResponseType ResponseType = EExpectedResponseType::Text;
+	// Maximum number of requests in flight (closed loop: the next request is sent when one is finished). Ignored if RequestsPerSecond is set.
+	int32 Concurrency = 1;
+	int32 NumRequests = 100;
+	// Open loop: requests are started on schedule regardless of responses, and requests overdue after a slow frame are sent at once
+	float RequestsPerSecond = 0.f;
+	// Send requests during this time (seconds) instead of sending NumRequests
+	float Duration = 0.f;
+
+	FString GetUrl(const FYnnkHttpLoopbackServer& Server) const
+	{
+		return URL.IsEmpty() ? Server.GetUrl(Path) : URL;
+	}
+};
+
+struct FYnnkHttpBenchmarkResult
+{
+	FYnnkHttpBenchmarkScenario Scenario;
+	int32 NumSucceeded = 0;
+	int32 NumFailed = 0;
+	double Duration = 0.0;
+	double RequestsPerSecond = 0.0;
+	// seconds
+	float LatencyP50 = 0.f;
+	float LatencyP99 = 0.f;
+	float FirstChunkP50 = 0.f;
+	float FirstChunkP99 = 0.f;
+	// used physical memory over the value before scenario, sampled while the most requests were in flight and divided by their number (approximate)
+	double MemoryPerRequestKB = 0.0;
+	// maximum of used physical memory while scenario was running
+	double PeakMemoryMB = 0.0;
+	// failed requests by response code (0 - no response)
+	TMap<int32, int32> ErrorsByCode;
+};
+
+/**
+* Sends requests of UHTTPSubsystem to loopback server and measures them using request metrics.
+* Runs in game thread ticker; scenarios are executed one by one.
+*/
+class FYnnkHttpBenchmark : public TSharedFromThis<FYnnkHttpBenchmark>
+{
+public:
+	DECLARE_DELEGATE_OneParam(FOnBenchmarkFinished, const TArray<FYnnkHttpBenchmarkResult>& /*Results*/);
+
+	FYnnkHttpBenchmark(UHTTPSubsystem* InSubsystem);
+	~FYnnkHttpBenchmark();
+
+	/** Fixed, chunked and SSE responses at 1/16/128 concurrent requests */
+	static TArray<FYnnkHttpBenchmarkScenario> GetDefaultScenarios(int32 NumRequests);
+
+	/**
+	* Read scenarios from json file: {"scenarios": [{"name", "path" or "url", "verb", "headers": {}, "body" (string or object),
+	* "response" ("Text", "StreamText" etc.), "concurrency", "requests", "rate", "duration"}]}.
+	* "rate" (requests per second) makes scenario open-loop, "concurrency" is only used without it.
+	*/
+	static bool LoadScenarios(const FString& FileName, TArray<FYnnkHttpBenchmarkScenario>& OutScenarios);
+
+	/** Start local server and the first scenario */
+	bool Start(const TArray<FYnnkHttpBenchmarkScenario>& InScenarios, FOnBenchmarkFinished InOnFinished);
+
+	void Cancel();
+
+	bool IsRunning() const
+	{
+		return TickerHandle.IsValid();
+	}
+
+	FYnnkHttpLoopbackServer& GetServer()
+	{
+		return Server;
+	}
+
+	/** Write results to json file */
+	static bool SaveResults(const TArray<FYnnkHttpBenchmarkResult>& Results, const FString& FileName);
+	static FString GetDefaultResultsFileName();
+	static void LogResults(const TArray<FYnnkHttpBenchmarkResult>& Results);
+
+private:
+	void StartScenario();
+	void SendRequest();
+	/** Send requests allowed by concurrency or rate, and duration of scenario */
+	void SendPendingRequests();
+	bool IsSendingFinished() const;
+	/** Update peak memory and memory sampled with the most requests in flight */
+	void SampleMemory();
+	void FinishScenario();
+	void Finish();
+	bool Tick(float DeltaTime);
+	void OnMetricsRecorded(FName RequestName, const FYnnkHttpRequestMetrics& Metrics);
+
+	TWeakObjectPtr<UHTTPSubsystem> Subsystem;
+	FYnnkHttpLoopbackServer Server;
+	FOnBenchmarkFinished OnFinished;
+
+	TArray<FYnnkHttpBenchmarkScenario> Scenarios;
+	TArray<FYnnkHttpBenchmarkResult> Results;
+	int32 ScenarioIndex = INDEX_NONE;
+
+	// current scenario
+	FString ScenarioUrl;
+	TArray<float> Latencies;
+	TArray<float> FirstChunkTimes;
+	int32 NumSent = 0;
+	int32 NumFinished = 0;
+	int32 NumFailed = 0;
+	TMap<int32, int32> ErrorsByCode;
+	double StartTime = 0.0;
+	double NextSendTime = 0.0;
+	uint64 PeakMemory = 0;
+	uint64 MemoryBefore = 0;
+	uint64 InFlightMemory = 0;
+	int32 MaxInFlight = 0;
+	double LastActivityTime = 0.0;
+
+	bool bPrevCollectMetrics = true;
+	FDelegateHandle MetricsHandle;
+	FTSTicker::FDelegateHandle TickerHandle;
+};
+
+#endif
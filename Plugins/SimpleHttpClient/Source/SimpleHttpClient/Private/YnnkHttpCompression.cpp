@@ -0,0 +1,161 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkHttpCompression.h"
+#include "YnnkHttpPrivate.h"
+#include "Misc/Compression.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+// output is reserved with this ratio to input size
+constexpr int32 InflateSizeRatio = 4;
+constexpr int32 InflateMinOutput = 4096;
+
+const TCHAR* YnnkHttpCompression::GetEncodingName(EYnnkContentEncoding Encoding)
+{
+	switch (Encoding)
+	{
+		case EYnnkContentEncoding::Gzip: return TEXT("gzip");
+		case EYnnkContentEncoding::Deflate: return TEXT("deflate");
+	}
+	return TEXT("identity");
+}
+
+bool YnnkHttpCompression::Compress(EYnnkContentEncoding Encoding, const uint8* Data, int32 Size, TArray<uint8>& OutData)
+{
+	if (Encoding == EYnnkContentEncoding::None)
+	{
+		return false;
+	}
+
+	// http "deflate" is zlib stream
+	const FName FormatName = Encoding == EYnnkContentEncoding::Gzip ? NAME_Gzip : NAME_Zlib;
+
+	int32 CompressedSize = FCompression::CompressMemoryBound(FormatName, Size);
+	OutData.SetNumUninitialized(CompressedSize);
+	if (!FCompression::CompressMemory(FormatName, OutData.GetData(), CompressedSize, Data, Size))
+	{
+		OutData.Empty();
+		return false;
+	}
+	OutData.SetNum(CompressedSize);
+	return true;
+}
+
+bool YnnkHttpCompression::IsCompressedStream(const uint8* Data, int64 Size)
+{
+	if (Size < 2)
+	{
+		return false;
+	}
+	// gzip magic number
+	if (Data[0] == 0x1f && Data[1] == 0x8b)
+	{
+		return true;
+	}
+	// zlib header: deflate method and valid check bits
+	return (Data[0] & 0x0f) == 8 && (Data[0] >> 4) <= 7 && ((Data[0] << 8) | Data[1]) % 31 == 0;
+}
+
+bool YnnkHttpCompression::IsCompressedResponse(const FString& ContentEncoding, const uint8* Data, int64 Size)
+{
+	// zlib header check alone matches some plain text
+	return (ContentEncoding.Contains(TEXT("gzip")) || ContentEncoding.Contains(TEXT("deflate"))) && IsCompressedStream(Data, Size);
+}
+
+FYnnkStreamInflater::FYnnkStreamInflater()
+{
+	Init();
+}
+
+FYnnkStreamInflater::~FYnnkStreamInflater()
+{
+	Release();
+}
+
+bool FYnnkStreamInflater::Init()
+{
+	Release();
+
+	Stream = new z_stream();
+	FMemory::Memzero(Stream, sizeof(z_stream));
+	bFinished = false;
+
+	// 15 + 32: automatic detection of gzip or zlib header (responses without header aren't detected as compressed)
+	if (inflateInit2(Stream, MAX_WBITS + 32) != Z_OK)
+	{
+		delete Stream;
+		Stream = nullptr;
+		return false;
+	}
+	return true;
+}
+
+void FYnnkStreamInflater::Release()
+{
+	if (Stream)
+	{
+		inflateEnd(Stream);
+		delete Stream;
+		Stream = nullptr;
+	}
+}
+
+void FYnnkStreamInflater::Reset()
+{
+	if (Stream)
+	{
+		inflateReset(Stream);
+		bFinished = false;
+	}
+	else
+	{
+		Init();
+	}
+}
+
+bool FYnnkStreamInflater::Inflate(const uint8* Data, int64 Size, TArray<uint8>& OutData)
+{
+	if (!Stream || bFinished || Size <= 0)
+	{
+		return Stream != nullptr;
+	}
+
+	Stream->next_in = const_cast<Bytef*>(Data);
+	Stream->avail_in = (uInt)Size;
+
+	// full output buffer can leave decoded data inside zlib even when all input is consumed
+	do
+	{
+		const int32 Offset = OutData.Num();
+		const int32 Reserved = FMath::Max((int32)Stream->avail_in * InflateSizeRatio, InflateMinOutput);
+		OutData.AddUninitialized(Reserved);
+
+		Stream->next_out = OutData.GetData() + Offset;
+		Stream->avail_out = (uInt)Reserved;
+
+		const int32 Result = inflate(Stream, Z_NO_FLUSH);
+		OutData.SetNum(Offset + Reserved - (int32)Stream->avail_out, YNNK_NO_SHRINK);
+
+		if (Result == Z_STREAM_END)
+		{
+			bFinished = true;
+			break;
+		}
+		else if (Result == Z_BUF_ERROR)
+		{
+			// no progress possible until next part of the stream
+			break;
+		}
+		else if (Result != Z_OK)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("FYnnkStreamInflater: invalid compressed data (%d)"), Result);
+			return false;
+		}
+	}
+	while (Stream->avail_in > 0 || Stream->avail_out == 0);
+
+	return true;
+}
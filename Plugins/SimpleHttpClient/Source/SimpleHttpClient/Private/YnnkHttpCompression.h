@@ -0,0 +1,50 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "YnnkHttpTypes.h"
+
+struct z_stream_s;
+
+namespace YnnkHttpCompression
+{
+	/** Value of Content-Encoding header for encoding */
+	const TCHAR* GetEncodingName(EYnnkContentEncoding Encoding);
+
+	/** Compress data as gzip or zlib (http "deflate") stream */
+	bool Compress(EYnnkContentEncoding Encoding, const uint8* Data, int32 Size, TArray<uint8>& OutData);
+
+	/** Check if data starts with gzip or zlib header */
+	bool IsCompressedStream(const uint8* Data, int64 Size);
+
+	/** Check if response should be decoded: Content-Encoding is gzip or deflate, and data has matching header (http module didn't decode it) */
+	bool IsCompressedResponse(const FString& ContentEncoding, const uint8* Data, int64 Size);
+}
+
+/**
+* Incremental decoder of gzip/deflate stream. Data can be split at any byte.
+*/
+class FYnnkStreamInflater
+{
+public:
+	FYnnkStreamInflater();
+	~FYnnkStreamInflater();
+
+	/** Decode next part of the stream and append result to OutData. Returns false if stream is corrupted. */
+	bool Inflate(const uint8* Data, int64 Size, TArray<uint8>& OutData);
+
+	/** End of compressed stream was reached */
+	bool IsFinished() const { return bFinished; }
+
+	/** Prepare to decode a new stream */
+	void Reset();
+
+private:
+	bool Init();
+	void Release();
+
+	z_stream_s* Stream = nullptr;
+	bool bFinished = false;
+};
@@ -0,0 +1,155 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkHttpHeaders.h"
+#include "HAL/CriticalSection.h"
+#include "Misc/DateTime.h"
+#include "Misc/ScopeLock.h"
+#include "YnnkHttpTrace.h"
+
+struct FYnnkHttpHeaderData
+{
+	FCriticalSection Lock;
+	bool bParsed = false;
+
+	// source, not changed after construction
+	TArray<FString> Lines;
+
+	// FString keys of TMap are compared case-insensitively
+	TMap<FString, FString> Map;
+
+	const TMap<FString, FString>& GetMap()
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (!bParsed)
+		{
+			YNNK_HTTP_TRACE_SCOPE("FYnnkHttpHeaders::Parse");
+
+			Map.Reserve(Lines.Num());
+			for (const FString& Line : Lines)
+			{
+				int32 Separator;
+				if (!Line.FindChar(TCHAR(':'), Separator))
+				{
+					continue;
+				}
+				const FString Name = Line.Left(Separator).TrimStartAndEnd();
+				const FString Value = Line.RightChop(Separator + 1).TrimStartAndEnd();
+				if (FString* Existing = Map.Find(Name))
+				{
+					Existing->Append(TEXT(", ")).Append(Value);
+				}
+				else
+				{
+					Map.Add(Name, Value);
+				}
+			}
+			bParsed = true;
+		}
+		return Map;
+	}
+
+};
+
+FYnnkHttpHeaders::FYnnkHttpHeaders(FHttpResponsePtr Response)
+{
+	if (Response.IsValid())
+	{
+		// copies of headers can be stored by listeners, so response with content isn't kept
+		Data = MakeShared<FYnnkHttpHeaderData, ESPMode::ThreadSafe>();
+		Data->Lines = Response->GetAllHeaders();
+	}
+}
+
+FYnnkHttpHeaders::FYnnkHttpHeaders(TArray<FString> Lines)
+{
+	if (Lines.Num() > 0)
+	{
+		Data = MakeShared<FYnnkHttpHeaderData, ESPMode::ThreadSafe>();
+		Data->Lines = MoveTemp(Lines);
+	}
+}
+
+bool FYnnkHttpHeaders::IsEmpty() const
+{
+	return GetMap().Num() == 0;
+}
+
+const FString* FYnnkHttpHeaders::Find(const FString& Name) const
+{
+	return GetMap().Find(Name);
+}
+
+int64 FYnnkHttpHeaders::GetContentLength() const
+{
+	const FString* Value = Find(TEXT("Content-Length"));
+	return Value && Value->IsNumeric() ? FCString::Atoi64(**Value) : -1;
+}
+
+FString FYnnkHttpHeaders::GetContentType() const
+{
+	const FString* Value = Find(TEXT("Content-Type"));
+	if (!Value)
+	{
+		return FString();
+	}
+	int32 ParamsStart;
+	return Value->FindChar(TCHAR(';'), ParamsStart) ? Value->Left(ParamsStart).TrimEnd() : *Value;
+}
+
+float FYnnkHttpHeaders::GetRetryAfter() const
+{
+	const FString* Value = Find(TEXT("Retry-After"));
+	if (!Value || Value->IsEmpty())
+	{
+		return -1.f;
+	}
+	if (Value->IsNumeric())
+	{
+		return FCString::Atof(**Value);
+	}
+	FDateTime RetryTime;
+	if (FDateTime::ParseHttpDate(*Value, RetryTime))
+	{
+		return FMath::Max((float)(RetryTime - FDateTime::UtcNow()).GetTotalSeconds(), 0.f);
+	}
+	return -1.f;
+}
+
+TArray<FString> FYnnkHttpHeaders::ToArray() const
+{
+	return Data.IsValid() ? Data->Lines : TArray<FString>();
+}
+
+const TMap<FString, FString>& FYnnkHttpHeaders::GetMap() const
+{
+	static const TMap<FString, FString> EmptyMap;
+	return Data.IsValid() ? Data->GetMap() : EmptyMap;
+}
+
+bool UYnnkHttpHeadersLibrary::GetHeaderValue(const FYnnkHttpHeaders& Headers, const FString& Name, FString& Value)
+{
+	const FString* Found = Headers.Find(Name);
+	Value = Found ? *Found : FString();
+	return Found != nullptr;
+}
+
+int64 UYnnkHttpHeadersLibrary::GetHeaderContentLength(const FYnnkHttpHeaders& Headers)
+{
+	return Headers.GetContentLength();
+}
+
+FString UYnnkHttpHeadersLibrary::GetHeaderContentType(const FYnnkHttpHeaders& Headers)
+{
+	return Headers.GetContentType();
+}
+
+float UYnnkHttpHeadersLibrary::GetHeaderRetryAfter(const FYnnkHttpHeaders& Headers)
+{
+	return Headers.GetRetryAfter();
+}
+
+TArray<FString> UYnnkHttpHeadersLibrary::HeadersToArray(const FYnnkHttpHeaders& Headers)
+{
+	return Headers.ToArray();
+}
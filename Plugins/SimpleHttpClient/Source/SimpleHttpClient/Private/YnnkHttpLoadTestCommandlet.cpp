@@ -0,0 +1,88 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkHttpLoadTestCommandlet.h"
+#include "HTTPSubsystem.h"
+#include "YnnkHttpBenchmark.h"
+#include "Engine/Engine.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Containers/Ticker.h"
+#include "Misc/Parse.h"
+
+UYnnkHttpLoadTestCommandlet::UYnnkHttpLoadTestCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UYnnkHttpLoadTestCommandlet::Main(const FString& Params)
+{
+#if UE_BUILD_SHIPPING
+	UE_LOG(LogTemp, Error, TEXT("YnnkHttpLoadTest isn't available in shipping build"));
+	return 1;
+#else
+	UHTTPSubsystem* HttpSubsystem = GEngine ? GEngine->GetEngineSubsystem<UHTTPSubsystem>() : nullptr;
+	if (!HttpSubsystem)
+	{
+		UE_LOG(LogTemp, Error, TEXT("YnnkHttpLoadTest: HTTP subsystem isn't initialized"));
+		return 1;
+	}
+
+	TArray<FYnnkHttpBenchmarkScenario> Scenarios;
+	FString ScenarioFile;
+	if (FParse::Value(*Params, TEXT("Scenario="), ScenarioFile))
+	{
+		if (!FYnnkHttpBenchmark::LoadScenarios(ScenarioFile, Scenarios))
+		{
+			return 1;
+		}
+	}
+	else
+	{
+		int32 NumRequests = 200;
+		FParse::Value(*Params, TEXT("Requests="), NumRequests);
+		Scenarios = FYnnkHttpBenchmark::GetDefaultScenarios(NumRequests);
+	}
+	FString FileName = FYnnkHttpBenchmark::GetDefaultResultsFileName();
+	FParse::Value(*Params, TEXT("Out="), FileName);
+
+	bool bFinished = false;
+	TArray<FYnnkHttpBenchmarkResult> Results;
+	const TSharedRef<FYnnkHttpBenchmark> Benchmark = MakeShared<FYnnkHttpBenchmark>(HttpSubsystem);
+	const bool bStarted = Benchmark->Start(Scenarios, FYnnkHttpBenchmark::FOnBenchmarkFinished::CreateLambda([&bFinished, &Results](const TArray<FYnnkHttpBenchmarkResult>& InResults)
+	{
+		Results = InResults;
+		bFinished = true;
+	}));
+	if (!bStarted)
+	{
+		UE_LOG(LogTemp, Error, TEXT("YnnkHttpLoadTest: unable to start loopback server"));
+		return 1;
+	}
+
+	// there is no engine loop in commandlet: core ticker updates http manager and subsystem, game thread tasks deliver responses
+	double LastTime = FPlatformTime::Seconds();
+	while (!bFinished && !IsEngineExitRequested())
+	{
+		const double Now = FPlatformTime::Seconds();
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		FTSTicker::GetCoreTicker().Tick((float)(Now - LastTime));
+		LastTime = Now;
+		FPlatformProcess::Sleep(0.001f);
+	}
+	if (!bFinished)
+	{
+		Benchmark->Cancel();
+		return 1;
+	}
+
+	FYnnkHttpBenchmark::LogResults(Results);
+	if (FYnnkHttpBenchmark::SaveResults(Results, FileName))
+	{
+		UE_LOG(LogTemp, Display, TEXT("YnnkHttpLoadTest: results saved to %s"), *FileName);
+	}
+	return 0;
+#endif
+}
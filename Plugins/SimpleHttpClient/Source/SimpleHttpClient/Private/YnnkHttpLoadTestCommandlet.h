@@ -0,0 +1,23 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "YnnkHttpLoadTestCommandlet.generated.h"
+
+/**
+* Runs benchmark scenarios of UHTTPSubsystem without game. Requests are sent to local loopback server unless scenario has url.
+* Usage: -run=YnnkHttpLoadTest [Scenario=<file.json>] [Requests=200] [Out=<results.json>]
+*/
+UCLASS()
+class UYnnkHttpLoadTestCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UYnnkHttpLoadTestCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
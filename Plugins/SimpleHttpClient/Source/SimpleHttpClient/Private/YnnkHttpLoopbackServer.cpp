@@ -0,0 +1,632 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkHttpLoopbackServer.h"
+
+#if !UE_BUILD_SHIPPING
+
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "IPAddress.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/Base64.h"
+#include "Misc/SecureHash.h"
+#include "YnnkHttpPrivate.h"
+
+namespace
+{
+	// request larger than this is rejected
+	constexpr int32 MaxRequestSize = 16 * 1024 * 1024;
+
+	void AppendUtf8(TArray<uint8>& Data, const FString& Text)
+	{
+		FTCHARToUTF8 Converter(*Text);
+		Data.Append((const uint8*)Converter.Get(), Converter.Length());
+	}
+
+	/** Readable text of exact size */
+	FString MakeText(int32 Size)
+	{
+		static const TCHAR* Words[] = { TEXT("hello "), TEXT("stream "), TEXT("token "), TEXT("audio "), TEXT("world ") };
+		FString Text;
+		Text.Reserve(Size);
+		for (int32 Index = 0; Text.Len() < Size; Index++)
+		{
+			Text.Append(Words[Index % UE_ARRAY_COUNT(Words)]);
+		}
+		Text.LeftInline(Size, YNNK_NO_SHRINK);
+		return Text;
+	}
+
+	/** Unmasked WebSocket frame (server to client) */
+	void AppendWebSocketFrame(TArray<uint8>& Data, uint8 FirstByte, const uint8* Payload, int64 Size)
+	{
+		Data.Add(FirstByte);
+		if (Size < 126)
+		{
+			Data.Add((uint8)Size);
+		}
+		else if (Size <= 0xFFFF)
+		{
+			Data.Add(126);
+			Data.Add((uint8)(Size >> 8));
+			Data.Add((uint8)Size);
+		}
+		else
+		{
+			Data.Add(127);
+			for (int32 Shift = 56; Shift >= 0; Shift -= 8)
+			{
+				Data.Add((uint8)(Size >> Shift));
+			}
+		}
+		Data.Append(Payload, (int32)Size);
+	}
+
+	const TCHAR* GetStatusText(int32 StatusCode)
+	{
+		switch (StatusCode)
+		{
+			case 101: return TEXT("Switching Protocols");
+			case 200: return TEXT("OK");
+			case 206: return TEXT("Partial Content");
+			case 400: return TEXT("Bad Request");
+			case 404: return TEXT("Not Found");
+			case 429: return TEXT("Too Many Requests");
+			case 500: return TEXT("Internal Server Error");
+			case 502: return TEXT("Bad Gateway");
+			case 503: return TEXT("Service Unavailable");
+			case 504: return TEXT("Gateway Timeout");
+		}
+		return TEXT("Status");
+	}
+
+	/** Value of comma-separated list for request with index RequestIndex; the last value is repeated */
+	FString GetListValue(const FString& Value, int32 RequestIndex)
+	{
+		TArray<FString> Values;
+		Value.ParseIntoArray(Values, TEXT(","));
+		return Values.Num() > 0 ? Values[FMath::Min(RequestIndex, Values.Num() - 1)] : Value;
+	}
+}
+
+FYnnkHttpLoopbackServer::FYnnkHttpLoopbackServer()
+{
+}
+
+FYnnkHttpLoopbackServer::~FYnnkHttpLoopbackServer()
+{
+	Shutdown();
+}
+
+void FYnnkHttpLoopbackServer::AddDefaultRoutes()
+{
+	FYnnkLoopbackResponse Response;
+	AddRoute(TEXT("/fixed"), Response);
+
+	Response.Mode = EYnnkLoopbackMode::Chunked;
+	Response.BodySize = 16384;
+	AddRoute(TEXT("/chunked"), Response);
+
+	Response.Mode = EYnnkLoopbackMode::ServerSentEvents;
+	Response.BodySize = 4096;
+	Response.ChunkSize = 96;
+	Response.ChunkInterval = 0.01f;
+	AddRoute(TEXT("/sse"), Response);
+
+	Response.Mode = EYnnkLoopbackMode::SlowDrip;
+	Response.BodySize = 8192;
+	Response.ChunkSize = 512;
+	Response.ChunkInterval = 0.05f;
+	AddRoute(TEXT("/drip"), Response);
+
+	Response.Mode = EYnnkLoopbackMode::WebSocketEcho;
+	AddRoute(TEXT("/ws"), Response);
+}
+
+void FYnnkHttpLoopbackServer::AddRoute(const FString& Path, const FYnnkLoopbackResponse& Response)
+{
+	FScopeLock Lock(&RoutesLock);
+	Routes.Add(Path, Response);
+}
+
+bool FYnnkHttpLoopbackServer::Start(int32 Port)
+{
+	if (Thread)
+	{
+		return true;
+	}
+
+	ISocketSubsystem* SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	if (!SocketSubsystem)
+	{
+		return false;
+	}
+
+	ListenSocket = SocketSubsystem->CreateSocket(NAME_Stream, TEXT("YnnkHttpLoopbackServer"), false);
+	if (!ListenSocket)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FYnnkHttpLoopbackServer: unable to create socket"));
+		return false;
+	}
+
+	TSharedRef<FInternetAddr> Address = SocketSubsystem->CreateInternetAddr();
+	Address->SetLoopbackAddress();
+	Address->SetPort(Port);
+
+	ListenSocket->SetReuseAddr(true);
+	if (!ListenSocket->Bind(*Address) || !ListenSocket->Listen(256))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FYnnkHttpLoopbackServer: unable to listen on port %d"), Port);
+		SocketSubsystem->DestroySocket(ListenSocket);
+		ListenSocket = nullptr;
+		return false;
+	}
+	ListenSocket->SetNonBlocking(true);
+	ListenPort = ListenSocket->GetPortNo();
+
+	bStopping = false;
+	Thread = FRunnableThread::Create(this, TEXT("YnnkHttpLoopbackServer"));
+	UE_LOG(LogTemp, Log, TEXT("FYnnkHttpLoopbackServer: listening on 127.0.0.1:%d"), ListenPort);
+
+	return Thread != nullptr;
+}
+
+void FYnnkHttpLoopbackServer::Shutdown()
+{
+	if (Thread)
+	{
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	for (FConnection& Connection : Connections)
+	{
+		CloseConnection(Connection);
+	}
+	Connections.Empty();
+
+	if (ListenSocket)
+	{
+		ListenSocket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(ListenSocket);
+		ListenSocket = nullptr;
+	}
+}
+
+int32 FYnnkHttpLoopbackServer::GetNumRequests(const FString& PathAndQuery) const
+{
+	FScopeLock Lock(&RoutesLock);
+	const int32* Num = NumRequests.Find(PathAndQuery);
+	return Num ? *Num : 0;
+}
+
+FString FYnnkHttpLoopbackServer::GetUrl(const FString& PathAndQuery) const
+{
+	return FString::Printf(TEXT("http://127.0.0.1:%d%s"), ListenPort, *PathAndQuery);
+}
+
+FString FYnnkHttpLoopbackServer::GetWebSocketUrl(const FString& PathAndQuery) const
+{
+	return FString::Printf(TEXT("ws://127.0.0.1:%d%s"), ListenPort, *PathAndQuery);
+}
+
+void FYnnkHttpLoopbackServer::Stop()
+{
+	bStopping = true;
+}
+
+uint32 FYnnkHttpLoopbackServer::Run()
+{
+	while (!bStopping)
+	{
+		bool bPendingConnection = false;
+		while (ListenSocket->HasPendingConnection(bPendingConnection) && bPendingConnection)
+		{
+			FSocket* Socket = ListenSocket->Accept(TEXT("YnnkHttpLoopbackConnection"));
+			if (!Socket)
+			{
+				break;
+			}
+			Socket->SetNonBlocking(true);
+			Socket->SetNoDelay(true);
+			Connections.AddDefaulted_GetRef().Socket = Socket;
+		}
+
+		const double Now = FPlatformTime::Seconds();
+		for (int32 Index = Connections.Num() - 1; Index >= 0; Index--)
+		{
+			FConnection& Connection = Connections[Index];
+			const bool bKeepOpen = Connection.bWebSocket ? ServeWebSocket(Connection)
+				: Connection.bResponding ? SendResponse(Connection, Now)
+				: ReadRequest(Connection);
+			if (!bKeepOpen)
+			{
+				CloseConnection(Connection);
+				Connections.RemoveAtSwap(Index, 1, YNNK_NO_SHRINK);
+			}
+		}
+
+		FPlatformProcess::SleepNoStats(Connections.Num() > 0 ? 0.0001f : 0.001f);
+	}
+	return 0;
+}
+
+bool FYnnkHttpLoopbackServer::ReceivePending(FConnection& Connection)
+{
+	FSocket* Socket = Connection.Socket;
+	TArray<uint8>& Data = Connection.RequestData;
+
+	uint32 PendingSize = 0;
+	while (Socket->HasPendingData(PendingSize) && PendingSize > 0)
+	{
+		const int32 Offset = Data.Num();
+		const int32 ReadSize = (int32)FMath::Min(PendingSize, 65536u);
+		Data.AddUninitialized(ReadSize);
+
+		int32 BytesRead = 0;
+		if (!Socket->Recv(Data.GetData() + Offset, ReadSize, BytesRead))
+		{
+			return false;
+		}
+		Data.SetNum(Offset + BytesRead, YNNK_NO_SHRINK);
+		if (BytesRead == 0 || Data.Num() > MaxRequestSize)
+		{
+			break;
+		}
+	}
+	return Socket->GetConnectionState() != SCS_ConnectionError && Data.Num() <= MaxRequestSize;
+}
+
+bool FYnnkHttpLoopbackServer::ReadRequest(FConnection& Connection)
+{
+	TArray<uint8>& Data = Connection.RequestData;
+	if (!ReceivePending(Connection))
+	{
+		return false;
+	}
+
+	if (Connection.HeaderSize == INDEX_NONE)
+	{
+		for (int32 Index = 3; Index < Data.Num(); Index++)
+		{
+			if (Data[Index - 3] == '\r' && Data[Index - 2] == '\n' && Data[Index - 1] == '\r' && Data[Index] == '\n')
+			{
+				Connection.HeaderSize = Index + 1;
+				break;
+			}
+		}
+		if (Connection.HeaderSize == INDEX_NONE)
+		{
+			return true;
+		}
+
+		const FUTF8ToTCHAR Converter((const ANSICHAR*)Data.GetData(), Connection.HeaderSize);
+		const FString HeaderText(Converter.Length(), Converter.Get());
+		TArray<FString> Lines;
+		HeaderText.ParseIntoArray(Lines, TEXT("\r\n"));
+		if (Lines.Num() == 0)
+		{
+			return false;
+		}
+		Connection.RequestLine = Lines[0];
+		for (const FString& Line : Lines)
+		{
+			if (Line.StartsWith(TEXT("Content-Length:")))
+			{
+				Connection.ContentLength = FCString::Atoi(*Line.RightChop(15).TrimStartAndEnd());
+			}
+			else if (Line.StartsWith(TEXT("Sec-WebSocket-Key:")))
+			{
+				Connection.WebSocketKey = Line.RightChop(18).TrimStartAndEnd();
+			}
+		}
+	}
+
+	// wait for the whole body
+	if (Data.Num() < Connection.HeaderSize + Connection.ContentLength)
+	{
+		return true;
+	}
+
+	BuildResponse(Connection, Connection.RequestLine, FPlatformTime::Seconds());
+	if (Connection.bWebSocket)
+	{
+		// client can send frames right after the handshake
+		Data.RemoveAt(0, Connection.HeaderSize + Connection.ContentLength, YNNK_NO_SHRINK);
+		return true;
+	}
+	Connection.RequestData.Empty();
+	Connection.bResponding = true;
+	return true;
+}
+
+void FYnnkHttpLoopbackServer::BuildResponse(FConnection& Connection, const FString& RequestLine, double Now)
+{
+	// "GET /path?query HTTP/1.1"
+	TArray<FString> RequestParts;
+	RequestLine.ParseIntoArrayWS(RequestParts);
+	const FString Target = RequestParts.Num() > 1 ? RequestParts[1] : FString(TEXT("/"));
+	FString Path, Query;
+	if (!Target.Split(TEXT("?"), &Path, &Query))
+	{
+		Path = Target;
+	}
+
+	FYnnkLoopbackResponse Response;
+	bool bRouteFound = false;
+	int32 RequestIndex = 0;
+	{
+		FScopeLock Lock(&RoutesLock);
+		RequestIndex = NumRequests.FindOrAdd(Target)++;
+		if (const FYnnkLoopbackResponse* Route = Routes.Find(Path))
+		{
+			Response = *Route;
+			bRouteFound = true;
+		}
+	}
+	if (!bRouteFound)
+	{
+		Response.StatusCode = 404;
+		Response.BodySize = 0;
+	}
+
+	TArray<FString> QueryParams;
+	Query.ParseIntoArray(QueryParams, TEXT("&"));
+	for (const FString& Param : QueryParams)
+	{
+		FString Key, Value;
+		if (!Param.Split(TEXT("="), &Key, &Value))
+		{
+			continue;
+		}
+		if (Key == TEXT("size")) Response.BodySize = FMath::Max(FCString::Atoi(*Value), 0);
+		else if (Key == TEXT("chunk")) Response.ChunkSize = FMath::Max(FCString::Atoi(*Value), 1);
+		else if (Key == TEXT("interval")) Response.ChunkInterval = FMath::Max(FCString::Atof(*Value), 0.f);
+		else if (Key == TEXT("delay")) Response.InitialDelay = FMath::Max(FCString::Atof(*GetListValue(Value, RequestIndex)), 0.f);
+		else if (Key == TEXT("status")) Response.StatusCode = FCString::Atoi(*GetListValue(Value, RequestIndex));
+		else if (Key == TEXT("retryafter")) Response.RetryAfter = FMath::Max(FCString::Atoi(*Value), 0);
+	}
+	Response.ChunkSize = FMath::Max(Response.ChunkSize, 1);
+
+	if (Response.Mode == EYnnkLoopbackMode::WebSocketEcho && bRouteFound)
+	{
+		if (Connection.WebSocketKey.IsEmpty())
+		{
+			AppendUtf8(Connection.OutData, TEXT("HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\nConnection: close\r\n\r\n"));
+			Connection.bWebSocketClosing = true;
+		}
+		else
+		{
+			FTCHARToUTF8 KeyUtf8(*(Connection.WebSocketKey + TEXT("258EAFA5-E914-47DA-95CA-C5AB0DC85B11")));
+			uint8 Hash[20];
+			FSHA1::HashBuffer(KeyUtf8.Get(), KeyUtf8.Length(), Hash);
+			AppendUtf8(Connection.OutData, FString::Printf(TEXT("HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Accept: %s\r\n\r\n"),
+				*FBase64::Encode(Hash, UE_ARRAY_COUNT(Hash))));
+		}
+		Connection.bWebSocket = true;
+		return;
+	}
+
+	const bool bChunkedEncoding = Response.Mode == EYnnkLoopbackMode::Chunked || Response.Mode == EYnnkLoopbackMode::ServerSentEvents;
+	FString ContentType = Response.ContentType;
+	if (ContentType.IsEmpty())
+	{
+		ContentType = Response.Mode == EYnnkLoopbackMode::ServerSentEvents ? TEXT("text/event-stream") : TEXT("text/plain");
+	}
+
+	const double StartTime = Now + Response.InitialDelay;
+	auto AddSegment = [&Connection](double SendTime) -> TArray<uint8>&
+	{
+		FSegment& Segment = Connection.Segments.AddDefaulted_GetRef();
+		Segment.SendTime = SendTime;
+		return Segment.Data;
+	};
+	auto AddChunk = [](TArray<uint8>& Data, const FString& Text)
+	{
+		FTCHARToUTF8 Converter(*Text);
+		AppendUtf8(Data, FString::Printf(TEXT("%x\r\n"), Converter.Length()));
+		Data.Append((const uint8*)Converter.Get(), Converter.Length());
+		AppendUtf8(Data, TEXT("\r\n"));
+	};
+
+	FString Headers = FString::Printf(TEXT("HTTP/1.1 %d %s\r\nContent-Type: %s\r\nConnection: close\r\nX-Loopback-Request: %d\r\n"),
+		Response.StatusCode, GetStatusText(Response.StatusCode), *ContentType, RequestIndex);
+	if (Response.RetryAfter > 0 && (Response.StatusCode < 200 || Response.StatusCode >= 300))
+	{
+		Headers += FString::Printf(TEXT("Retry-After: %d\r\n"), Response.RetryAfter);
+	}
+	Headers += bChunkedEncoding ? TEXT("Transfer-Encoding: chunked\r\n\r\n") : FString::Printf(TEXT("Content-Length: %d\r\n\r\n"), Response.BodySize);
+	TArray<uint8>& HeaderData = AddSegment(StartTime);
+	AppendUtf8(HeaderData, Headers);
+
+	const FString Body = MakeText(Response.BodySize);
+	switch (Response.Mode)
+	{
+		case EYnnkLoopbackMode::Fixed:
+			AppendUtf8(HeaderData, Body);
+			break;
+
+		case EYnnkLoopbackMode::SlowDrip:
+		{
+			int32 PartIndex = 0;
+			for (int32 Offset = 0; Offset < Body.Len(); Offset += Response.ChunkSize)
+			{
+				AppendUtf8(AddSegment(StartTime + (++PartIndex) * Response.ChunkInterval), Body.Mid(Offset, Response.ChunkSize));
+			}
+			break;
+		}
+
+		case EYnnkLoopbackMode::Chunked:
+		{
+			int32 PartIndex = 0;
+			for (int32 Offset = 0; Offset < Body.Len(); Offset += Response.ChunkSize)
+			{
+				AddChunk(AddSegment(StartTime + (PartIndex++) * Response.ChunkInterval), Body.Mid(Offset, Response.ChunkSize));
+			}
+			AppendUtf8(AddSegment(StartTime + PartIndex * Response.ChunkInterval), TEXT("0\r\n\r\n"));
+			break;
+		}
+
+		case EYnnkLoopbackMode::ServerSentEvents:
+		{
+			// event overhead is subtracted to keep events close to ChunkSize
+			const int32 TokenSize = FMath::Max(Response.ChunkSize - 48, 1);
+			int32 PartIndex = 0;
+			for (int32 Offset = 0; Offset < Body.Len(); Offset += TokenSize)
+			{
+				AddChunk(AddSegment(StartTime + (PartIndex++) * Response.ChunkInterval), FString::Printf(TEXT("data: {\"choices\":[{\"delta\":{\"content\":\"%s\"}}]}\n\n"), *Body.Mid(Offset, TokenSize)));
+			}
+			TArray<uint8>& LastData = AddSegment(StartTime + PartIndex * Response.ChunkInterval);
+			AddChunk(LastData, TEXT("data: [DONE]\n\n"));
+			AppendUtf8(LastData, TEXT("0\r\n\r\n"));
+			break;
+		}
+	}
+}
+
+bool FYnnkHttpLoopbackServer::SendResponse(FConnection& Connection, double Now)
+{
+	while (Connection.SegmentIndex < Connection.Segments.Num())
+	{
+		const FSegment& Segment = Connection.Segments[Connection.SegmentIndex];
+		if (Segment.SendTime > Now)
+		{
+			return true;
+		}
+
+		int32 BytesSent = 0;
+		const int32 RemainingSize = Segment.Data.Num() - Connection.SegmentOffset;
+		if (RemainingSize > 0 && !Connection.Socket->Send(Segment.Data.GetData() + Connection.SegmentOffset, RemainingSize, BytesSent))
+		{
+			// socket buffer is full
+			return ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode() == SE_EWOULDBLOCK;
+		}
+
+		Connection.SegmentOffset += BytesSent;
+		if (Connection.SegmentOffset < Segment.Data.Num())
+		{
+			return true;
+		}
+		Connection.SegmentIndex++;
+		Connection.SegmentOffset = 0;
+	}
+
+	NumServed.Increment();
+	return false;
+}
+
+bool FYnnkHttpLoopbackServer::ServeWebSocket(FConnection& Connection)
+{
+	if (!Connection.bWebSocketClosing)
+	{
+		if (!ReceivePending(Connection))
+		{
+			return false;
+		}
+
+		TArray<uint8>& Data = Connection.RequestData;
+		int32 Offset = 0;
+		TArray<uint8> Payload;
+		while (Data.Num() - Offset >= 2)
+		{
+			const uint8* Frame = Data.GetData() + Offset;
+			const int32 Available = Data.Num() - Offset;
+			int64 PayloadSize = Frame[1] & 0x7F;
+			int32 HeaderSize = 2;
+			if (PayloadSize == 126)
+			{
+				if (Available < 4) break;
+				PayloadSize = (Frame[2] << 8) | Frame[3];
+				HeaderSize = 4;
+			}
+			else if (PayloadSize == 127)
+			{
+				if (Available < 10) break;
+				PayloadSize = 0;
+				for (int32 Index = 2; Index < 10; Index++)
+				{
+					PayloadSize = (PayloadSize << 8) | Frame[Index];
+				}
+				HeaderSize = 10;
+			}
+			if (PayloadSize > MaxRequestSize)
+			{
+				return false;
+			}
+
+			const bool bMasked = (Frame[1] & 0x80) != 0;
+			const uint8* Mask = Frame + HeaderSize;
+			HeaderSize += bMasked ? 4 : 0;
+			if (Available < HeaderSize + PayloadSize)
+			{
+				break;
+			}
+
+			Payload.SetNumUninitialized((int32)PayloadSize, YNNK_NO_SHRINK);
+			for (int32 Index = 0; Index < PayloadSize; Index++)
+			{
+				Payload[Index] = Frame[HeaderSize + Index] ^ (bMasked ? Mask[Index % 4] : 0);
+			}
+
+			const uint8 Opcode = Frame[0] & 0x0F;
+			if (Opcode == 0x9)
+			{
+				// ping
+				AppendWebSocketFrame(Connection.OutData, 0x8A, Payload.GetData(), Payload.Num());
+			}
+			else if (Opcode == 0x8)
+			{
+				// close is echoed too, then connection is closed
+				AppendWebSocketFrame(Connection.OutData, 0x88, Payload.GetData(), Payload.Num());
+				Connection.bWebSocketClosing = true;
+			}
+			else if (Opcode != 0xA)
+			{
+				// text, binary or continuation frame with the same FIN bit
+				AppendWebSocketFrame(Connection.OutData, Frame[0] & 0x8F, Payload.GetData(), Payload.Num());
+				if (Frame[0] & 0x80)
+				{
+					NumServed.Increment();
+				}
+			}
+			Offset += HeaderSize + (int32)PayloadSize;
+			if (Connection.bWebSocketClosing)
+			{
+				break;
+			}
+		}
+		Data.RemoveAt(0, Offset, YNNK_NO_SHRINK);
+	}
+
+	while (Connection.OutOffset < Connection.OutData.Num())
+	{
+		int32 BytesSent = 0;
+		if (!Connection.Socket->Send(Connection.OutData.GetData() + Connection.OutOffset, Connection.OutData.Num() - Connection.OutOffset, BytesSent))
+		{
+			return ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode() == SE_EWOULDBLOCK;
+		}
+		if (BytesSent == 0)
+		{
+			return true;
+		}
+		Connection.OutOffset += BytesSent;
+	}
+	Connection.OutData.Reset();
+	Connection.OutOffset = 0;
+
+	return !Connection.bWebSocketClosing;
+}
+
+void FYnnkHttpLoopbackServer::CloseConnection(FConnection& Connection)
+{
+	if (Connection.Socket)
+	{
+		Connection.Socket->Close();
+		ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Connection.Socket);
+		Connection.Socket = nullptr;
+	}
+}
+
+#endif
@@ -0,0 +1,161 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+
+#if !UE_BUILD_SHIPPING
+
+class FSocket;
+class FRunnableThread;
+
+enum class EYnnkLoopbackMode : uint8
+{
+	// Content-Length body sent at once
+	Fixed,
+	// Transfer-Encoding: chunked
+	Chunked,
+	// text/event-stream with OpenAI-like "data:" events
+	ServerSentEvents,
+	// Content-Length body sent in small parts with delays
+	SlowDrip,
+	// WebSocket upgrade; messages are echoed back, ping is answered with pong
+	WebSocketEcho
+};
+
+/**
+* Response of loopback server route. Values can be overridden by query parameters:
+* size, chunk, interval, delay, status, retryafter (e.g. /sse?size=4096&chunk=64&interval=0.01).
+* delay and status can be comma-separated lists indexed by number of previous requests to the same path and query,
+* the last value is repeated (e.g. /fixed?status=503,200 fails once).
+*/
+struct FYnnkLoopbackResponse
+{
+	EYnnkLoopbackMode Mode = EYnnkLoopbackMode::Fixed;
+	int32 StatusCode = 200;
+	// Body size (bytes)
+	int32 BodySize = 1024;
+	// Size of chunk or part of body for stream modes
+	int32 ChunkSize = 256;
+	// Delay between chunks (seconds)
+	float ChunkInterval = 0.f;
+	// Delay before headers (seconds)
+	float InitialDelay = 0.f;
+	// Retry-After header (seconds) of error responses, 0 to skip it
+	int32 RetryAfter = 0;
+	// Empty to use default type of the mode
+	FString ContentType;
+};
+
+/**
+* Minimal HTTP/1.1 server on 127.0.0.1 for benchmarks and load tests.
+* Serves all connections from one thread with non-blocking sockets, every response closes connection.
+*/
+class FYnnkHttpLoopbackServer : public FRunnable
+{
+public:
+	FYnnkHttpLoopbackServer();
+	virtual ~FYnnkHttpLoopbackServer();
+
+	/** Add default routes: /fixed, /chunked, /sse, /drip, /ws */
+	void AddDefaultRoutes();
+
+	/** Set response for path (without query) */
+	void AddRoute(const FString& Path, const FYnnkLoopbackResponse& Response);
+
+	/** Start listening. Port 0 selects free port. */
+	bool Start(int32 Port = 0);
+
+	/** Close all connections and stop thread */
+	void Shutdown();
+
+	bool IsRunning() const
+	{
+		return Thread != nullptr;
+	}
+
+	int32 GetPort() const
+	{
+		return ListenPort;
+	}
+
+	FString GetUrl(const FString& PathAndQuery) const;
+
+	/** ws:// url of the server */
+	FString GetWebSocketUrl(const FString& PathAndQuery) const;
+
+	/** Number of requests received for path and query */
+	int32 GetNumRequests(const FString& PathAndQuery) const;
+
+	/** Number of responses sent completely (and WebSocket messages echoed) */
+	int32 GetNumServed() const
+	{
+		return NumServed.GetValue();
+	}
+
+	// FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	struct FSegment
+	{
+		double SendTime = 0.0;
+		TArray<uint8> Data;
+	};
+
+	struct FConnection
+	{
+		FSocket* Socket = nullptr;
+		TArray<uint8> RequestData;
+		int32 HeaderSize = INDEX_NONE;
+		int32 ContentLength = 0;
+		FString RequestLine;
+		TArray<FSegment> Segments;
+		int32 SegmentIndex = 0;
+		int32 SegmentOffset = 0;
+		bool bResponding = false;
+
+		// upgraded to WebSocket
+		FString WebSocketKey;
+		bool bWebSocket = false;
+		bool bWebSocketClosing = false;
+		TArray<uint8> OutData;
+		int32 OutOffset = 0;
+	};
+
+	/** Append available data of socket to RequestData. Returns false if connection is broken. */
+	bool ReceivePending(FConnection& Connection);
+
+	/** Read request and prepare response. Returns false if connection should be closed. */
+	bool ReadRequest(FConnection& Connection);
+
+	/** Send response segments which are due. Returns false when finished or failed. */
+	bool SendResponse(FConnection& Connection, double Now);
+
+	void BuildResponse(FConnection& Connection, const FString& RequestLine, double Now);
+
+	/** Echo received WebSocket frames. Returns false when connection should be closed. */
+	bool ServeWebSocket(FConnection& Connection);
+
+	void CloseConnection(FConnection& Connection);
+
+	mutable FCriticalSection RoutesLock;
+	TMap<FString, FYnnkLoopbackResponse> Routes;
+	// requests received by path and query (guarded by RoutesLock)
+	TMap<FString, int32> NumRequests;
+
+	FSocket* ListenSocket = nullptr;
+	FRunnableThread* Thread = nullptr;
+	int32 ListenPort = 0;
+	FThreadSafeBool bStopping;
+	FThreadSafeCounter NumServed;
+	TArray<FConnection> Connections;
+};
+
+#endif
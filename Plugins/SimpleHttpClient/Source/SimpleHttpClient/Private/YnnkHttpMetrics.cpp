@@ -0,0 +1,250 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkHttpMetrics.h"
+#include "YnnkHttpPrivate.h"
+
+DEFINE_STAT(STAT_YnnkHttpActiveRequests);
+DEFINE_STAT(STAT_YnnkHttpCompletedRequests);
+DEFINE_STAT(STAT_YnnkHttpFailedRequests);
+DEFINE_STAT(STAT_YnnkHttpReceivedKB);
+DEFINE_STAT(STAT_YnnkHttpReusedConnections);
+DEFINE_STAT(STAT_YnnkHttpLastTimeToFirstByte);
+DEFINE_STAT(STAT_YnnkHttpLastTotalTime);
+DEFINE_STAT(STAT_YnnkHttpTimeToFirstByteP50);
+DEFINE_STAT(STAT_YnnkHttpTimeToFirstByteP90);
+DEFINE_STAT(STAT_YnnkHttpTimeToFirstTokenP90);
+DEFINE_STAT(STAT_YnnkHttpTotalTimeP90);
+
+// lower bound of the first bucket and ratio of neighbour buckets
+constexpr float HistogramBase = 0.0001f;
+constexpr float HistogramStep = 1.25f;
+
+FYnnkRollingHistogram::FYnnkRollingHistogram(int32 InWindowSize)
+{
+	Samples.SetNumZeroed(FMath::Max(InWindowSize, 1));
+	FMemory::Memzero(BucketCounts);
+}
+
+int32 FYnnkRollingHistogram::GetBucket(float Value)
+{
+	if (Value <= HistogramBase)
+	{
+		return 0;
+	}
+	const int32 Bucket = FMath::FloorToInt(FMath::Loge(Value / HistogramBase) / FMath::Loge(HistogramStep));
+	return FMath::Clamp(Bucket, 0, NumBuckets - 1);
+}
+
+float FYnnkRollingHistogram::GetBucketUpperBound(int32 Bucket)
+{
+	return HistogramBase * FMath::Pow(HistogramStep, (float)(Bucket + 1));
+}
+
+void FYnnkRollingHistogram::Add(float Value)
+{
+	Value = FMath::Max(Value, 0.f);
+
+	if (NumSamples == Samples.Num())
+	{
+		// forget the oldest sample
+		const float OldValue = Samples[NextSample];
+		BucketCounts[GetBucket(OldValue)]--;
+		Sum -= OldValue;
+	}
+	else
+	{
+		NumSamples++;
+	}
+
+	Samples[NextSample] = Value;
+	NextSample = (NextSample + 1) % Samples.Num();
+	BucketCounts[GetBucket(Value)]++;
+	Sum += Value;
+}
+
+void FYnnkRollingHistogram::Reset()
+{
+	NextSample = 0;
+	NumSamples = 0;
+	Sum = 0.0;
+	FMemory::Memzero(BucketCounts);
+}
+
+float FYnnkRollingHistogram::GetPercentile(float Percentile) const
+{
+	const int32 Target = FMath::Max(FMath::CeilToInt(Percentile * NumSamples), 1);
+	int32 Counted = 0;
+	for (int32 Bucket = 0; Bucket < NumBuckets; Bucket++)
+	{
+		Counted += BucketCounts[Bucket];
+		if (Counted >= Target)
+		{
+			return GetBucketUpperBound(Bucket);
+		}
+	}
+	return GetBucketUpperBound(NumBuckets - 1);
+}
+
+FYnnkHttpMetricStats FYnnkRollingHistogram::GetStats() const
+{
+	FYnnkHttpMetricStats Stats;
+	if (NumSamples == 0)
+	{
+		return Stats;
+	}
+
+	for (int32 Index = 0; Index < NumSamples; Index++)
+	{
+		Stats.Max = FMath::Max(Stats.Max, Samples[Index]);
+	}
+	Stats.Count = NumSamples;
+	Stats.Mean = (float)(Sum / NumSamples);
+	// bucket bound can exceed the real value
+	Stats.P50 = FMath::Min(GetPercentile(0.5f), Stats.Max);
+	Stats.P90 = FMath::Min(GetPercentile(0.9f), Stats.Max);
+	Stats.P99 = FMath::Min(GetPercentile(0.99f), Stats.Max);
+	return Stats;
+}
+
+void FYnnkHttpMetrics::FGroup::Add(const FYnnkHttpRequestMetrics& Metrics)
+{
+	NumRequests++;
+	if (!Metrics.bSucceeded)
+	{
+		NumFailed++;
+	}
+	BytesReceived += Metrics.BytesReceived;
+	if (Metrics.bReusedConnection)
+	{
+		NumReusedConnections++;
+	}
+
+	QueueTime.Add(Metrics.QueueTime);
+	TotalTime.Add(Metrics.TotalTime);
+	if (Metrics.ConnectTime > 0.f)
+	{
+		ConnectTime.Add(Metrics.ConnectTime);
+	}
+	if (Metrics.TimeToFirstByte > 0.f)
+	{
+		TimeToFirstByte.Add(Metrics.TimeToFirstByte);
+	}
+	if (Metrics.TimeToFirstToken > 0.f)
+	{
+		TimeToFirstToken.Add(Metrics.TimeToFirstToken);
+	}
+	if (Metrics.ChunksReceived > 1)
+	{
+		ChunkInterval.Add(Metrics.MeanChunkInterval);
+	}
+}
+
+void FYnnkHttpMetrics::FGroup::GetSnapshot(const FString& Name, FYnnkHttpMetricsSnapshot& OutSnapshot) const
+{
+	OutSnapshot.Name = Name;
+	OutSnapshot.NumRequests = NumRequests;
+	OutSnapshot.NumFailed = NumFailed;
+	OutSnapshot.BytesReceived = BytesReceived;
+	OutSnapshot.NumReusedConnections = NumReusedConnections;
+	OutSnapshot.ConnectionReuseRate = NumRequests > 0 ? (float)NumReusedConnections / NumRequests : 0.f;
+	OutSnapshot.QueueTime = QueueTime.GetStats();
+	OutSnapshot.ConnectTime = ConnectTime.GetStats();
+	OutSnapshot.TimeToFirstByte = TimeToFirstByte.GetStats();
+	OutSnapshot.TimeToFirstToken = TimeToFirstToken.GetStats();
+	OutSnapshot.TotalTime = TotalTime.GetStats();
+	OutSnapshot.ChunkInterval = ChunkInterval.GetStats();
+}
+
+FYnnkHttpMetrics::FGroup& FYnnkHttpMetrics::FindOrAddGroup(TMap<FName, FGroup>& Groups, FName Name)
+{
+	if (FGroup* Group = Groups.Find(Name))
+	{
+		return *Group;
+	}
+	return Groups.Add(Name, FGroup(WindowSize));
+}
+
+void FYnnkHttpMetrics::Record(const FYnnkHttpRequestMetrics& Metrics)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	Total.Add(Metrics);
+	FindOrAddGroup(Keywords, Metrics.Keyword).Add(Metrics);
+	FindOrAddGroup(Hosts, FName(*Metrics.Host)).Add(Metrics);
+
+	INC_DWORD_STAT(STAT_YnnkHttpCompletedRequests);
+	if (!Metrics.bSucceeded)
+	{
+		INC_DWORD_STAT(STAT_YnnkHttpFailedRequests);
+	}
+	INC_DWORD_STAT_BY(STAT_YnnkHttpReceivedKB, (uint32)(Metrics.BytesReceived / 1024));
+	if (Metrics.bReusedConnection)
+	{
+		INC_DWORD_STAT(STAT_YnnkHttpReusedConnections);
+	}
+	SET_FLOAT_STAT(STAT_YnnkHttpLastTimeToFirstByte, Metrics.TimeToFirstByte * 1000.f);
+	SET_FLOAT_STAT(STAT_YnnkHttpLastTotalTime, Metrics.TotalTime * 1000.f);
+#if STATS
+	const FYnnkHttpMetricStats FirstByte = Total.TimeToFirstByte.GetStats();
+	SET_FLOAT_STAT(STAT_YnnkHttpTimeToFirstByteP50, FirstByte.P50 * 1000.f);
+	SET_FLOAT_STAT(STAT_YnnkHttpTimeToFirstByteP90, FirstByte.P90 * 1000.f);
+	SET_FLOAT_STAT(STAT_YnnkHttpTimeToFirstTokenP90, Total.TimeToFirstToken.GetStats().P90 * 1000.f);
+	SET_FLOAT_STAT(STAT_YnnkHttpTotalTimeP90, Total.TotalTime.GetStats().P90 * 1000.f);
+#endif
+}
+
+void FYnnkHttpMetrics::Reset()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	Total = FGroup(WindowSize);
+	Keywords.Empty();
+	Hosts.Empty();
+}
+
+bool FYnnkHttpMetrics::GetKeywordSnapshot(FName Keyword, FYnnkHttpMetricsSnapshot& OutSnapshot) const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	if (const FGroup* Group = Keywords.Find(Keyword))
+	{
+		Group->GetSnapshot(Keyword.ToString(), OutSnapshot);
+		return true;
+	}
+	return false;
+}
+
+bool FYnnkHttpMetrics::GetHostSnapshot(const FString& Host, FYnnkHttpMetricsSnapshot& OutSnapshot) const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	if (const FGroup* Group = Hosts.Find(FName(*Host, FNAME_Find)))
+	{
+		Group->GetSnapshot(Host, OutSnapshot);
+		return true;
+	}
+	return false;
+}
+
+void FYnnkHttpMetrics::GetTotalSnapshot(FYnnkHttpMetricsSnapshot& OutSnapshot) const
+{
+	FScopeLock ScopeLock(&Lock);
+	Total.GetSnapshot(TEXT("All"), OutSnapshot);
+}
+
+void FYnnkHttpMetrics::GetAllSnapshots(TArray<FYnnkHttpMetricsSnapshot>& OutKeywords, TArray<FYnnkHttpMetricsSnapshot>& OutHosts) const
+{
+	FScopeLock ScopeLock(&Lock);
+
+	OutKeywords.Reset(Keywords.Num());
+	for (const auto& Group : Keywords)
+	{
+		Group.Value.GetSnapshot(Group.Key.ToString(), OutKeywords.AddDefaulted_GetRef());
+	}
+	OutHosts.Reset(Hosts.Num());
+	for (const auto& Group : Hosts)
+	{
+		Group.Value.GetSnapshot(Group.Key.ToString(), OutHosts.AddDefaulted_GetRef());
+	}
+}
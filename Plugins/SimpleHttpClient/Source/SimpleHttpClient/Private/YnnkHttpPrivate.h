@@ -0,0 +1,47 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include "Stats/Stats.h"
+
+// TArray/FString shrinking argument was changed to enum in 5.4
+#if ENGINE_MINOR_VERSION > 3
+#define YNNK_NO_SHRINK EAllowShrinking::No
+#else
+#define YNNK_NO_SHRINK false
+#endif
+
+// stat SimpleHttpClient
+DECLARE_STATS_GROUP(TEXT("SimpleHttpClient"), STATGROUP_SimpleHttpClient, STATCAT_Advanced);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Active Requests"), STAT_YnnkHttpActiveRequests, STATGROUP_SimpleHttpClient, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Completed Requests"), STAT_YnnkHttpCompletedRequests, STATGROUP_SimpleHttpClient, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Failed Requests"), STAT_YnnkHttpFailedRequests, STATGROUP_SimpleHttpClient, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Received (KB)"), STAT_YnnkHttpReceivedKB, STATGROUP_SimpleHttpClient, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Reused Connections"), STAT_YnnkHttpReusedConnections, STATGROUP_SimpleHttpClient, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Last TTFB (ms)"), STAT_YnnkHttpLastTimeToFirstByte, STATGROUP_SimpleHttpClient, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Last Total Time (ms)"), STAT_YnnkHttpLastTotalTime, STATGROUP_SimpleHttpClient, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("TTFB P50 (ms)"), STAT_YnnkHttpTimeToFirstByteP50, STATGROUP_SimpleHttpClient, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("TTFB P90 (ms)"), STAT_YnnkHttpTimeToFirstByteP90, STATGROUP_SimpleHttpClient, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Time to First Token P90 (ms)"), STAT_YnnkHttpTimeToFirstTokenP90, STATGROUP_SimpleHttpClient, );
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Total Time P90 (ms)"), STAT_YnnkHttpTotalTimeP90, STATGROUP_SimpleHttpClient, );
+
+namespace YnnkHttp
+{
+	/** Convert UTF-8 data to string reusing its memory */
+	inline void Utf8ToString(FString& OutString, const uint8* Data, int32 Size)
+	{
+		TArray<TCHAR>& Chars = OutString.GetCharArray();
+		const int32 Length = Size > 0 ? FPlatformString::ConvertedLength<TCHAR>((const UTF8CHAR*)Data, Size) : 0;
+		if (Length == 0)
+		{
+			Chars.Reset();
+			return;
+		}
+		Chars.SetNumUninitialized(Length + 1, YNNK_NO_SHRINK);
+		FPlatformString::Convert(Chars.GetData(), Length, (const UTF8CHAR*)Data, Size);
+		Chars[Length] = TCHAR('\0');
+	}
+}
@@ -0,0 +1,327 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkHttpRecording.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Hash/CityHash.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Async/Async.h"
+#include "HTTPSubsystem.h"
+#include "YnnkHttpPrivate.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Parse.h"
+
+constexpr uint32 RecordingMagic = 0x52484E59; // YNHR
+constexpr int32 RecordingVersion = 1;
+
+static const TCHAR* RecordingExtension = TEXT(".ynnkrec");
+
+void FYnnkHttpRecording::AddChunk(double Time, const uint8* Data, int64 Size)
+{
+	FChunk& Chunk = Chunks.AddDefaulted_GetRef();
+	Chunk.Time = Time;
+	Chunk.Offset = StreamData.Num();
+	Chunk.Size = (int32)Size;
+	StreamData.Append(Data, Size);
+}
+
+FString FYnnkHttpRecording::GetHeader(const FString& Name) const
+{
+	for (const FString& Header : Headers)
+	{
+		FString HeaderName, Value;
+		if (Header.Split(TEXT(":"), &HeaderName, &Value) && HeaderName.TrimStartAndEnd().Equals(Name, ESearchCase::IgnoreCase))
+		{
+			return Value.TrimStartAndEnd();
+		}
+	}
+	return FString();
+}
+
+void FYnnkHttpRecording::Serialize(FArchive& Ar)
+{
+	uint32 Magic = RecordingMagic;
+	int32 Version = RecordingVersion;
+	Ar << Magic << Version;
+	if (Ar.IsLoading() && (Magic != RecordingMagic || Version > RecordingVersion))
+	{
+		Ar.SetError();
+		return;
+	}
+
+	Ar << Keyword << Verb << URL << RequestHash;
+	Ar << bHasResponse << bSucceeded << ResponseCode << ContentType << Headers;
+	Ar << HeadersTime << TotalTime;
+	Ar << Chunks << StreamData << Content;
+}
+
+namespace
+{
+	/**
+	* Hashes body in blocks skipping multipart boundary, which is generated for every body
+	* and would make hashes of equal requests different
+	*/
+	class FBodyHasher
+	{
+	public:
+		FBodyHasher(uint64 InHash, const FString& ContentType)
+			: Hash(InHash)
+		{
+			FString BoundaryString;
+			if (ContentType.Split(TEXT("boundary="), nullptr, &BoundaryString))
+			{
+				FTCHARToUTF8 Utf8(*BoundaryString.TrimQuotes());
+				Boundary.Append((const uint8*)Utf8.Get(), Utf8.Length());
+			}
+		}
+
+		void Update(const uint8* Data, int32 Size)
+		{
+			if (Boundary.Num() == 0)
+			{
+				HashRange(Data, Size);
+				return;
+			}
+
+			Pending.Append(Data, Size);
+			int32 Start = 0;
+			int32 Index = 0;
+			while (Index + Boundary.Num() <= Pending.Num())
+			{
+				if (Pending[Index] == Boundary[0] && FMemory::Memcmp(Pending.GetData() + Index, Boundary.GetData(), Boundary.Num()) == 0)
+				{
+					HashRange(Pending.GetData() + Start, Index - Start);
+					Index += Boundary.Num();
+					Start = Index;
+				}
+				else
+				{
+					Index++;
+				}
+			}
+			// tail can be the beginning of boundary continued in the next block
+			HashRange(Pending.GetData() + Start, Index - Start);
+			Pending.RemoveAt(0, Index, YNNK_NO_SHRINK);
+		}
+
+		uint64 Finish()
+		{
+			HashRange(Pending.GetData(), Pending.Num());
+			Pending.Reset();
+			return Hash;
+		}
+
+	private:
+		void HashRange(const uint8* Data, int32 Size)
+		{
+			if (Size > 0)
+			{
+				Hash = CityHash64WithSeed((const char*)Data, Size, Hash);
+			}
+		}
+
+		uint64 Hash;
+		TArray<uint8> Boundary;
+		TArray<uint8> Pending;
+	};
+}
+
+FString FYnnkHttpRecording::MakeRequestHash(const IHttpRequest& Request, const FString& BodyFileName, FArchive* BodyStream)
+{
+	const FTCHARToUTF8 Verb(*Request.GetVerb());
+	const FTCHARToUTF8 URL(*Request.GetURL());
+
+	uint64 Hash = CityHash64(Verb.Get(), Verb.Length());
+	Hash = CityHash64WithSeed(URL.Get(), URL.Length(), Hash);
+
+	if (!BodyFileName.IsEmpty())
+	{
+		// file isn't read: path and size identify the body
+		const FTCHARToUTF8 FileName(*FPaths::GetCleanFilename(BodyFileName));
+		const int64 FileSize = IFileManager::Get().FileSize(*BodyFileName);
+		Hash = CityHash64WithSeed(FileName.Get(), FileName.Length(), Hash);
+		Hash = CityHash64WithSeed((const char*)&FileSize, sizeof(FileSize), Hash);
+		return FString::Printf(TEXT("%016llx"), Hash);
+	}
+
+	FBodyHasher Hasher(Hash, Request.GetHeader(TEXT("Content-Type")));
+	if (BodyStream)
+	{
+		// read stream in blocks and rewind it for http module
+		const int64 StartPos = BodyStream->Tell();
+		BodyStream->Seek(0);
+		uint8 Block[16384];
+		for (int64 Remaining = BodyStream->TotalSize(); Remaining > 0 && !BodyStream->IsError(); )
+		{
+			const int32 BlockSize = (int32)FMath::Min<int64>(Remaining, sizeof(Block));
+			BodyStream->Serialize(Block, BlockSize);
+			Hasher.Update(Block, BlockSize);
+			Remaining -= BlockSize;
+		}
+		BodyStream->Seek(StartPos);
+	}
+	else
+	{
+		const TArray<uint8>& Body = Request.GetContent();
+		Hasher.Update(Body.GetData(), Body.Num());
+	}
+	return FString::Printf(TEXT("%016llx"), Hasher.Finish());
+}
+
+void FYnnkHttpReplayIndex::Scan(const FString& Directory)
+{
+	FilesByHash.Empty();
+	FilesByKeyword.Empty();
+	NextByHash.Empty();
+	NextByKeyword.Empty();
+	Loaded.Empty();
+	NumFiles = 0;
+
+	TArray<FString> KeywordDirs;
+	IFileManager::Get().FindFiles(KeywordDirs, *(Directory / TEXT("*")), false, true);
+	for (const FString& KeywordDir : KeywordDirs)
+	{
+		TArray<FString> Files;
+		IFileManager::Get().FindFiles(Files, *(Directory / KeywordDir / TEXT("*") + RecordingExtension), true, false);
+
+		// <Hash>_<Session>_<N>: recording order is defined by the part after hash
+		Files.Sort([](const FString& A, const FString& B)
+		{
+			int32 PosA, PosB;
+			A.FindChar(TEXT('_'), PosA);
+			B.FindChar(TEXT('_'), PosB);
+			return FCString::Strcmp(*A + PosA + 1, *B + PosB + 1) < 0;
+		});
+
+		TArray<FString>& KeywordFiles = FilesByKeyword.FindOrAdd(FName(*KeywordDir));
+		for (const FString& File : Files)
+		{
+			FString Hash, Rest;
+			if (!File.Split(TEXT("_"), &Hash, &Rest))
+			{
+				continue;
+			}
+			const FString FullName = Directory / KeywordDir / File;
+			FilesByHash.FindOrAdd(Hash).Add(FullName);
+			KeywordFiles.Add(FullName);
+			NumFiles++;
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("Found %d http recordings in %s"), NumFiles, *Directory);
+}
+
+TSharedPtr<const FYnnkHttpRecording> FYnnkHttpReplayIndex::Find(FName Keyword, const FString& RequestHash)
+{
+	const TArray<FString>* Files = FilesByHash.Find(RequestHash);
+	int32* Next = nullptr;
+	if (Files)
+	{
+		Next = &NextByHash.FindOrAdd(RequestHash);
+	}
+	else
+	{
+		Files = FilesByKeyword.Find(Keyword);
+		Next = &NextByKeyword.FindOrAdd(Keyword);
+	}
+	if (!Files || Files->Num() == 0)
+	{
+		return nullptr;
+	}
+
+	const FString& FileName = (*Files)[*Next % Files->Num()];
+	*Next = (*Next + 1) % Files->Num();
+	return Load(FileName);
+}
+
+TSharedPtr<const FYnnkHttpRecording> FYnnkHttpReplayIndex::Load(const FString& FileName)
+{
+	if (const TSharedPtr<const FYnnkHttpRecording>* Cached = Loaded.Find(FileName))
+	{
+		return *Cached;
+	}
+
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *FileName))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Unable to read http recording %s"), *FileName);
+		return nullptr;
+	}
+
+	TSharedPtr<FYnnkHttpRecording> Recording = MakeShared<FYnnkHttpRecording>();
+	FMemoryReader Reader(Data);
+	Recording->Serialize(Reader);
+	if (Reader.IsError())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Invalid http recording %s"), *FileName);
+		return nullptr;
+	}
+
+	Loaded.Add(FileName, Recording);
+	return Recording;
+}
+
+FString FYnnkHttpReplayIndex::MakeFileName(const FString& Directory, FName Keyword, const FString& RequestHash, const FString& Session, int32 Index)
+{
+	return Directory / Keyword.ToString() / FString::Printf(TEXT("%s_%s_%05d"), *RequestHash, *Session, Index) + RecordingExtension;
+}
+
+void FYnnkHttpReplayIndex::SaveAsync(TSharedPtr<FYnnkHttpRecording, ESPMode::ThreadSafe> Recording, const FString& FileName)
+{
+	Async(EAsyncExecution::ThreadPool, [Recording, FileName]()
+	{
+		TArray<uint8> Data;
+		FMemoryWriter Writer(Data);
+		Recording->Serialize(Writer);
+
+		IFileManager::Get().MakeDirectory(*FPaths::GetPath(FileName), true);
+		if (!FFileHelper::SaveArrayToFile(Data, *FileName))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Unable to save http recording %s"), *FileName);
+		}
+	});
+}
+
+#if !UE_BUILD_SHIPPING
+
+namespace
+{
+	void SetTransportCommand(const TArray<FString>& Args)
+	{
+		UHTTPSubsystem* HttpSubsystem = GEngine ? GEngine->GetEngineSubsystem<UHTTPSubsystem>() : nullptr;
+		if (!HttpSubsystem || Args.Num() == 0)
+		{
+			return;
+		}
+
+		EYnnkHttpTransportMode Mode = EYnnkHttpTransportMode::Live;
+		if (Args[0].Equals(TEXT("Record"), ESearchCase::IgnoreCase))
+		{
+			Mode = EYnnkHttpTransportMode::Record;
+		}
+		else if (Args[0].Equals(TEXT("Replay"), ESearchCase::IgnoreCase))
+		{
+			Mode = EYnnkHttpTransportMode::Replay;
+		}
+
+		const FString Params = FString::Join(Args, TEXT(" "));
+		FString Directory;
+		FParse::Value(*Params, TEXT("Dir="), Directory);
+		FParse::Value(*Params, TEXT("Speed="), HttpSubsystem->ReplaySpeed);
+
+		HttpSubsystem->SetTransportMode(Mode, Directory);
+		UE_LOG(LogTemp, Display, TEXT("SimpleHttp transport: %s, directory %s, replay speed %.2f"), *Args[0], *HttpSubsystem->GetRecordingDirectory(), HttpSubsystem->ReplaySpeed);
+	}
+}
+
+static FAutoConsoleCommand SimpleHttpTransportCommand(
+	TEXT("SimpleHttp.Transport"),
+	TEXT("Switch UHTTPSubsystem transport. Usage: SimpleHttp.Transport Live|Record|Replay [Dir=<directory>] [Speed=1.0]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&SetTransportCommand));
+
+#endif
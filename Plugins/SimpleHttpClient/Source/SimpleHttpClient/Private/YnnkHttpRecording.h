@@ -0,0 +1,97 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IHttpRequest;
+
+/**
+* Recorded http session: request identity, response and timing of stream chunks.
+* Times are seconds since the request was passed to http module.
+*/
+struct FYnnkHttpRecording
+{
+	struct FChunk
+	{
+		double Time = 0.0;
+		int32 Offset = 0;
+		int32 Size = 0;
+
+		friend FArchive& operator<<(FArchive& Ar, FChunk& Chunk)
+		{
+			Ar << Chunk.Time << Chunk.Offset << Chunk.Size;
+			return Ar;
+		}
+	};
+
+	FString Keyword;
+	FString Verb;
+	FString URL;
+	FString RequestHash;
+
+	// false if request failed without response
+	bool bHasResponse = false;
+	bool bSucceeded = false;
+	int32 ResponseCode = 0;
+	FString ContentType;
+	TArray<FString> Headers;
+
+	double HeadersTime = 0.0;
+	double TotalTime = 0.0;
+
+	// Raw chunks received by stream delegate (before decompression)
+	TArray<FChunk> Chunks;
+	TArray<uint8> StreamData;
+
+	// Body of response received without stream delegate
+	TArray<uint8> Content;
+
+	void AddChunk(double Time, const uint8* Data, int64 Size);
+
+	FString GetHeader(const FString& Name) const;
+
+	void Serialize(FArchive& Ar);
+
+	/**
+	* Hash of verb, URL and body used to match requests on replay.
+	* Body is content of the request, BodyStream if set (read and rewound) or name and size of streamed BodyFileName.
+	* Multipart boundary is excluded, because it's different for every body.
+	*/
+	static FString MakeRequestHash(const IHttpRequest& Request, const FString& BodyFileName = FString(), FArchive* BodyStream = nullptr);
+};
+
+/**
+* Recordings found in directory (<Dir>/<Keyword>/<Hash>_<Session>_<N>.ynnkrec).
+* Request is matched by hash first and by keyword if body or URL changed.
+* Every match is used in recording order and the sequence is repeated after the last one.
+*/
+class FYnnkHttpReplayIndex
+{
+public:
+	void Scan(const FString& Directory);
+
+	TSharedPtr<const FYnnkHttpRecording> Find(FName Keyword, const FString& RequestHash);
+
+	int32 Num() const
+	{
+		return NumFiles;
+	}
+
+	/** File name for new recording */
+	static FString MakeFileName(const FString& Directory, FName Keyword, const FString& RequestHash, const FString& Session, int32 Index);
+
+	/** Write recording to file in background thread */
+	static void SaveAsync(TSharedPtr<FYnnkHttpRecording, ESPMode::ThreadSafe> Recording, const FString& FileName);
+
+private:
+	TSharedPtr<const FYnnkHttpRecording> Load(const FString& FileName);
+
+	TMap<FString, TArray<FString>> FilesByHash;
+	TMap<FName, TArray<FString>> FilesByKeyword;
+	TMap<FString, int32> NextByHash;
+	TMap<FName, int32> NextByKeyword;
+	TMap<FString, TSharedPtr<const FYnnkHttpRecording>> Loaded;
+	int32 NumFiles = 0;
+};
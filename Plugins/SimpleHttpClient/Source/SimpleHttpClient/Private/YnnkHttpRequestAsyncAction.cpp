@@ -0,0 +1,116 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkHttpRequestAsyncAction.h"
+#include "HTTPSubsystem.h"
+#include "Engine/Engine.h"
+#include "Async/Async.h"
+
+UYnnkHttpRequestAsyncAction* UYnnkHttpRequestAsyncAction::SendHttpRequestAsync(UObject* WorldContextObject, FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FString& BodyString,
+	const FYnnkHttpRequestOptions& Options, EExpectedResponseType ExpectedResponseFormat, bool bWantHeaders)
+{
+	UYnnkHttpRequestAsyncAction* Action = NewObject<UYnnkHttpRequestAsyncAction>();
+	Action->HttpSubsystem = GEngine ? GEngine->GetEngineSubsystem<UHTTPSubsystem>() : nullptr;
+	Action->Keyword = Keyword;
+	Action->URL = URL;
+	Action->Verb = Verb;
+	Action->HeaderParams = HeaderParams;
+	Action->BodyString = BodyString;
+	Action->Options = Options;
+	Action->ExpectedResponseFormat = ExpectedResponseFormat;
+	Action->bWantHeaders = bWantHeaders;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void UYnnkHttpRequestAsyncAction::Activate()
+{
+	if (!HttpSubsystem)
+	{
+		OnFailed.Broadcast(0, TArray<FString>(), FString(), TArray<uint8>());
+		SetReadyToDestroy();
+		return;
+	}
+
+	FYnnkHttpRequestCallbacks Callbacks;
+	Callbacks.OnComplete.BindUObject(this, &UYnnkHttpRequestAsyncAction::HandleComplete);
+	if (OnChunk.IsBound())
+	{
+		Callbacks.OnTextChunk.BindUObject(this, &UYnnkHttpRequestAsyncAction::HandleTextChunk);
+		Callbacks.OnDataChunk.BindUObject(this, &UYnnkHttpRequestAsyncAction::HandleDataChunk);
+	}
+
+	RequestHandle = HttpSubsystem->SendRequest(Keyword, URL, Verb, HeaderParams, BodyString, ExpectedResponseFormat, Options, MoveTemp(Callbacks));
+	BodyString.Empty();
+}
+
+void UYnnkHttpRequestAsyncAction::Cancel()
+{
+	if (HttpSubsystem)
+	{
+		HttpSubsystem->CancelRequest(RequestHandle);
+	}
+}
+
+void UYnnkHttpRequestAsyncAction::HandleTextChunk(FStringView Text)
+{
+	if (IsInGameThread())
+	{
+		OnChunk.Broadcast(0, TArray<FString>(), FString(Text), TArray<uint8>());
+	}
+	else
+	{
+		AsyncTask(ENamedThreads::GameThread, [WeakThis = TWeakObjectPtr<UYnnkHttpRequestAsyncAction>(this), Chunk = FString(Text)]()
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->OnChunk.Broadcast(0, TArray<FString>(), Chunk, TArray<uint8>());
+			}
+		});
+	}
+}
+
+void UYnnkHttpRequestAsyncAction::HandleDataChunk(TArrayView<const uint8> Data)
+{
+	if (IsInGameThread())
+	{
+		OnChunk.Broadcast(0, TArray<FString>(), FString(), TArray<uint8>(Data.GetData(), Data.Num()));
+	}
+	else
+	{
+		AsyncTask(ENamedThreads::GameThread, [WeakThis = TWeakObjectPtr<UYnnkHttpRequestAsyncAction>(this), Chunk = TArray<uint8>(Data.GetData(), Data.Num())]()
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->OnChunk.Broadcast(0, TArray<FString>(), FString(), Chunk);
+			}
+		});
+	}
+}
+
+void UYnnkHttpRequestAsyncAction::HandleComplete(const FYnnkHttpResponse& Response)
+{
+	if (!IsInGameThread())
+	{
+		// chunks queued before are broadcasted first
+		AsyncTask(ENamedThreads::GameThread, [WeakThis = TWeakObjectPtr<UYnnkHttpRequestAsyncAction>(this), Response]()
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->HandleComplete(Response);
+			}
+		});
+		return;
+	}
+
+	const TArray<FString> Headers = bWantHeaders ? Response.Headers.ToArray() : TArray<FString>();
+	if (Response.IsOk())
+	{
+		OnCompleted.Broadcast(Response.Code, Headers, Response.Text, Response.Data);
+	}
+	else
+	{
+		OnFailed.Broadcast(Response.Code, Headers, Response.Text, Response.Data);
+	}
+	SetReadyToDestroy();
+}
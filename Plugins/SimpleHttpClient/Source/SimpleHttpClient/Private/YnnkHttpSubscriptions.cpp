@@ -0,0 +1,48 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkHttpSubscriptions.h"
+
+namespace
+{
+	template<typename DelegateType>
+	void RemoveListener(TArray<DelegateType>& Events, const UObject* Listener)
+	{
+		Events.RemoveAll([Listener](const DelegateType& Event)
+		{
+			return !Event.IsBound() || Event.IsBoundToObject(Listener);
+		});
+	}
+}
+
+void FYnnkHttpSubscriptions::Remove(FName Keyword, const UObject* Listener)
+{
+	FScopeLock Lock(&SubscribersLock);
+
+	for (auto It = Subscribers.CreateIterator(); It; ++It)
+	{
+		if (!Keyword.IsNone() && It.Key() != Keyword)
+		{
+			continue;
+		}
+
+		FSubscribers& KeywordSubscribers = It.Value();
+		RemoveListener(KeywordSubscribers.TextStream, Listener);
+		RemoveListener(KeywordSubscribers.DataStream, Listener);
+		RemoveListener(KeywordSubscribers.TextResponse, Listener);
+		RemoveListener(KeywordSubscribers.DataResponse, Listener);
+		RemoveListener(KeywordSubscribers.Error, Listener);
+		if (KeywordSubscribers.IsEmpty())
+		{
+			It.RemoveCurrent();
+		}
+	}
+	NumKeywords.Set(Subscribers.Num());
+}
+
+void FYnnkHttpSubscriptions::Reset()
+{
+	FScopeLock Lock(&SubscribersLock);
+	Subscribers.Empty();
+	NumKeywords.Set(0);
+}
@@ -0,0 +1,35 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkHttpTrace.h"
+
+#if YNNK_HTTP_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_DEFINE(SimpleHttpChannel)
+
+UE_TRACE_EVENT_BEGIN(SimpleHttp, RequestEvent)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, ThreadId)
+	UE_TRACE_EVENT_FIELD(uint8, Type)
+	UE_TRACE_EVENT_FIELD(int32, RequestId)
+	UE_TRACE_EVENT_FIELD(int64, Size)
+	UE_TRACE_EVENT_FIELD(int32, Code)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Keyword)
+UE_TRACE_EVENT_END()
+
+void YnnkHttpTrace::OutputRequestEvent(EEventType Type, int32 RequestId, FName Keyword, int64 Size, int32 Code)
+{
+	TCHAR KeywordBuffer[NAME_SIZE];
+	const uint32 KeywordLength = Keyword.IsNone() ? 0 : Keyword.ToString(KeywordBuffer);
+
+	UE_TRACE_LOG(SimpleHttp, RequestEvent, SimpleHttpChannel)
+		<< RequestEvent.Cycle(FPlatformTime::Cycles64())
+		<< RequestEvent.ThreadId(FPlatformTLS::GetCurrentThreadId())
+		<< RequestEvent.Type((uint8)Type)
+		<< RequestEvent.RequestId(RequestId)
+		<< RequestEvent.Size(Size)
+		<< RequestEvent.Code(Code)
+		<< RequestEvent.Keyword(KeywordBuffer, KeywordLength);
+}
+
+#endif
@@ -0,0 +1,55 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+// Capture with -trace=cpu,SimpleHttp (or "Trace.Enable SimpleHttp"). Nothing is evaluated while the channel is off.
+#if UE_TRACE_ENABLED && CPUPROFILERTRACE_ENABLED && !UE_BUILD_SHIPPING
+#define YNNK_HTTP_TRACE_ENABLED 1
+#else
+#define YNNK_HTTP_TRACE_ENABLED 0
+#endif
+
+#if YNNK_HTTP_TRACE_ENABLED
+
+UE_TRACE_CHANNEL_EXTERN(SimpleHttpChannel)
+
+namespace YnnkHttpTrace
+{
+	enum class EEventType : uint8
+	{
+		Created,
+		Started,
+		Chunk,
+		Completed,
+		Dispatched,
+		JsonParse,
+		JsonSerialize,
+		Cancelled
+	};
+
+	/** Write event of the request to trace (called only if channel is enabled) */
+	void OutputRequestEvent(EEventType Type, int32 RequestId, FName Keyword, int64 Size, int32 Code);
+}
+
+#define YNNK_HTTP_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(Name, SimpleHttpChannel)
+
+#define YNNK_HTTP_TRACE_EVENT(Type, RequestId, Keyword, Size, Code) \
+	do \
+	{ \
+		if (UE_TRACE_CHANNELEXPR_IS_ENABLED(SimpleHttpChannel)) \
+		{ \
+			YnnkHttpTrace::OutputRequestEvent(YnnkHttpTrace::EEventType::Type, RequestId, Keyword, Size, Code); \
+		} \
+	} while (0)
+
+#else
+
+#define YNNK_HTTP_TRACE_SCOPE(Name)
+#define YNNK_HTTP_TRACE_EVENT(Type, RequestId, Keyword, Size, Code) do {} while (0)
+
+#endif
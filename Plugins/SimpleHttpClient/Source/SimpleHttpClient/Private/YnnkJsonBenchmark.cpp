@@ -0,0 +1,378 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "CoreMinimal.h"
+
+#if !UE_BUILD_SHIPPING
+
+#include "YnnkHttpTypes.h"
+#include "JsonItemFunctionsLibrary.h"
+#include "YnnkCountingMalloc.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+
+/**
+* Microbenchmarks of FJsonItem and UJsonItemFunctionsLibrary.
+* SimpleHttp.JsonBenchmark [Time=0.2] [Filter=<substring>] [Baseline=<file.json>] [Out=<file.json>] [Threshold=10]
+*/
+namespace YnnkJsonBenchmark
+{
+	// result of benchmarked call is written here so it isn't optimized out
+	static volatile int32 Sink = 0;
+
+	struct FCase
+	{
+		FString Name;
+		TFunction<void()> Run;
+	};
+
+	struct FResult
+	{
+		FString Name;
+		int64 Iterations = 0;
+		double NanosecondsPerOp = 0.0;
+		double AllocationsPerOp = 0.0;
+		double BytesPerOp = 0.0;
+	};
+
+	FString MakeChatHistory(int32 NumTurns)
+	{
+		FString Result = TEXT("{\"model\":\"gpt-4o-mini\",\"temperature\":0.7,\"stream\":false,\"stop\":[],\"messages\":[")
+			TEXT("{\"role\":\"system\",\"content\":\"You are a friendly character in a video game. Answer briefly.\"}");
+		for (int32 Turn = 0; Turn < NumTurns; Turn++)
+		{
+			Result += FString::Printf(TEXT(",{\"role\":\"%s\",\"content\":\"Turn %d. The weather in the valley is changing, and the traveller asks about the road to the old mill near the river.\"}"),
+				Turn % 2 == 0 ? TEXT("user") : TEXT("assistant"), Turn);
+		}
+		Result += TEXT("]}");
+		return Result;
+	}
+
+	FString MakeEmbeddingResponse(int32 Dimensions)
+	{
+		FString Result = TEXT("{\"object\":\"list\",\"data\":[{\"object\":\"embedding\",\"index\":0,\"embedding\":[");
+		FRandomStream Random(Dimensions);
+		for (int32 Index = 0; Index < Dimensions; Index++)
+		{
+			if (Index > 0)
+			{
+				Result += TEXT(",");
+			}
+			Result += FString::Printf(TEXT("%.6f"), Random.FRandRange(-0.1f, 0.1f));
+		}
+		Result += TEXT("]}],\"model\":\"text-embedding-3-small\",\"usage\":{\"prompt_tokens\":8,\"total_tokens\":8}}");
+		return Result;
+	}
+
+	FString MakeSseEvent(int32 Index)
+	{
+		return FString::Printf(TEXT("data: {\"id\":\"chatcmpl-1\",\"object\":\"chat.completion.chunk\",\"choices\":[{\"index\":0,\"delta\":{\"content\":\"token%d \"},\"finish_reason\":null}]}\n\n"), Index);
+	}
+
+	FString MakeSseStream(int32 NumEvents)
+	{
+		FString Result;
+		for (int32 Index = 0; Index < NumEvents; Index++)
+		{
+			Result += MakeSseEvent(Index);
+		}
+		Result += TEXT("data: [DONE]\n\n");
+		return Result;
+	}
+
+	TArray<FCase> MakeCases()
+	{
+		TArray<FCase> Cases;
+		auto Add = [&Cases](const FString& Name, TFunction<void()>&& Run)
+		{
+			Cases.Add({ Name, MoveTemp(Run) });
+		};
+
+		for (const int32 NumTurns : { 10, 100, 1000 })
+		{
+			const FString Corpus = FString::Printf(TEXT("chat_%d"), NumTurns);
+			const FString Chat = MakeChatHistory(NumTurns);
+			FJsonItem Item;
+			Item.FromString(Chat);
+
+			Add(TEXT("JsonItemFromString/") + Corpus, [Chat]()
+			{
+				FJsonItem Result;
+				Sink = UJsonItemFunctionsLibrary::JsonItemFromString(Chat, Result);
+			});
+			Add(TEXT("GetString/") + Corpus, [Item]()
+			{
+				Sink = UJsonItemFunctionsLibrary::JsonGetFieldValue_String(Item, TEXT("model")).Len();
+			});
+			Add(TEXT("GetNumeric/") + Corpus, [Item]()
+			{
+				Sink = (int32)UJsonItemFunctionsLibrary::JsonGetFieldValue_Numeric(Item, TEXT("temperature"));
+			});
+			Add(TEXT("GetBool/") + Corpus, [Item]()
+			{
+				Sink = UJsonItemFunctionsLibrary::JsonGetFieldValue_Bool(Item, TEXT("stream"));
+			});
+			Add(TEXT("GetByIndex/") + Corpus, [Item]()
+			{
+				Sink = UJsonItemFunctionsLibrary::JsonGetFieldValue_String(Item, TEXT("messages[1].content")).Len();
+			});
+			Add(TEXT("GetByPredicate/") + Corpus, [Item]()
+			{
+				Sink = UJsonItemFunctionsLibrary::JsonGetFieldValue_String(Item, TEXT("messages[role=system].content")).Len();
+			});
+			// the same value is set every time, so the item doesn't change between iterations
+			Add(TEXT("SetString/") + Corpus, [Item]() mutable
+			{
+				Sink = UJsonItemFunctionsLibrary::JsonSetFieldValue_String(Item, TEXT("model"), TEXT("gpt-4o-mini"));
+			});
+			Add(TEXT("SetNumeric/") + Corpus, [Item]() mutable
+			{
+				Sink = UJsonItemFunctionsLibrary::JsonSetFieldValue_Numeric(Item, TEXT("temperature"), 0.7f);
+			});
+			Add(TEXT("SetBool/") + Corpus, [Item]() mutable
+			{
+				Sink = UJsonItemFunctionsLibrary::JsonSetFieldValue_Bool(Item, TEXT("stream"), false);
+			});
+
+			// array grows by one item per call and is reset after NumTurns calls, so copy of the original item is amortized
+			auto AddGrowing = [&Add, &Corpus, NumTurns](const FString& Name, const FJsonItem& Original, TFunction<bool(FJsonItem&)>&& AddItem)
+			{
+				Add(Name + TEXT("/") + Corpus, [Original, Grown = Original, AddItem = MoveTemp(AddItem), NumTurns, NumAdded = 0]() mutable
+				{
+					if (NumAdded == NumTurns)
+					{
+						Grown = Original;
+						NumAdded = 0;
+					}
+					NumAdded++;
+					Sink = AddItem(Grown);
+				});
+			};
+
+			FJsonItem NewMessage;
+			NewMessage.FromString(TEXT("{\"role\":\"user\",\"content\":\"One more question about the mill.\"}"));
+			AddGrowing(TEXT("AddArrayItem"), Item, [NewMessage](FJsonItem& Target)
+			{
+				return UJsonItemFunctionsLibrary::JsonAddArrayItem(Target, TEXT("messages"), NewMessage);
+			});
+			AddGrowing(TEXT("AddArrayItemString"), Item, [](FJsonItem& Target)
+			{
+				return UJsonItemFunctionsLibrary::JsonAddArrayItemString(Target, TEXT("stop"), TEXT("\n"));
+			});
+
+			FJsonItem ItemWithArrays = Item;
+			ItemWithArrays.SetArrayValue(TEXT("scores"), TEXT("[]"));
+			ItemWithArrays.SetArrayValue(TEXT("flags"), TEXT("[]"));
+			AddGrowing(TEXT("AddArrayItemNumeric"), ItemWithArrays, [](FJsonItem& Target)
+			{
+				return UJsonItemFunctionsLibrary::JsonAddArrayItemNumeric(Target, TEXT("scores"), 0.25f);
+			});
+			AddGrowing(TEXT("AddArrayItemBool"), ItemWithArrays, [](FJsonItem& Target)
+			{
+				return UJsonItemFunctionsLibrary::JsonAddArrayItemBool(Target, TEXT("flags"), true);
+			});
+		}
+
+		const FString Embedding = MakeEmbeddingResponse(1536);
+		FJsonItem EmbeddingItem;
+		EmbeddingItem.FromString(Embedding);
+		Add(TEXT("JsonItemFromString/embedding_1536"), [Embedding]()
+		{
+			FJsonItem Result;
+			Sink = UJsonItemFunctionsLibrary::JsonItemFromString(Embedding, Result);
+		});
+		Add(TEXT("GetString/embedding_1536"), [EmbeddingItem]()
+		{
+			Sink = UJsonItemFunctionsLibrary::JsonGetFieldValue_String(EmbeddingItem, TEXT("model")).Len();
+		});
+		Add(TEXT("GetNumeric/embedding_1536"), [EmbeddingItem]()
+		{
+			Sink = (int32)UJsonItemFunctionsLibrary::JsonGetFieldValue_Numeric(EmbeddingItem, TEXT("usage.total_tokens"));
+		});
+
+		const FString SseStream = MakeSseStream(200);
+		const FString SseEvent = MakeSseEvent(0);
+		Add(TEXT("ExtractJsonBlockFromString/sse_200_all"), [SseStream]()
+		{
+			int32 SearchStart = 0, BlockStart = 0, BlockLength = 0, NumBlocks = 0;
+			FJsonItem Block;
+			while (UJsonItemFunctionsLibrary::ExtractJsonBlockFromString(SseStream, SearchStart, BlockStart, BlockLength, Block))
+			{
+				SearchStart = BlockStart + BlockLength;
+				NumBlocks++;
+			}
+			Sink = NumBlocks;
+		});
+		Add(TEXT("ExtractJsonBlockFromString/sse_event"), [SseEvent]()
+		{
+			int32 BlockStart = 0, BlockLength = 0;
+			FJsonItem Block;
+			Sink = UJsonItemFunctionsLibrary::ExtractJsonBlockFromString(SseEvent, 0, BlockStart, BlockLength, Block);
+		});
+		Add(TEXT("CleanJsonResponse/sse_event"), [SseEvent]()
+		{
+			Sink = UJsonItemFunctionsLibrary::CleanJsonResponse(SseEvent).Len();
+		});
+		Add(TEXT("CleanJsonResponseInline/sse_event"), [SseEvent]()
+		{
+			FString Text = SseEvent;
+			UJsonItemFunctionsLibrary::CleanJsonResponseInline(Text);
+			Sink = Text.Len();
+		});
+
+		return Cases;
+	}
+
+	FResult RunCase(const FCase& Case, double MinTime)
+	{
+		FResult Result;
+		Result.Name = Case.Name;
+
+		// warm up caches and lazy initialization
+		Case.Run();
+
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		const double EndTime = FPlatformTime::Seconds() + MinTime;
+		do
+		{
+			Case.Run();
+			Result.Iterations++;
+		}
+		while (Result.Iterations < 10 || FPlatformTime::Seconds() < EndTime);
+		Result.NanosecondsPerOp = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles) * 1.0e9 / Result.Iterations;
+
+		// allocations are counted in a separate pass to keep timing clean
+		const int32 CountedIterations = (int32)FMath::Min<int64>(Result.Iterations, 16);
+		FYnnkAllocationCounter Allocations;
+		{
+			FYnnkAllocationScope AllocationScope(Allocations);
+			for (int32 Index = 0; Index < CountedIterations; Index++)
+			{
+				Case.Run();
+			}
+		}
+		Result.AllocationsPerOp = (double)Allocations.NumAllocations / CountedIterations;
+		Result.BytesPerOp = (double)Allocations.AllocatedSize / CountedIterations;
+
+		return Result;
+	}
+
+	bool SaveResults(const TArray<FResult>& Results, const FString& FileName)
+	{
+		TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+		Root->SetStringField(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+
+		TArray<TSharedPtr<FJsonValue>> Items;
+		for (const FResult& Result : Results)
+		{
+			TSharedRef<FJsonObject> Item = MakeShared<FJsonObject>();
+			Item->SetStringField(TEXT("name"), Result.Name);
+			Item->SetNumberField(TEXT("iterations"), (double)Result.Iterations);
+			Item->SetNumberField(TEXT("ns_per_op"), Result.NanosecondsPerOp);
+			Item->SetNumberField(TEXT("allocs_per_op"), Result.AllocationsPerOp);
+			Item->SetNumberField(TEXT("bytes_per_op"), Result.BytesPerOp);
+			Items.Add(MakeShared<FJsonValueObject>(Item));
+		}
+		Root->SetArrayField(TEXT("results"), Items);
+
+		FString Output;
+		const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Output);
+		FJsonSerializer::Serialize(Root, Writer);
+		return FFileHelper::SaveStringToFile(Output, *FileName);
+	}
+
+	bool LoadResults(const FString& FileName, TMap<FString, FResult>& OutResults)
+	{
+		FString Input;
+		TSharedPtr<FJsonObject> Root;
+		if (!FFileHelper::LoadFileToString(Input, *FileName) || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Input), Root) || !Root.IsValid())
+		{
+			return false;
+		}
+
+		const TArray<TSharedPtr<FJsonValue>>* Items = nullptr;
+		if (!Root->TryGetArrayField(TEXT("results"), Items))
+		{
+			return false;
+		}
+		for (const TSharedPtr<FJsonValue>& Value : *Items)
+		{
+			const TSharedPtr<FJsonObject> Item = Value->AsObject();
+			if (!Item.IsValid())
+			{
+				continue;
+			}
+			FResult Result;
+			Result.Name = Item->GetStringField(TEXT("name"));
+			Result.NanosecondsPerOp = Item->GetNumberField(TEXT("ns_per_op"));
+			Result.AllocationsPerOp = Item->GetNumberField(TEXT("allocs_per_op"));
+			Result.BytesPerOp = Item->GetNumberField(TEXT("bytes_per_op"));
+			OutResults.Add(Result.Name, Result);
+		}
+		return true;
+	}
+
+	void RunCommand(const TArray<FString>& Args)
+	{
+		const FString Params = FString::Join(Args, TEXT(" "));
+		float MinTime = 0.2f;
+		float Threshold = 10.f;
+		FString Filter, BaselineFile;
+		FString OutputFile = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / FString::Printf(TEXT("SimpleHttpJson-%s.json"), *FDateTime::Now().ToString());
+		FParse::Value(*Params, TEXT("Time="), MinTime);
+		FParse::Value(*Params, TEXT("Threshold="), Threshold);
+		FParse::Value(*Params, TEXT("Filter="), Filter);
+		FParse::Value(*Params, TEXT("Baseline="), BaselineFile);
+		FParse::Value(*Params, TEXT("Out="), OutputFile);
+
+		TMap<FString, FResult> Baseline;
+		if (!BaselineFile.IsEmpty() && !LoadResults(BaselineFile, Baseline))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("SimpleHttp.JsonBenchmark: unable to read baseline %s"), *BaselineFile);
+		}
+
+		TArray<FResult> Results;
+		int32 NumRegressions = 0;
+		for (const FCase& Case : MakeCases())
+		{
+			if (!Filter.IsEmpty() && !Case.Name.Contains(Filter))
+			{
+				continue;
+			}
+
+			const FResult& Result = Results.Add_GetRef(RunCase(Case, MinTime));
+			FString Comparison;
+			if (const FResult* Base = Baseline.Find(Result.Name))
+			{
+				const double TimeChange = Base->NanosecondsPerOp > 0.0 ? (Result.NanosecondsPerOp / Base->NanosecondsPerOp - 1.0) * 100.0 : 0.0;
+				const bool bRegression = TimeChange > Threshold || Result.AllocationsPerOp > Base->AllocationsPerOp + 0.5;
+				NumRegressions += bRegression ? 1 : 0;
+				Comparison = FString::Printf(TEXT("  %+6.1f%% time, %+.1f allocs%s"), TimeChange, Result.AllocationsPerOp - Base->AllocationsPerOp, bRegression ? TEXT("  REGRESSION") : TEXT(""));
+			}
+			UE_LOG(LogTemp, Display, TEXT("%-48s %12.0f ns/op %8.1f allocs/op %10.0f B/op%s"), *Result.Name, Result.NanosecondsPerOp, Result.AllocationsPerOp, Result.BytesPerOp, *Comparison);
+		}
+
+		if (NumRegressions > 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("SimpleHttp.JsonBenchmark: %d regressions against %s"), NumRegressions, *BaselineFile);
+		}
+		if (SaveResults(Results, OutputFile))
+		{
+			UE_LOG(LogTemp, Display, TEXT("SimpleHttp.JsonBenchmark results saved to %s"), *OutputFile);
+		}
+	}
+}
+
+static FAutoConsoleCommand SimpleHttpJsonBenchmarkCommand(
+	TEXT("SimpleHttp.JsonBenchmark"),
+	TEXT("Run FJsonItem microbenchmarks. Usage: SimpleHttp.JsonBenchmark [Time=0.2] [Filter=<name>] [Baseline=<file.json>] [Out=<file.json>] [Threshold=10]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&YnnkJsonBenchmark::RunCommand));
+
+#endif
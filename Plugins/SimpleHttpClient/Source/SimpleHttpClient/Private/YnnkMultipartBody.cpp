@@ -0,0 +1,280 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkMultipartBody.h"
+#include "HTTPSubsystem.h"
+#include "YnnkHttpPrivate.h"
+#include "HAL/FileManager.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+#include "Serialization/Archive.h"
+
+namespace
+{
+	/** Quotes and line breaks aren't allowed in Content-Disposition parameters */
+	FString EscapeDispositionValue(const FString& Value)
+	{
+		return Value.Replace(TEXT("\""), TEXT("%22")).Replace(TEXT("\r"), TEXT("%0D")).Replace(TEXT("\n"), TEXT("%0A"));
+	}
+}
+
+/**
+* Reads segments of multipart body one by one. Files are opened when reader reaches them.
+*/
+class FYnnkMultipartReader final : public FArchive
+{
+public:
+	explicit FYnnkMultipartReader(TArray<FYnnkMultipartBody::FSegment>&& InSegments)
+		: Segments(MoveTemp(InSegments))
+	{
+		SetIsLoading(true);
+		Offsets.Reserve(Segments.Num());
+		for (const FYnnkMultipartBody::FSegment& Segment : Segments)
+		{
+			Offsets.Add(TotalBytes);
+			TotalBytes += Segment.Size;
+		}
+	}
+
+	virtual void Serialize(void* Data, int64 Length) override
+	{
+		uint8* Dest = (uint8*)Data;
+		while (Length > 0)
+		{
+			if (Position >= TotalBytes)
+			{
+				break;
+			}
+			while (Position >= Offsets[Current] + Segments[Current].Size)
+			{
+				Current++;
+			}
+
+			const FYnnkMultipartBody::FSegment& Segment = Segments[Current];
+			const int64 Offset = Position - Offsets[Current];
+			const int64 Size = FMath::Min(Length, Segment.Size - Offset);
+			if (Segment.Bytes.IsValid())
+			{
+				FMemory::Memcpy(Dest, Segment.Bytes->GetData() + Offset, Size);
+			}
+			else if (!ReadFile(Segment, Offset, Dest, Size))
+			{
+				break;
+			}
+			Dest += Size;
+			Length -= Size;
+			Position += Size;
+		}
+
+		if (Length > 0)
+		{
+			FMemory::Memzero(Dest, Length);
+			SetError();
+		}
+	}
+
+	virtual void Seek(int64 InPos) override
+	{
+		Position = FMath::Clamp<int64>(InPos, 0, TotalBytes);
+		if (Current >= Segments.Num() || Position < Offsets[Current])
+		{
+			Current = 0;
+		}
+	}
+
+	virtual int64 Tell() override { return Position; }
+	virtual int64 TotalSize() override { return TotalBytes; }
+
+	virtual bool Close() override
+	{
+		FileReader.Reset();
+		return !IsError();
+	}
+
+	virtual FString GetArchiveName() const override { return TEXT("FYnnkMultipartReader"); }
+
+private:
+	bool ReadFile(const FYnnkMultipartBody::FSegment& Segment, int64 Offset, uint8* Dest, int64 Size)
+	{
+		if (FileSegment != Current)
+		{
+			FileReader.Reset(IFileManager::Get().CreateFileReader(*Segment.FilePath));
+			FileSegment = Current;
+		}
+		if (!FileReader.IsValid() || FileReader->TotalSize() < Offset + Size)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("FYnnkMultipartReader: unable to read file %s or its size was changed"), *Segment.FilePath);
+			FileReader.Reset();
+			FileSegment = INDEX_NONE;
+			return false;
+		}
+
+		if (FileReader->Tell() != Offset)
+		{
+			FileReader->Seek(Offset);
+		}
+		FileReader->Serialize(Dest, Size);
+		const bool bSuccess = !FileReader->IsError();
+
+		// don't keep the file open until the whole body is sent
+		if (!bSuccess || Offset + Size == Segment.Size)
+		{
+			FileReader.Reset();
+			FileSegment = INDEX_NONE;
+		}
+		return bSuccess;
+	}
+
+	TArray<FYnnkMultipartBody::FSegment> Segments;
+	TArray<int64> Offsets;
+	int64 TotalBytes = 0;
+	int64 Position = 0;
+	int32 Current = 0;
+
+	TUniquePtr<FArchive> FileReader;
+	int32 FileSegment = INDEX_NONE;
+};
+
+FYnnkMultipartBody::FYnnkMultipartBody()
+{
+	Boundary = TEXT("----YnnkFormBoundary") + FGuid::NewGuid().ToString(EGuidFormats::Digits);
+}
+
+void FYnnkMultipartBody::AppendInline(const FString& Text)
+{
+	if (!InlineBytes.IsValid())
+	{
+		InlineBytes = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>();
+		FSegment& Segment = Segments.AddDefaulted_GetRef();
+		Segment.Bytes = InlineBytes;
+	}
+	FTCHARToUTF8 Utf8(*Text);
+	InlineBytes->Append((const uint8*)Utf8.Get(), Utf8.Length());
+	Segments.Last().Size = InlineBytes->Num();
+}
+
+void FYnnkMultipartBody::AppendPartHeader(const FString& Name, const FString& FileName, const FString& ContentType)
+{
+	FString Header = TEXT("--") + Boundary + TEXT("\r\nContent-Disposition: form-data; name=\"") + EscapeDispositionValue(Name) + TEXT("\"");
+	if (!FileName.IsEmpty())
+	{
+		Header += TEXT("; filename=\"") + EscapeDispositionValue(FileName) + TEXT("\"");
+	}
+	if (!ContentType.IsEmpty())
+	{
+		Header += TEXT("\r\nContent-Type: ") + ContentType;
+	}
+	Header += TEXT("\r\n\r\n");
+	AppendInline(Header);
+	NumParts++;
+}
+
+void FYnnkMultipartBody::AddText(const FString& Name, const FString& Value)
+{
+	AppendPartHeader(Name, FString(), FString());
+	AppendInline(Value + TEXT("\r\n"));
+}
+
+void FYnnkMultipartBody::AddData(const FString& Name, TSharedRef<const TArray<uint8>, ESPMode::ThreadSafe> Data, const FString& FileName, const FString& ContentType)
+{
+	const FString PartFileName = FileName.IsEmpty() ? Name : FileName;
+	AppendPartHeader(Name, PartFileName, ContentType.IsEmpty() ? FString(UHTTPSubsystem::GetContentTypeForFile(PartFileName)) : ContentType);
+	if (Data->Num() > 0)
+	{
+		FSegment& Segment = Segments.AddDefaulted_GetRef();
+		Segment.Size = Data->Num();
+		Segment.Bytes = MoveTemp(Data);
+		InlineBytes.Reset();
+	}
+	AppendInline(TEXT("\r\n"));
+}
+
+void FYnnkMultipartBody::AddData(const FString& Name, TArray<uint8>&& Data, const FString& FileName, const FString& ContentType)
+{
+	AddData(Name, MakeShared<const TArray<uint8>, ESPMode::ThreadSafe>(MoveTemp(Data)), FileName, ContentType);
+}
+
+bool FYnnkMultipartBody::AddFile(const FString& Name, const FString& FilePath, const FString& FileName, const FString& ContentType)
+{
+	const int64 FileSize = IFileManager::Get().FileSize(*FilePath);
+	if (FileSize < 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FYnnkMultipartBody: file %s doesn't exist"), *FilePath);
+		return false;
+	}
+
+	AppendPartHeader(Name,
+		FileName.IsEmpty() ? FPaths::GetCleanFilename(FilePath) : FileName,
+		ContentType.IsEmpty() ? FString(UHTTPSubsystem::GetContentTypeForFile(FilePath)) : ContentType);
+	if (FileSize > 0)
+	{
+		FSegment& Segment = Segments.AddDefaulted_GetRef();
+		Segment.FilePath = FilePath;
+		Segment.Size = FileSize;
+		InlineBytes.Reset();
+	}
+	AppendInline(TEXT("\r\n"));
+	return true;
+}
+
+bool FYnnkMultipartBody::AddPart(const FYnnkMultipartPart& Part)
+{
+	if (!Part.FilePath.IsEmpty())
+	{
+		return AddFile(Part.Name, Part.FilePath, Part.FileName, Part.ContentType);
+	}
+	if (Part.Data.Num() > 0)
+	{
+		AddData(Part.Name, MakeShared<const TArray<uint8>, ESPMode::ThreadSafe>(Part.Data), Part.FileName, Part.ContentType);
+		return true;
+	}
+	AddText(Part.Name, Part.Value);
+	return true;
+}
+
+FString FYnnkMultipartBody::GetContentType() const
+{
+	return TEXT("multipart/form-data; boundary=") + Boundary;
+}
+
+int64 FYnnkMultipartBody::GetContentLength() const
+{
+	// "--" + Boundary + "--\r\n"
+	int64 Length = Boundary.Len() + 6;
+	for (const FSegment& Segment : Segments)
+	{
+		Length += Segment.Size;
+	}
+	return Length;
+}
+
+TSharedRef<FArchive, ESPMode::ThreadSafe> FYnnkMultipartBody::CreateReader() const
+{
+	TArray<FSegment> ReaderSegments;
+	ReaderSegments.Reserve(Segments.Num() + 1);
+	ReaderSegments.Append(Segments);
+
+	// builder can still extend its last segment, so reader gets a copy of it with closing boundary
+	TSharedRef<TArray<uint8>, ESPMode::ThreadSafe> Tail = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>();
+	if (InlineBytes.IsValid())
+	{
+		*Tail = *InlineBytes;
+		ReaderSegments.Pop(YNNK_NO_SHRINK);
+	}
+	const FTCHARToUTF8 Closing(*(TEXT("--") + Boundary + TEXT("--\r\n")));
+	Tail->Append((const uint8*)Closing.Get(), Closing.Length());
+
+	FSegment& TailSegment = ReaderSegments.AddDefaulted_GetRef();
+	TailSegment.Size = Tail->Num();
+	TailSegment.Bytes = Tail;
+
+	return MakeShared<FYnnkMultipartReader, ESPMode::ThreadSafe>(MoveTemp(ReaderSegments));
+}
+
+bool FYnnkMultipartBody::ReadToArray(TArray<uint8>& OutData) const
+{
+	const TSharedRef<FArchive, ESPMode::ThreadSafe> Reader = CreateReader();
+	OutData.SetNumUninitialized((int32)Reader->TotalSize());
+	Reader->Serialize(OutData.GetData(), OutData.Num());
+	return !Reader->IsError();
+}
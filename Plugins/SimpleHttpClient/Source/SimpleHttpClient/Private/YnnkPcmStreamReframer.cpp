@@ -0,0 +1,266 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkPcmStreamReframer.h"
+
+// stream is treated as raw PCM if "data" chunk isn't found in this size
+constexpr int32 MaxWavHeaderSize = 65536;
+
+namespace
+{
+	uint16 ReadUInt16(const uint8* Data)
+	{
+		return (uint16)Data[0] | ((uint16)Data[1] << 8);
+	}
+
+	uint32 ReadUInt32(const uint8* Data)
+	{
+		return (uint32)Data[0] | ((uint32)Data[1] << 8) | ((uint32)Data[2] << 16) | ((uint32)Data[3] << 24);
+	}
+
+	bool IsChunkId(const uint8* Data, const char* Id)
+	{
+		return FMemory::Memcmp(Data, Id, 4) == 0;
+	}
+}
+
+void FYnnkPcmStreamReframer::Init(const FYnnkAudioStreamSettings& InSettings)
+{
+	Settings = InSettings;
+	bFormatKnown = false;
+	HeaderData.Reset();
+	ReadPos = 0;
+	UsedSize = 0;
+	bPrerollDone = false;
+}
+
+void FYnnkPcmStreamReframer::SetFormat(const FYnnkPcmFormat& InFormat)
+{
+	if (!InFormat.IsValid())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("FYnnkPcmStreamReframer: invalid PCM format (%d Hz, %d channels, %d bits)"), InFormat.SampleRate, InFormat.NumChannels, InFormat.BitsPerSample);
+		return;
+	}
+
+	Format = InFormat;
+	bFormatKnown = true;
+
+	const int32 BlockAlign = Format.GetBlockAlign();
+	FrameSize = FMath::Max(FMath::RoundToInt(Settings.FrameDuration * Format.SampleRate), 1) * BlockAlign;
+	PrerollSize = FMath::Max(Settings.PrerollFrames, 0) * FrameSize;
+	bPrerollDone = PrerollSize == 0;
+
+	const int32 Capacity = FMath::Max(FMath::CeilToInt(Settings.ReframeBufferDuration * Format.GetByteRate()), PrerollSize + FrameSize * 2);
+	if (Buffer.Num() != Capacity)
+	{
+		Buffer.SetNumUninitialized(Capacity);
+	}
+	if (FrameData.Num() != FrameSize)
+	{
+		FrameData.SetNumUninitialized(FrameSize);
+	}
+	ReadPos = 0;
+	UsedSize = 0;
+}
+
+FYnnkPcmStreamReframer::EHeaderResult FYnnkPcmStreamReframer::ParseWavHeader(int32& OutDataOffset)
+{
+	const uint8* Data = HeaderData.GetData();
+	const int32 Size = HeaderData.Num();
+
+	if (Size < 12)
+	{
+		return EHeaderResult::NeedMoreData;
+	}
+	if (!IsChunkId(Data, "RIFF") || !IsChunkId(Data + 8, "WAVE"))
+	{
+		return EHeaderResult::Invalid;
+	}
+
+	FYnnkPcmFormat NewFormat;
+	bool bHasFormat = false;
+	int32 Pos = 12;
+	while (true)
+	{
+		if (Pos + 8 > Size)
+		{
+			return EHeaderResult::NeedMoreData;
+		}
+
+		const uint8* ChunkId = Data + Pos;
+		const uint32 ChunkSize = ReadUInt32(Data + Pos + 4);
+
+		if (IsChunkId(ChunkId, "data"))
+		{
+			// size of data chunk is often unknown in streams, so it isn't checked
+			if (!bHasFormat)
+			{
+				return EHeaderResult::Invalid;
+			}
+			SetFormat(NewFormat);
+			OutDataOffset = Pos + 8;
+			return bFormatKnown ? EHeaderResult::Done : EHeaderResult::Invalid;
+		}
+
+		// chunks are padded to even size
+		const int64 NextPos = (int64)Pos + 8 + ChunkSize + (ChunkSize & 1);
+		if (NextPos > Size)
+		{
+			return EHeaderResult::NeedMoreData;
+		}
+
+		if (IsChunkId(ChunkId, "fmt "))
+		{
+			if (ChunkSize < 16)
+			{
+				return EHeaderResult::Invalid;
+			}
+			const uint8* Fmt = Data + Pos + 8;
+			uint16 AudioFormat = ReadUInt16(Fmt);
+			NewFormat.NumChannels = ReadUInt16(Fmt + 2);
+			NewFormat.SampleRate = (int32)ReadUInt32(Fmt + 4);
+			NewFormat.BitsPerSample = ReadUInt16(Fmt + 14);
+
+			// WAVE_FORMAT_EXTENSIBLE: actual format is in the first bytes of SubFormat GUID
+			if (AudioFormat == 0xFFFE && ChunkSize >= 40)
+			{
+				AudioFormat = ReadUInt16(Fmt + 24);
+			}
+			// 1 = PCM, 3 = IEEE float
+			if (AudioFormat != 1 && AudioFormat != 3)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("FYnnkPcmStreamReframer: unsupported WAV format %d"), AudioFormat);
+				return EHeaderResult::Invalid;
+			}
+			NewFormat.bFloat = AudioFormat == 3;
+			bHasFormat = true;
+		}
+
+		Pos = (int32)NextPos;
+	}
+}
+
+void FYnnkPcmStreamReframer::Process(const uint8* Data, int32 Size, TFunctionRef<void(TArrayView<const uint8>)> OnFrame)
+{
+	if (Size <= 0)
+	{
+		return;
+	}
+
+	if (!bFormatKnown)
+	{
+		HeaderData.Append(Data, Size);
+		if (HeaderData.Num() < 4)
+		{
+			return;
+		}
+
+		if (!IsChunkId(HeaderData.GetData(), "RIFF"))
+		{
+			// stream without header
+			SetFormat(Settings.RawFormat);
+			if (bFormatKnown)
+			{
+				WriteToBuffer(HeaderData.GetData(), HeaderData.Num(), OnFrame);
+			}
+			HeaderData.Reset();
+			return;
+		}
+
+		int32 DataOffset = 0;
+		const EHeaderResult Result = ParseWavHeader(DataOffset);
+		if (Result == EHeaderResult::NeedMoreData && HeaderData.Num() < MaxWavHeaderSize)
+		{
+			return;
+		}
+		else if (Result != EHeaderResult::Done)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("FYnnkPcmStreamReframer: invalid WAV header, using raw format"));
+			SetFormat(Settings.RawFormat);
+			// bytes received so far are the beginning of raw stream
+			if (bFormatKnown)
+			{
+				WriteToBuffer(HeaderData.GetData(), HeaderData.Num(), OnFrame);
+			}
+			HeaderData.Reset();
+			return;
+		}
+
+		WriteToBuffer(HeaderData.GetData() + DataOffset, HeaderData.Num() - DataOffset, OnFrame);
+		HeaderData.Reset();
+		return;
+	}
+
+	WriteToBuffer(Data, Size, OnFrame);
+}
+
+void FYnnkPcmStreamReframer::WriteToBuffer(const uint8* Data, int32 Size, TFunctionRef<void(TArrayView<const uint8>)> OnFrame)
+{
+	const int32 Capacity = Buffer.Num();
+	while (Size > 0)
+	{
+		const int32 WritePos = (ReadPos + UsedSize) % Capacity;
+		const int32 PartSize = FMath::Min3(Size, Capacity - UsedSize, Capacity - WritePos);
+		if (PartSize <= 0)
+		{
+			// buffer is full during pre-roll
+			bPrerollDone = true;
+		}
+		else
+		{
+			FMemory::Memcpy(Buffer.GetData() + WritePos, Data, PartSize);
+			UsedSize += PartSize;
+			Data += PartSize;
+			Size -= PartSize;
+		}
+
+		if (!bPrerollDone && UsedSize >= PrerollSize)
+		{
+			bPrerollDone = true;
+		}
+		while (bPrerollDone && UsedSize >= FrameSize)
+		{
+			EmitFrame(FrameSize, OnFrame);
+		}
+	}
+}
+
+void FYnnkPcmStreamReframer::EmitFrame(int32 Size, TFunctionRef<void(TArrayView<const uint8>)> OnFrame)
+{
+	const int32 Capacity = Buffer.Num();
+	if (ReadPos + Size <= Capacity)
+	{
+		OnFrame(TArrayView<const uint8>(Buffer.GetData() + ReadPos, Size));
+	}
+	else
+	{
+		const int32 FirstPart = Capacity - ReadPos;
+		FMemory::Memcpy(FrameData.GetData(), Buffer.GetData() + ReadPos, FirstPart);
+		FMemory::Memcpy(FrameData.GetData() + FirstPart, Buffer.GetData(), Size - FirstPart);
+		OnFrame(TArrayView<const uint8>(FrameData.GetData(), Size));
+	}
+
+	ReadPos = (ReadPos + Size) % Capacity;
+	UsedSize -= Size;
+}
+
+void FYnnkPcmStreamReframer::Flush(TFunctionRef<void(TArrayView<const uint8>)> OnFrame)
+{
+	if (!bFormatKnown)
+	{
+		HeaderData.Reset();
+		return;
+	}
+
+	while (UsedSize >= FrameSize)
+	{
+		EmitFrame(FrameSize, OnFrame);
+	}
+	const int32 TailSize = UsedSize - UsedSize % Format.GetBlockAlign();
+	if (TailSize > 0)
+	{
+		EmitFrame(TailSize, OnFrame);
+	}
+	ReadPos = 0;
+	UsedSize = 0;
+}
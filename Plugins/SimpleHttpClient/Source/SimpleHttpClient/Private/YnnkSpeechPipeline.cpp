@@ -0,0 +1,196 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkSpeechPipeline.h"
+#include "HTTPSubsystem.h"
+#include "YnnkTextSegmenter.h"
+#include "Engine/Engine.h"
+#include "Async/Async.h"
+
+UYnnkSpeechPipeline* UYnnkSpeechPipeline::StartSpeechPipeline(UObject* WorldContextObject, FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FString& BodyString,
+	const FYnnkHttpRequestOptions& Options, const FYnnkSpeechPipelineSettings& Settings)
+{
+	UYnnkSpeechPipeline* Action = NewObject<UYnnkSpeechPipeline>();
+	Action->HttpSubsystem = GEngine ? GEngine->GetEngineSubsystem<UHTTPSubsystem>() : nullptr;
+	Action->Keyword = Keyword;
+	Action->URL = URL;
+	Action->Verb = Verb;
+	Action->HeaderParams = HeaderParams;
+	Action->BodyString = BodyString;
+	Action->Options = Options;
+	Action->Settings = Settings;
+	Action->RegisterWithGameInstance(WorldContextObject);
+	return Action;
+}
+
+void UYnnkSpeechPipeline::Activate()
+{
+	if (!HttpSubsystem)
+	{
+		OnFailed.Broadcast(0, FString(), 0, TArray<uint8>());
+		SetReadyToDestroy();
+		return;
+	}
+
+	TokenReader = MakeShared<FYnnkStreamTokenReader>(Settings.TokenPath);
+	Segmenter = MakeShared<FYnnkSentenceSegmenter>(Settings.MinSegmentLength, Settings.MaxSegmentLength);
+
+	// speech requests of the reply are delivered in order by batch, which stays open until LLM reply is finished
+	TWeakObjectPtr<UYnnkSpeechPipeline> WeakThis(this);
+	BatchId = HttpSubsystem->OpenHttpBatch(Keyword, Settings.MaxParallelSpeechRequests, Settings.SpeechOptions,
+		[WeakThis](int32 ItemIndex, const FYnnkHttpResponse& Response)
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->HandleSpeech(ItemIndex, Response);
+			}
+		},
+		[WeakThis](int32 NumSucceeded)
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->HandleSpeechCompleted(NumSucceeded);
+			}
+		});
+
+	FYnnkHttpRequestCallbacks Callbacks;
+	Callbacks.OnTextChunk.BindUObject(this, &UYnnkSpeechPipeline::HandleTextChunk);
+	Callbacks.OnComplete.BindUObject(this, &UYnnkSpeechPipeline::HandleLlmComplete);
+
+	LlmRequest = HttpSubsystem->SendRequest(Keyword, URL, Verb, HeaderParams, BodyString, EExpectedResponseType::StreamText, Options, MoveTemp(Callbacks));
+	BodyString.Empty();
+}
+
+void UYnnkSpeechPipeline::Cancel()
+{
+	if (bCancelled)
+	{
+		return;
+	}
+	bCancelled = true;
+
+	if (HttpSubsystem)
+	{
+		HttpSubsystem->CancelRequest(LlmRequest);
+		HttpSubsystem->CancelBatch(BatchId);
+	}
+	SetReadyToDestroy();
+}
+
+void UYnnkSpeechPipeline::HandleTextChunk(FStringView Text)
+{
+	bool bHasSegments = false;
+	{
+		FScopeLock Lock(&SegmentsLock);
+		TokenBuffer.Reset();
+		TokenReader->Append(Text, TokenBuffer);
+		if (TokenBuffer.IsEmpty())
+		{
+			return;
+		}
+		FullText += TokenBuffer;
+		Segmenter->Append(TokenBuffer, PendingSegments);
+		bHasSegments = PendingSegments.Num() > 0;
+	}
+
+	if (!bHasSegments)
+	{
+		return;
+	}
+
+	if (IsInGameThread())
+	{
+		SendPendingSegments();
+	}
+	else
+	{
+		AsyncTask(ENamedThreads::GameThread, [WeakThis = TWeakObjectPtr<UYnnkSpeechPipeline>(this)]()
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->SendPendingSegments();
+			}
+		});
+	}
+}
+
+void UYnnkSpeechPipeline::HandleLlmComplete(const FYnnkHttpResponse& Response)
+{
+	if (!IsInGameThread())
+	{
+		AsyncTask(ENamedThreads::GameThread, [WeakThis = TWeakObjectPtr<UYnnkSpeechPipeline>(this), Response]()
+		{
+			if (WeakThis.IsValid())
+			{
+				WeakThis->HandleLlmComplete(Response);
+			}
+		});
+		return;
+	}
+
+	if (bCancelled || !HttpSubsystem)
+	{
+		return;
+	}
+
+	// the rest of reply is the last sentence
+	{
+		FScopeLock Lock(&SegmentsLock);
+		Segmenter->Flush(PendingSegments);
+	}
+	SendPendingSegments();
+
+	if (!Response.IsOk())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Speech pipeline %s: LLM request failed with code %d"), *Keyword.ToString(), Response.Code);
+		OnFailed.Broadcast(Segments.Num(), FullText, Response.Code, Response.Data);
+	}
+
+	// completes batch immediately if all speech is already delivered
+	HttpSubsystem->CloseBatch(BatchId);
+}
+
+void UYnnkSpeechPipeline::SendPendingSegments()
+{
+	TArray<FString> NewSegments;
+	{
+		FScopeLock Lock(&SegmentsLock);
+		Swap(NewSegments, PendingSegments);
+	}
+
+	for (FString& Segment : NewSegments)
+	{
+		if (bCancelled || !HttpSubsystem)
+		{
+			return;
+		}
+
+		FJsonItem Body;
+		Body.FromString(Settings.SpeechRequest.BodyString.IsEmpty() ? TEXT("{}") : Settings.SpeechRequest.BodyString);
+		Body.SetStringValue(Settings.SpeechTextPath, Segment);
+
+		FYnnkHttpBatchItem Item = Settings.SpeechRequest;
+		Item.BodyString = Body.AsString();
+
+		// items of batch are indexed as segments; failed request can be delivered before AddBatchItem returns
+		const int32 SegmentIndex = Segments.Add(MoveTemp(Segment));
+		OnSegment.Broadcast(SegmentIndex, Segments[SegmentIndex], 0, TArray<uint8>());
+		if (HttpSubsystem->AddBatchItem(BatchId, Item) == INDEX_NONE)
+		{
+			return;
+		}
+	}
+}
+
+void UYnnkSpeechPipeline::HandleSpeech(int32 ItemIndex, const FYnnkHttpResponse& Response)
+{
+	// failed request is delivered in the same order, so listener can skip it
+	const FString& Text = Segments.IsValidIndex(ItemIndex) ? Segments[ItemIndex] : FString();
+	OnSpeech.Broadcast(ItemIndex, Text, Response.Code, Response.Data);
+}
+
+void UYnnkSpeechPipeline::HandleSpeechCompleted(int32 NumSucceeded)
+{
+	OnCompleted.Broadcast(Segments.Num(), FullText, NumSucceeded, TArray<uint8>());
+	SetReadyToDestroy();
+}
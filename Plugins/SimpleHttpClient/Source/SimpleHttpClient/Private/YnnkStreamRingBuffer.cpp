@@ -0,0 +1,294 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkStreamRingBuffer.h"
+#include "Misc/ScopeLock.h"
+
+bool FYnnkStreamBackpressure::TryReserve(int32 Size)
+{
+	const int64 Limit = MaxBytes;
+	const int64 NewUsed = UsedBytes += Size;
+	// chunk larger than the budget would never fit, so it's accepted when nothing else is pending
+	if (Limit > 0 && NewUsed > Limit && NewUsed != Size)
+	{
+		UsedBytes -= Size;
+		return false;
+	}
+	UpdatePeak(NewUsed);
+	return true;
+}
+
+void FYnnkStreamBackpressure::Reserve(int32 Size)
+{
+	UpdatePeak(UsedBytes += Size);
+}
+
+void FYnnkStreamBackpressure::UpdatePeak(int64 NewUsed)
+{
+	int64 Peak = PeakBytes;
+	while (NewUsed > Peak && !PeakBytes.compare_exchange_weak(Peak, NewUsed))
+	{
+	}
+}
+
+void FYnnkStreamBackpressure::ResetCounters()
+{
+	NumParks = 0;
+	ParkedMicroseconds = 0;
+	NumCoalescedChunks = 0;
+	NumDroppedFrames = 0;
+	PeakBytes = UsedBytes.load();
+}
+
+FYnnkStreamRingBuffer::FYnnkStreamRingBuffer(int32 InCapacity, TSharedPtr<FYnnkStreamBackpressure, ESPMode::ThreadSafe> InBackpressure)
+	: Backpressure(MoveTemp(InBackpressure))
+{
+	Buffer.SetNumUninitialized(FMath::Max(InCapacity, ChunkHeaderSize * 2));
+	WrapPos = Buffer.Num();
+}
+
+FYnnkStreamRingBuffer::~FYnnkStreamRingBuffer()
+{
+	Reset();
+}
+
+int32 FYnnkStreamRingBuffer::ReserveBlock(int32 BlockSize, bool bIgnoreBudget)
+{
+	if (NumChunks == 0)
+	{
+		ReadPos = WritePos = 0;
+		WrapPos = Buffer.Num();
+		bWrapped = false;
+	}
+
+	int32 Offset = INDEX_NONE;
+	bool bWrap = false;
+	if (!bWrapped)
+	{
+		if (Buffer.Num() - WritePos >= BlockSize)
+		{
+			Offset = WritePos;
+		}
+		else if (ReadPos >= BlockSize)
+		{
+			// continue from the beginning, reader skips the tail
+			Offset = 0;
+			bWrap = true;
+		}
+	}
+	else if (ReadPos - WritePos >= BlockSize)
+	{
+		Offset = WritePos;
+	}
+
+	if (Offset == INDEX_NONE)
+	{
+		return INDEX_NONE;
+	}
+	if (Backpressure.IsValid())
+	{
+		if (bIgnoreBudget)
+		{
+			Backpressure->Reserve(BlockSize);
+		}
+		else if (!Backpressure->TryReserve(BlockSize))
+		{
+			return INDEX_NONE;
+		}
+	}
+	if (bWrap)
+	{
+		WrapPos = WritePos;
+		bWrapped = true;
+	}
+	WritePos = Offset + BlockSize;
+	return Offset;
+}
+
+bool FYnnkStreamRingBuffer::Push(const uint8* Data, int32 Size)
+{
+	const int32 BlockSize = Size + ChunkHeaderSize;
+	if (Size <= 0 || BlockSize > Buffer.Num())
+	{
+		return false;
+	}
+
+	int32 Offset = INDEX_NONE;
+	{
+		FScopeLock Lock(&Guard);
+
+		// parked chunks must be read first
+		if (ParkedReadPos < Parked.Num())
+		{
+			return false;
+		}
+		Offset = ReserveBlock(BlockSize, false);
+		if (Offset == INDEX_NONE)
+		{
+			return false;
+		}
+	}
+
+	// region is owned by writer until the chunk is published
+	FMemory::Memcpy(Buffer.GetData() + Offset, &Size, ChunkHeaderSize);
+	FMemory::Memcpy(Buffer.GetData() + Offset + ChunkHeaderSize, Data, Size);
+
+	FScopeLock Lock(&Guard);
+	UsedSize += BlockSize;
+	NumChunks++;
+	return true;
+}
+
+bool FYnnkStreamRingBuffer::Park(const uint8* Data, int32 Size)
+{
+	const int32 BlockSize = Size + ChunkHeaderSize;
+	if (Size <= 0 || BlockSize > Buffer.Num())
+	{
+		return false;
+	}
+
+	FScopeLock Lock(&Guard);
+
+	if (ParkedReadPos == Parked.Num())
+	{
+		Parked.Reset();
+		ParkedReadPos = 0;
+		ParkStartTime = FPlatformTime::Seconds();
+		if (Backpressure.IsValid())
+		{
+			Backpressure->NumParks++;
+		}
+	}
+	const int32 Offset = Parked.AddUninitialized(BlockSize);
+	FMemory::Memcpy(Parked.GetData() + Offset, &Size, ChunkHeaderSize);
+	FMemory::Memcpy(Parked.GetData() + Offset + ChunkHeaderSize, Data, Size);
+	return true;
+}
+
+void FYnnkStreamRingBuffer::MoveParked()
+{
+	FScopeLock Lock(&Guard);
+
+	while (ParkedReadPos < Parked.Num())
+	{
+		int32 Size;
+		FMemory::Memcpy(&Size, Parked.GetData() + ParkedReadPos, ChunkHeaderSize);
+		const int32 BlockSize = Size + ChunkHeaderSize;
+
+		// writer doesn't push while chunks are parked, so the region can be filled under lock;
+		// empty buffer ignores shared budget, otherwise other streams could keep this one parked forever
+		const int32 Offset = ReserveBlock(BlockSize, NumChunks == 0);
+		if (Offset == INDEX_NONE)
+		{
+			return;
+		}
+		FMemory::Memcpy(Buffer.GetData() + Offset, Parked.GetData() + ParkedReadPos, BlockSize);
+		UsedSize += BlockSize;
+		NumChunks++;
+		ParkedReadPos += BlockSize;
+	}
+
+	Parked.Reset();
+	ParkedReadPos = 0;
+	FinishParking();
+}
+
+bool FYnnkStreamRingBuffer::HasParked() const
+{
+	FScopeLock Lock(&Guard);
+	return ParkedReadPos < Parked.Num();
+}
+
+void FYnnkStreamRingBuffer::FinishParking()
+{
+	if (ParkStartTime > 0.0)
+	{
+		if (Backpressure.IsValid())
+		{
+			Backpressure->ParkedMicroseconds += (int64)((FPlatformTime::Seconds() - ParkStartTime) * 1000000.0);
+		}
+		ParkStartTime = 0.0;
+	}
+}
+
+bool FYnnkStreamRingBuffer::Peek(TArrayView<const uint8>& OutChunk) const
+{
+	FScopeLock Lock(&Guard);
+
+	if (NumChunks == 0)
+	{
+		return false;
+	}
+
+	int32 Size;
+	FMemory::Memcpy(&Size, Buffer.GetData() + ReadPos, ChunkHeaderSize);
+	OutChunk = TArrayView<const uint8>(Buffer.GetData() + ReadPos + ChunkHeaderSize, Size);
+	return true;
+}
+
+void FYnnkStreamRingBuffer::Pop()
+{
+	FScopeLock Lock(&Guard);
+
+	if (NumChunks == 0)
+	{
+		return;
+	}
+
+	int32 Size;
+	FMemory::Memcpy(&Size, Buffer.GetData() + ReadPos, ChunkHeaderSize);
+	ReadPos += Size + ChunkHeaderSize;
+	UsedSize -= Size + ChunkHeaderSize;
+	NumChunks--;
+	if (Backpressure.IsValid())
+	{
+		Backpressure->Release(Size + ChunkHeaderSize);
+	}
+
+	// positions of empty buffer are reset by writer, because it can be copying a chunk right now
+	if (bWrapped && ReadPos >= WrapPos)
+	{
+		ReadPos = 0;
+		WrapPos = Buffer.Num();
+		bWrapped = false;
+	}
+}
+
+void FYnnkStreamRingBuffer::Reset()
+{
+	FScopeLock Lock(&Guard);
+
+	if (Backpressure.IsValid())
+	{
+		Backpressure->Release(UsedSize);
+	}
+	ReadPos = WritePos = 0;
+	WrapPos = Buffer.Num();
+	bWrapped = false;
+	UsedSize = 0;
+	NumChunks = 0;
+
+	Parked.Reset();
+	ParkedReadPos = 0;
+	FinishParking();
+}
+
+int32 FYnnkStreamRingBuffer::Num() const
+{
+	FScopeLock Lock(&Guard);
+	return NumChunks;
+}
+
+int32 FYnnkStreamRingBuffer::GetUsedSize() const
+{
+	FScopeLock Lock(&Guard);
+	return UsedSize;
+}
+
+bool FYnnkStreamRingBuffer::IsNearlyFull(float Share) const
+{
+	FScopeLock Lock(&Guard);
+	return ParkedReadPos < Parked.Num()
+		|| UsedSize >= (int32)(Buffer.Num() * Share)
+		|| (Backpressure.IsValid() && Backpressure->IsNearlyFull(Share));
+}
@@ -0,0 +1,92 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkTextAccumulator.h"
+#include "YnnkTextSegmenter.h"
+#include "Misc/ScopeLock.h"
+
+FYnnkTextAccumulator::FYnnkTextAccumulator(const FString& TokenPath)
+{
+	if (!TokenPath.IsEmpty())
+	{
+		TokenReader = MakeUnique<FYnnkStreamTokenReader>(TokenPath);
+	}
+}
+
+FYnnkTextAccumulator::~FYnnkTextAccumulator()
+{
+}
+
+void FYnnkTextAccumulator::Append(const uint8* Data, int32 Size)
+{
+	// decoded outside of lock, only http thread appends
+	Decoder.Decode(Data, Size, DecodedChunk);
+	if (TokenReader.IsValid() && !DecodedChunk.IsEmpty())
+	{
+		Tokens.Reset();
+		TokenReader->Append(DecodedChunk, Tokens);
+		Swap(DecodedChunk, Tokens);
+	}
+	if (DecodedChunk.IsEmpty())
+	{
+		return;
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	const int32 RequiredSize = Text.Len() + DecodedChunk.Len() + 1;
+	TArray<TCHAR>& Chars = Text.GetCharArray();
+	if (Chars.Max() < RequiredSize)
+	{
+		// double capacity, so a long reply is reallocated only a few times
+		Chars.Reserve(FMath::Max(RequiredSize, Chars.Max() * 2));
+	}
+	Text.Append(DecodedChunk);
+}
+
+FString FYnnkTextAccumulator::GetText() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Text;
+}
+
+bool FYnnkTextAccumulator::ReadNewText(FString& OutText)
+{
+	FScopeLock ScopeLock(&Lock);
+	if (ReadPosition >= Text.Len())
+	{
+		OutText.Reset();
+		return false;
+	}
+	OutText = FStringView(Text).Mid(ReadPosition);
+	ReadPosition = Text.Len();
+	return true;
+}
+
+int32 FYnnkTextAccumulator::Len() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Text.Len();
+}
+
+FString FYnnkTextAccumulator::TakeText()
+{
+	FScopeLock ScopeLock(&Lock);
+	if (!TokenReader.IsValid() && Decoder.Flush(DecodedChunk))
+	{
+		Text.Append(DecodedChunk);
+	}
+	ReadPosition = 0;
+	return MoveTemp(Text);
+}
+
+void FYnnkTextAccumulator::Reset()
+{
+	FScopeLock ScopeLock(&Lock);
+	Text.Reset();
+	ReadPosition = 0;
+	Decoder.Reset();
+	if (TokenReader.IsValid())
+	{
+		TokenReader->Reset();
+	}
+}
@@ -0,0 +1,50 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "YnnkUtf8Decoder.h"
+
+class FYnnkStreamTokenReader;
+
+/**
+* Full text of streamed response. Chunks are appended in http thread to a buffer growing geometrically,
+* game thread reads the whole text or the part added since the previous read.
+*/
+class FYnnkTextAccumulator
+{
+public:
+	/** With TokenPath only tokens of server-sent events are kept (see FYnnkStreamTokenReader) */
+	explicit FYnnkTextAccumulator(const FString& TokenPath);
+	~FYnnkTextAccumulator();
+
+	/** Append UTF-8 chunk of response */
+	void Append(const uint8* Data, int32 Size);
+
+	/** Copy of accumulated text */
+	FString GetText() const;
+
+	/** Text added since previous call. Returns false if there is nothing new. */
+	bool ReadNewText(FString& OutText);
+
+	int32 Len() const;
+
+	/** Move accumulated text out; incomplete UTF-8 sequence at the end is replaced with U+FFFD */
+	FString TakeText();
+
+	/** Prepare to accumulate a new response */
+	void Reset();
+
+private:
+	mutable FCriticalSection Lock;
+	FString Text;
+	// length of text returned by ReadNewText
+	int32 ReadPosition = 0;
+
+	FYnnkUtf8StreamDecoder Decoder;
+	TUniquePtr<FYnnkStreamTokenReader> TokenReader;
+	FString DecodedChunk;
+	FString Tokens;
+};
@@ -0,0 +1,261 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkTextSegmenter.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "YnnkHttpPrivate.h"
+#include "YnnkHttpTrace.h"
+
+namespace
+{
+	// CJK punctuation isn't followed by space
+	bool IsFullWidthSentenceEnd(TCHAR Char)
+	{
+		return Char == TCHAR(0x3002) || Char == TCHAR(0xFF01) || Char == TCHAR(0xFF1F);
+	}
+
+	bool IsSentenceEnd(TCHAR Char)
+	{
+		return Char == TCHAR('.') || Char == TCHAR('!') || Char == TCHAR('?') || Char == TCHAR(0x2026) // ellipsis
+			|| IsFullWidthSentenceEnd(Char);
+	}
+
+	bool IsClauseEnd(TCHAR Char)
+	{
+		return Char == TCHAR(',') || Char == TCHAR(';') || Char == TCHAR(':') || Char == TCHAR(0x2014) || Char == TCHAR(0x3001) || Char == TCHAR(0xFF0C);
+	}
+
+	bool IsClosingChar(TCHAR Char)
+	{
+		return Char == TCHAR('"') || Char == TCHAR('\'') || Char == TCHAR(')') || Char == TCHAR(']') || Char == TCHAR('*')
+			|| Char == TCHAR(0x201D) || Char == TCHAR(0x2019) || Char == TCHAR(0xBB);
+	}
+}
+
+FYnnkStreamTokenReader::FYnnkStreamTokenReader(const FString& InTokenPath)
+{
+	TArray<FString> Parts;
+	InTokenPath.ParseIntoArray(Parts, TEXT("."));
+	for (const FString& Part : Parts)
+	{
+		FPathPart& PathPart = TokenPath.AddDefaulted_GetRef();
+		FString Index;
+		if (Part.Split(TEXT("["), &PathPart.Name, &Index))
+		{
+			PathPart.Index = FCString::Atoi(*Index);
+		}
+		else
+		{
+			PathPart.Name = Part;
+		}
+	}
+}
+
+void FYnnkStreamTokenReader::Append(FStringView Chunk, FString& OutText)
+{
+	if (TokenPath.Num() == 0)
+	{
+		OutText.Append(Chunk.GetData(), Chunk.Len());
+		return;
+	}
+
+	PendingLine.Append(Chunk.GetData(), Chunk.Len());
+
+	int32 LineStart = 0;
+	int32 LineEnd;
+	while (FStringView(PendingLine).RightChop(LineStart).FindChar(TCHAR('\n'), LineEnd))
+	{
+		FStringView Line = FStringView(PendingLine).Mid(LineStart, LineEnd);
+		if (Line.EndsWith(TCHAR('\r')))
+		{
+			Line.LeftChopInline(1);
+		}
+		ReadEvent(Line, OutText);
+		LineStart += LineEnd + 1;
+	}
+
+	if (LineStart > 0)
+	{
+		PendingLine.RemoveAt(0, LineStart, YNNK_NO_SHRINK);
+	}
+}
+
+void FYnnkStreamTokenReader::ReadEvent(FStringView Line, FString& OutText) const
+{
+	if (!Line.StartsWith(TEXT("data:")))
+	{
+		return;
+	}
+	const FStringView Payload = Line.RightChop(5).TrimStart();
+	if (Payload.Len() == 0 || Payload.Equals(TEXT("[DONE]")))
+	{
+		return;
+	}
+
+	YNNK_HTTP_TRACE_SCOPE("FYnnkStreamTokenReader::ReadEvent");
+
+	TSharedPtr<FJsonObject> JsonObject;
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(FString(Payload));
+	if (!FJsonSerializer::Deserialize(Reader, JsonObject) || !JsonObject.IsValid())
+	{
+		return;
+	}
+
+	// events without token (role, finish reason) are skipped silently
+	TSharedPtr<FJsonValue> Value = MakeShared<FJsonValueObject>(JsonObject);
+	for (const FPathPart& Part : TokenPath)
+	{
+		const TSharedPtr<FJsonObject>* Object;
+		if (!Value->TryGetObject(Object))
+		{
+			return;
+		}
+		Value = (*Object)->TryGetField(Part.Name);
+		if (!Value.IsValid())
+		{
+			return;
+		}
+		if (Part.Index != INDEX_NONE)
+		{
+			const TArray<TSharedPtr<FJsonValue>>* Array;
+			if (!Value->TryGetArray(Array) || !Array->IsValidIndex(Part.Index))
+			{
+				return;
+			}
+			Value = (*Array)[Part.Index];
+		}
+	}
+
+	FString Token;
+	if (Value->TryGetString(Token))
+	{
+		OutText += Token;
+	}
+}
+
+void FYnnkStreamTokenReader::Reset()
+{
+	PendingLine.Empty();
+}
+
+FYnnkSentenceSegmenter::FYnnkSentenceSegmenter(int32 InMinLength, int32 InMaxLength)
+	: MinLength(FMath::Max(InMinLength, 1))
+	, MaxLength(FMath::Max(InMaxLength, InMinLength + 1))
+{
+}
+
+void FYnnkSentenceSegmenter::Append(FStringView Text, TArray<FString>& OutSegments)
+{
+	Buffer.Append(Text.GetData(), Text.Len());
+
+	while (ScanPos < Buffer.Len())
+	{
+		const TCHAR Char = Buffer[ScanPos];
+		int32 SentenceEnd = INDEX_NONE;
+
+		if (Char == TCHAR('\n'))
+		{
+			SentenceEnd = ScanPos + 1;
+		}
+		else if (IsSentenceEnd(Char))
+		{
+			int32 Next = ScanPos + 1;
+			while (Next < Buffer.Len() && IsClosingChar(Buffer[Next]))
+			{
+				Next++;
+			}
+			if (IsFullWidthSentenceEnd(Char))
+			{
+				SentenceEnd = Next;
+			}
+			else if (Next == Buffer.Len())
+			{
+				// "3." can be a number or end of sentence: wait for the next token
+				break;
+			}
+			else if (FChar::IsWhitespace(Buffer[Next]))
+			{
+				SentenceEnd = Next;
+			}
+		}
+		else if (IsClauseEnd(Char))
+		{
+			LastClauseEnd = ScanPos + 1;
+		}
+		else if (FChar::IsWhitespace(Char))
+		{
+			LastSpace = ScanPos;
+		}
+
+		if (SentenceEnd != INDEX_NONE)
+		{
+			if (SentenceEnd - SegmentStart >= MinLength)
+			{
+				EmitSegment(SentenceEnd, OutSegments);
+				ScanPos = SentenceEnd;
+				continue;
+			}
+			LastClauseEnd = SentenceEnd;
+		}
+
+		if (ScanPos + 1 - SegmentStart >= MaxLength)
+		{
+			int32 Split = ScanPos + 1;
+			if (LastClauseEnd > SegmentStart)
+			{
+				Split = LastClauseEnd;
+			}
+			else if (LastSpace > SegmentStart)
+			{
+				Split = LastSpace + 1;
+			}
+			EmitSegment(Split, OutSegments);
+			ScanPos = Split;
+			continue;
+		}
+
+		ScanPos++;
+	}
+
+	// drop emitted text
+	if (SegmentStart > 0)
+	{
+		Buffer.RemoveAt(0, SegmentStart, YNNK_NO_SHRINK);
+		ScanPos -= SegmentStart;
+		LastClauseEnd = LastClauseEnd == INDEX_NONE ? INDEX_NONE : LastClauseEnd - SegmentStart;
+		LastSpace = LastSpace == INDEX_NONE ? INDEX_NONE : LastSpace - SegmentStart;
+		SegmentStart = 0;
+	}
+}
+
+void FYnnkSentenceSegmenter::Flush(TArray<FString>& OutSegments)
+{
+	EmitSegment(Buffer.Len(), OutSegments);
+	Reset();
+}
+
+void FYnnkSentenceSegmenter::Reset()
+{
+	Buffer.Empty();
+	SegmentStart = 0;
+	ScanPos = 0;
+	LastClauseEnd = INDEX_NONE;
+	LastSpace = INDEX_NONE;
+}
+
+void FYnnkSentenceSegmenter::EmitSegment(int32 End, TArray<FString>& OutSegments)
+{
+	FString Segment = Buffer.Mid(SegmentStart, End - SegmentStart);
+	Segment.TrimStartAndEndInline();
+	if (!Segment.IsEmpty())
+	{
+		OutSegments.Add(MoveTemp(Segment));
+	}
+
+	SegmentStart = End;
+	LastClauseEnd = INDEX_NONE;
+	LastSpace = INDEX_NONE;
+}
@@ -0,0 +1,66 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* Extracts text tokens from LLM stream. Chunks can be split at any character.
+* With TokenPath ("choices[0].delta.content") stream is read as server-sent events with json payload,
+* without it chunks are tokens.
+*/
+class FYnnkStreamTokenReader
+{
+public:
+	explicit FYnnkStreamTokenReader(const FString& InTokenPath);
+
+	/** Read next chunk and append complete tokens to OutText */
+	void Append(FStringView Chunk, FString& OutText);
+
+	void Reset();
+
+private:
+	void ReadEvent(FStringView Line, FString& OutText) const;
+
+	struct FPathPart
+	{
+		FString Name;
+		int32 Index = INDEX_NONE;
+	};
+	TArray<FPathPart> TokenPath;
+	FString PendingLine;
+};
+
+/**
+* Splits growing text to sentences as soon as they are complete.
+* Short sentences are merged up to MinLength, long ones are split at clause punctuation or space after MaxLength.
+*/
+class FYnnkSentenceSegmenter
+{
+public:
+	FYnnkSentenceSegmenter(int32 InMinLength, int32 InMaxLength);
+
+	/** Add text and append completed segments to OutSegments */
+	void Append(FStringView Text, TArray<FString>& OutSegments);
+
+	/** End of text: append the rest as the last segment */
+	void Flush(TArray<FString>& OutSegments);
+
+	void Reset();
+
+private:
+	void EmitSegment(int32 End, TArray<FString>& OutSegments);
+
+	int32 MinLength;
+	int32 MaxLength;
+
+	FString Buffer;
+	// first character of current segment
+	int32 SegmentStart = 0;
+	// characters before this position are checked
+	int32 ScanPos = 0;
+	// last break candidates in current segment
+	int32 LastClauseEnd = INDEX_NONE;
+	int32 LastSpace = INDEX_NONE;
+};
@@ -0,0 +1,286 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#include "YnnkUtf8Decoder.h"
+#include "YnnkHttpPrivate.h"
+
+// ASCII runs are widened 16 bytes at once where vector instructions are always available
+#if PLATFORM_CPU_X86_FAMILY
+#include <emmintrin.h>
+#define YNNK_UTF8_SSE2 1
+#elif PLATFORM_CPU_ARM_FAMILY && PLATFORM_64BITS
+#include <arm_neon.h>
+#define YNNK_UTF8_NEON 1
+#endif
+
+#ifndef YNNK_UTF8_SSE2
+#define YNNK_UTF8_SSE2 0
+#endif
+#ifndef YNNK_UTF8_NEON
+#define YNNK_UTF8_NEON 0
+#endif
+
+namespace YnnkUtf8
+{
+	constexpr TCHAR ReplacementChar = (TCHAR)0xFFFD;
+
+	/** Length of sequence started with Lead byte or 0 if this byte can't start a sequence */
+	FORCEINLINE int32 SequenceLength(uint8 Lead)
+	{
+		if (Lead < 0x80) return 1;
+		if (Lead >= 0xC2 && Lead <= 0xDF) return 2;
+		if (Lead >= 0xE0 && Lead <= 0xEF) return 3;
+		if (Lead >= 0xF0 && Lead <= 0xF4) return 4;
+		return 0;
+	}
+
+	/** Number of first bytes of Seq forming valid beginning of Len-byte sequence */
+	FORCEINLINE int32 ValidPrefixLength(const uint8* Seq, int32 Available, int32 Len)
+	{
+		const int32 Count = FMath::Min(Available, Len);
+		int32 Valid = 1;
+		for (; Valid < Count; Valid++)
+		{
+			uint8 Min = 0x80, Max = 0xBF;
+			if (Valid == 1)
+			{
+				// second byte excludes overlong forms, surrogates and code points above U+10FFFF
+				switch (Seq[0])
+				{
+					case 0xE0: Min = 0xA0; break;
+					case 0xED: Max = 0x9F; break;
+					case 0xF0: Min = 0x90; break;
+					case 0xF4: Max = 0x8F; break;
+				}
+			}
+			if (Seq[Valid] < Min || Seq[Valid] > Max)
+			{
+				break;
+			}
+		}
+		return Valid;
+	}
+
+	/** Code point of validated sequence */
+	FORCEINLINE uint32 DecodeSequence(const uint8* Seq, int32 Len)
+	{
+		switch (Len)
+		{
+			case 2: return ((Seq[0] & 0x1F) << 6) | (Seq[1] & 0x3F);
+			case 3: return ((Seq[0] & 0x0F) << 12) | ((Seq[1] & 0x3F) << 6) | (Seq[2] & 0x3F);
+			case 4: return ((Seq[0] & 0x07) << 18) | ((Seq[1] & 0x3F) << 12) | ((Seq[2] & 0x3F) << 6) | (Seq[3] & 0x3F);
+		}
+		return Seq[0];
+	}
+
+	FORCEINLINE TCHAR* WriteCodepoint(TCHAR* Dest, uint32 Codepoint)
+	{
+		if (sizeof(TCHAR) == 2 && Codepoint > 0xFFFF)
+		{
+			Codepoint -= 0x10000;
+			*Dest++ = (TCHAR)(0xD800 + (Codepoint >> 10));
+			*Dest++ = (TCHAR)(0xDC00 + (Codepoint & 0x3FF));
+		}
+		else
+		{
+			*Dest++ = (TCHAR)Codepoint;
+		}
+		return Dest;
+	}
+
+	/** Copy bytes to Dest until the first non-ASCII byte. Returns number of copied bytes. */
+	FORCEINLINE int32 CopyAscii(const uint8* Src, int32 Size, TCHAR* Dest)
+	{
+		int32 Index = 0;
+#if YNNK_UTF8_SSE2
+		if (sizeof(TCHAR) == 2)
+		{
+			const __m128i Zero = _mm_setzero_si128();
+			for (; Index + 16 <= Size; Index += 16)
+			{
+				const __m128i Bytes = _mm_loadu_si128((const __m128i*)(Src + Index));
+				if (_mm_movemask_epi8(Bytes) != 0)
+				{
+					break;
+				}
+				_mm_storeu_si128((__m128i*)(Dest + Index), _mm_unpacklo_epi8(Bytes, Zero));
+				_mm_storeu_si128((__m128i*)(Dest + Index + 8), _mm_unpackhi_epi8(Bytes, Zero));
+			}
+		}
+#elif YNNK_UTF8_NEON
+		if (sizeof(TCHAR) == 2)
+		{
+			for (; Index + 16 <= Size; Index += 16)
+			{
+				const uint8x16_t Bytes = vld1q_u8(Src + Index);
+				if (vmaxvq_u8(Bytes) >= 0x80)
+				{
+					break;
+				}
+				vst1q_u16((uint16*)(Dest + Index), vmovl_u8(vget_low_u8(Bytes)));
+				vst1q_u16((uint16*)(Dest + Index + 8), vmovl_high_u8(Bytes));
+			}
+		}
+#endif
+		// check eight bytes at once
+		for (; Index + 8 <= Size; Index += 8)
+		{
+			uint64 Word;
+			FMemory::Memcpy(&Word, Src + Index, sizeof(Word));
+			if (Word & 0x8080808080808080ull)
+			{
+				break;
+			}
+			for (int32 i = Index; i < Index + 8; i++)
+			{
+				Dest[i] = (TCHAR)Src[i];
+			}
+		}
+		for (; Index < Size && Src[Index] < 0x80; Index++)
+		{
+			Dest[Index] = (TCHAR)Src[Index];
+		}
+		return Index;
+	}
+
+	/** Number of bytes at the end of Data forming incomplete (but so far valid) sequence */
+	int32 FindIncompleteTail(const uint8* Data, int32 Size)
+	{
+		for (int32 Num = 1; Num <= FMath::Min(Size, 3); Num++)
+		{
+			const uint8* Seq = Data + Size - Num;
+			if ((*Seq & 0xC0) != 0x80)
+			{
+				const int32 Len = SequenceLength(*Seq);
+				return Len > Num && ValidPrefixLength(Seq, Num, Len) == Num ? Num : 0;
+			}
+		}
+		return 0;
+	}
+}
+
+using namespace YnnkUtf8;
+
+void FYnnkUtf8StreamDecoder::Decode(const uint8* Data, int32 Size, FString& OutString)
+{
+	TArray<TCHAR>& Chars = OutString.GetCharArray();
+	Chars.Reset();
+	if (Size <= 0)
+	{
+		return;
+	}
+
+	// every written char consumes at least one byte, except the pending sequence completed by the first byte
+	Chars.SetNumUninitialized(NumPending + Size + 1, YNNK_NO_SHRINK);
+	TCHAR* const DestStart = Chars.GetData();
+	TCHAR* Dest = DestStart;
+	const uint8* Src = Data;
+	const uint8* const End = Data + Size;
+
+	if (NumPending > 0)
+	{
+		uint8 Seq[4];
+		FMemory::Memcpy(Seq, Pending, NumPending);
+		const int32 NumAdded = FMath::Min(4 - NumPending, Size);
+		FMemory::Memcpy(Seq + NumPending, Data, NumAdded);
+
+		const int32 Available = NumPending + NumAdded;
+		const int32 Len = SequenceLength(Seq[0]);
+		const int32 Valid = ValidPrefixLength(Seq, Available, Len);
+		if (Valid == Len)
+		{
+			Dest = WriteCodepoint(Dest, DecodeSequence(Seq, Len));
+			Src += Len - NumPending;
+			NumPending = 0;
+		}
+		else if (Valid == Available)
+		{
+			// the whole chunk is still a part of the sequence
+			FMemory::Memcpy(Pending, Seq, Available);
+			NumPending = Available;
+			Src = End;
+		}
+		else
+		{
+			// pending bytes were valid, so invalid byte is in this chunk and is decoded again below
+			*Dest++ = ReplacementChar;
+			Src += Valid - NumPending;
+			NumPending = 0;
+		}
+	}
+
+	while (Src < End)
+	{
+		const int32 NumAscii = CopyAscii(Src, (int32)(End - Src), Dest);
+		Src += NumAscii;
+		Dest += NumAscii;
+		if (Src == End)
+		{
+			break;
+		}
+
+		const int32 Available = (int32)(End - Src);
+		const int32 Len = SequenceLength(*Src);
+		const int32 Valid = Len > 0 ? ValidPrefixLength(Src, Available, Len) : 1;
+		if (Valid == Len)
+		{
+			Dest = WriteCodepoint(Dest, DecodeSequence(Src, Len));
+			Src += Len;
+		}
+		else if (Len > 0 && Valid == Available)
+		{
+			FMemory::Memcpy(Pending, Src, Available);
+			NumPending = Available;
+			break;
+		}
+		else
+		{
+			*Dest++ = ReplacementChar;
+			Src += Valid;
+		}
+	}
+
+	const int32 Length = (int32)(Dest - DestStart);
+	if (Length == 0)
+	{
+		Chars.Reset();
+		return;
+	}
+	Chars.SetNum(Length + 1, YNNK_NO_SHRINK);
+	Chars[Length] = TCHAR('\0');
+}
+
+void FYnnkUtf8StreamDecoder::Skip(const uint8* Data, int32 Size)
+{
+	if (Size <= 0)
+	{
+		return;
+	}
+
+	// only the last three bytes of the stream can belong to incomplete sequence
+	uint8 Tail[7];
+	int32 TailSize = 0;
+	if (Size < 3)
+	{
+		FMemory::Memcpy(Tail, Pending, NumPending);
+		TailSize = NumPending;
+	}
+	const int32 NumCopied = FMath::Min(Size, 3);
+	FMemory::Memcpy(Tail + TailSize, Data + Size - NumCopied, NumCopied);
+	TailSize += NumCopied;
+
+	NumPending = FindIncompleteTail(Tail, TailSize);
+	FMemory::Memcpy(Pending, Tail + TailSize - NumPending, NumPending);
+}
+
+bool FYnnkUtf8StreamDecoder::Flush(FString& OutString)
+{
+	if (NumPending == 0)
+	{
+		return false;
+	}
+	NumPending = 0;
+	OutString.Reset();
+	OutString.AppendChar(ReplacementChar);
+	return true;
+}
@@ -0,0 +1,34 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+* Incremental UTF-8 to TCHAR decoder of text stream. Data can be split at any byte:
+* incomplete sequence at the end of chunk is kept and decoded with the next chunk.
+* Invalid sequences are replaced with U+FFFD (one per maximal invalid subpart).
+*/
+class FYnnkUtf8StreamDecoder
+{
+public:
+	/** Decode next part of the stream to OutString. Previous content of OutString is replaced, but its memory is reused. */
+	void Decode(const uint8* Data, int32 Size, FString& OutString);
+
+	/** Consume next part of the stream without decoding it (nobody listens to this chunk) */
+	void Skip(const uint8* Data, int32 Size);
+
+	/** End of stream: write U+FFFD to OutString if incomplete sequence is pending. Returns false if nothing is pending. */
+	bool Flush(FString& OutString);
+
+	bool HasPendingBytes() const { return NumPending > 0; }
+
+	/** Prepare to decode a new stream */
+	void Reset() { NumPending = 0; }
+
+private:
+	// bytes of incomplete sequence from previous chunk
+	uint8 Pending[4];
+	int32 NumPending = 0;
+};
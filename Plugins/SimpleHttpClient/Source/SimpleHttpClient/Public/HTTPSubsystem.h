@@ -1,127 +1,857 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "Subsystems/EngineSubsystem.h"
-#include "YnnkHttpTypes.h"
-#include "Runtime/Launch/Resources/Version.h"
-#include "HTTPSubsystem.generated.h"
-
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FHttpResponseString, const FName&, RequestName, int32, Code, const TArray<FString>&, Headers, const FString&, Data);
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FHttpResponseData, const FName&, RequestName, int32, Code, const TArray<FString>&, Headers, const TArray<uint8>&, Data);
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FHttpResponseError, const FName&, RequestName, int32, Code);
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FHttpStreamString, const FName&, RequestName, const FString&, Text);
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FHttpStreamData, const FName&, RequestName, const TArray<uint8>&, Data);
-
-/**
-* Http-request header parameters
-*/
-USTRUCT()
-struct FYnnkNamedHttpRequest
-{
-	GENERATED_BODY()
-
-	// Name
-	UPROPERTY()
-	FName Name;
-
-	// Expected response format
-	UPROPERTY()
-	EExpectedResponseType ResponseFormat = EExpectedResponseType::Default;
-
-	// Request pointer
-	TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> HttpRequest;
-
-	TArray<uint8> TempBinaryData;
-	FString TempStringData;
-
-	bool FormatAudio() const
-	{
-		return ResponseFormat == EExpectedResponseType::StreamData || ResponseFormat == EExpectedResponseType::Data;
-	}
-	bool FormatText() const
-	{
-		return ResponseFormat == EExpectedResponseType::StreamText || ResponseFormat == EExpectedResponseType::Text;
-	}
-	bool FormatStream() const
-	{
-		return ResponseFormat == EExpectedResponseType::StreamText || ResponseFormat == EExpectedResponseType::StreamData;
-	}
-};
-
-/**
- * 
- */
-UCLASS()
-class SIMPLEHTTPCLIENT_API UHTTPSubsystem : public UEngineSubsystem
-{
-	GENERATED_BODY()
-	
-public:
-
-	virtual void Deinitialize() override;
-
-	UPROPERTY(BlueprintReadWrite, Category = "HTTP Subsystem")
-	float Timeout = 180.f;
-
-	UPROPERTY(BlueprintReadWrite, Category = "HTTP Subsystem")
-	bool bResponseInGameThread = false;
-
-	UPROPERTY(BlueprintAssignable, Category = "HTTP Subsystem")
-	FHttpResponseData OnDataResponse;
-
-	UPROPERTY(BlueprintAssignable, Category = "HTTP Subsystem")
-	FHttpResponseString OnTextResponse;
-
-	UPROPERTY(BlueprintAssignable, Category = "HTTP Subsystem")
-	FHttpStreamString OnTextStreamResponse;
-
-	UPROPERTY(BlueprintAssignable, Category = "HTTP Subsystem")
-	FHttpStreamData OnDataStreamResponse;
-
-	UPROPERTY(BlueprintAssignable, Category = "HTTP Subsystem")
-	FHttpResponseError OnResponseError;
-
-	UFUNCTION(BlueprintCallable, meta=(DisplayName="HTTP Request (Text)"), Category = "HTTP Subsystem")
-	bool SendHttpRequest(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FString& BodyString, EExpectedResponseType ExpectedResponseFormat = EExpectedResponseType::Default);
-
-	UFUNCTION(BlueprintCallable, meta = (DisplayName = "HTTP Request (Data)"), Category = "HTTP Subsystem")
-	bool SendHttpRequestData(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const TArray<uint8>& BodyData, EExpectedResponseType ExpectedResponseFormat = EExpectedResponseType::Default);
-
-	bool SendHttpRequestInternal(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FString& BodyString, const TArray<uint8>& BodyData, EExpectedResponseType ExpectedResponseFormat);
-
-protected:
-	// Active requests
-	TMap<int32, FYnnkNamedHttpRequest> HttpRequests;
-	int32 LastRequest = INDEX_NONE;
-	// Temp. buffer
-	TArray<uint8> DataBuffer;
-	FString StringBuffer;
-
-#if ENGINE_MINOR_VERSION > 4
-	FHttpRequestStreamDelegateV2 OnStreamChunkReceived;
-#elif ENGINE_MINOR_VERSION > 2
-	FHttpRequestStreamDelegate OnStreamChunkReceived;
-#endif
-
-
-	// before 5.5
-	bool StreamChunkReceivedWrapper(void* Ptr, int64 Length);
-	// since 5.5
-	void StreamChunkReceivedWrapperV2(void* Ptr, int64& InOutLength);
-
-	/**
-	* Result of http-request with text (json) data
-	*/
-	UFUNCTION()
-	void OnStringRequestCompleted(int32 ReqId, const FString Content, const TArray<FString>& Headers, const int32 ResponseCode, const bool bWasSuccessful);
-
-	/**
-	* Result of http-request with binary data
-	*/
-	UFUNCTION()
-	void OnDataRequestCompleted(int32 ReqId, const TArray<uint8>& Content, const TArray<FString>& Headers, const int32 ResponseCode, const bool bWasSuccessful);
-
-	void OnHTTPRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr RequestResponse, bool bWasSuccessful, int32 ReqId);
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "YnnkHttpTypes.h"
+#include "YnnkHttpMetrics.h"
+#include "YnnkHttpHeaders.h"
+#include "YnnkHttpSubscriptions.h"
+#include "YnnkMultipartBody.h"
+#include "Containers/Ticker.h"
+#include "HAL/CriticalSection.h"
+#include "Containers/StringView.h"
+#include "Async/Future.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include "HTTPSubsystem.generated.h"
+
+class FYnnkStreamInflater;
+class FYnnkUtf8StreamDecoder;
+class FYnnkTextAccumulator;
+class FYnnkStreamRingBuffer;
+class FYnnkStreamBackpressure;
+class FYnnkPcmStreamReframer;
+struct FYnnkHttpRecording;
+class FYnnkHttpReplayIndex;
+class IWebSocket;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FHttpResponseString, const FName&, RequestName, int32, Code, const TArray<FString>&, Headers, const FString&, Data);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FHttpResponseData, const FName&, RequestName, int32, Code, const TArray<FString>&, Headers, const TArray<uint8>&, Data);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FHttpResponseHeaders, const FName&, RequestName, int32, Code, const FYnnkHttpHeaders&, Headers);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FHttpResponseError, const FName&, RequestName, int32, Code);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FHttpRequestCancelled, const FName&, RequestName, const FYnnkHttpRequestHandle&, Handle);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FHttpStreamString, const FName&, RequestName, const FString&, Text);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FHttpStreamData, const FName&, RequestName, const TArray<uint8>&, Data);
+// C++ stream delegates: views are only valid during broadcast
+DECLARE_MULTICAST_DELEGATE_TwoParams(FHttpStreamStringNative, FName /*RequestName*/, FStringView /*Text*/);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FHttpStreamDataNative, FName /*RequestName*/, TArrayView<const uint8> /*Data*/);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FHttpStreamAudio, const FName&, RequestName, const FYnnkPcmFormat&, Format, const TArray<uint8>&, Frame);
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FHttpStreamAudioNative, FName /*RequestName*/, const FYnnkPcmFormat& /*Format*/, TArrayView<const uint8> /*Frame*/);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FHttpResponseFile, const FName&, RequestName, int32, Code, const FString&, FileName, int64, FileSize);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FHttpRequestMetricsEvent, const FName&, RequestName, const FYnnkHttpRequestMetrics&, Metrics);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FHttpRequestMetricsNative, FName /*RequestName*/, const FYnnkHttpRequestMetrics& /*Metrics*/);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_SixParams(FHttpBatchItemResponse, const FName&, RequestName, int32, BatchId, int32, ItemIndex, int32, Code, const FString&, Text, const TArray<uint8>&, Data);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FHttpBatchCompleted, const FName&, RequestName, int32, BatchId, int32, NumSucceeded);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FHttpRequestProgress, const FName&, RequestName, int64, BytesSent, int64, BytesToSend, int64, BytesReceived);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FHttpWebSocketConnected, const FName&, Keyword);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FHttpWebSocketClosed, const FName&, Keyword, int32, StatusCode, const FString&, Reason);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FHttpWebSocketError, const FName&, Keyword, const FString&, Error);
+
+/**
+* Result of request sent with per-request callbacks
+*/
+struct FYnnkHttpResponse
+{
+	FName RequestName;
+	FYnnkHttpRequestHandle Handle;
+	int32 Code = 0;
+	// false if request failed without response or was cancelled
+	bool bWasSuccessful = false;
+	bool bCancelled = false;
+	// Parsed on first access
+	FYnnkHttpHeaders Headers;
+	// Body of text response
+	FString Text;
+	// Body of binary response
+	TArray<uint8> Data;
+	// Downloaded file (DownloadToFile)
+	FString FileName;
+
+	bool IsOk() const
+	{
+		return bWasSuccessful && Code >= 200 && Code < 300;
+	}
+};
+
+DECLARE_DELEGATE_OneParam(FYnnkHttpCompleteDelegate, const FYnnkHttpResponse& /*Response*/);
+// views are only valid during call
+DECLARE_DELEGATE_OneParam(FYnnkHttpTextChunkDelegate, FStringView /*Text*/);
+DECLARE_DELEGATE_OneParam(FYnnkHttpDataChunkDelegate, TArrayView<const uint8> /*Data*/);
+DECLARE_DELEGATE_TwoParams(FYnnkHttpAudioFrameDelegate, const FYnnkPcmFormat& /*Format*/, TArrayView<const uint8> /*Frame*/);
+
+/**
+* C++ callbacks of one request. Stream callbacks are called in the same thread as OnTextStreamChunk and other stream delegates,
+* OnComplete - in the same thread as OnTextResponse.
+*/
+struct FYnnkHttpRequestCallbacks
+{
+	// Called once when request is finished, failed or cancelled
+	FYnnkHttpCompleteDelegate OnComplete;
+	FYnnkHttpTextChunkDelegate OnTextChunk;
+	FYnnkHttpDataChunkDelegate OnDataChunk;
+	FYnnkHttpAudioFrameDelegate OnAudioFrame;
+	// Don't broadcast subsystem delegates (OnTextResponse, OnTextStreamResponse etc.) for this request
+	bool bSkipGlobalDelegates = true;
+};
+
+/**
+* Finished response received by http module or replayed from recording
+*/
+struct FYnnkHttpResponseView
+{
+	// false if request failed without response
+	bool bValid = false;
+	int32 Code = 0;
+	FString ContentType;
+	FYnnkHttpHeaders Headers;
+	const TArray<uint8>* Content = nullptr;
+	// Response of http module (not set for replayed requests)
+	FHttpResponsePtr HttpResponse;
+
+	int64 GetContentSize() const
+	{
+		return Content ? Content->Num() : 0;
+	}
+};
+
+/**
+* Decoded text and data of stream chunk broadcasted from http thread
+*/
+struct FYnnkStreamScratch
+{
+	FString Text;
+	TArray<uint8> Data;
+	// Decoded chunk which is split to audio frames
+	TArray<uint8> AudioChunk;
+};
+
+/**
+* Http-request header parameters
+*/
+USTRUCT()
+struct FYnnkNamedHttpRequest
+{
+	GENERATED_BODY()
+
+	// Name
+	UPROPERTY()
+	FName Name;
+
+	// Unique number of request in this slot
+	UPROPERTY()
+	int32 Serial = 0;
+
+	// Expected response format
+	UPROPERTY()
+	EExpectedResponseType ResponseFormat = EExpectedResponseType::Default;
+
+	// Request pointer
+	TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> HttpRequest;
+
+	// Duplicate of HttpRequest sent by hedging policy
+	TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> HedgeRequest;
+
+	// Retry and hedging settings
+	FYnnkHttpRequestOptions Options;
+
+	// Number of attempts sent so far
+	int32 Attempt = 0;
+
+	// Request (HttpRequest or HedgeRequest) which streamed the first chunk. Chunks of the other one are ignored.
+	const IHttpRequest* StreamOwner = nullptr;
+
+	// HttpRequest has received some data
+	bool bFirstByteReceived = false;
+
+	FTSTicker::FDelegateHandle RetryTickerHandle;
+	FTSTicker::FDelegateHandle HedgeTickerHandle;
+
+	// Body file streamed by http module (to restart request)
+	FString BodyFileName;
+
+	// Body stream (to restart request)
+	TSharedPtr<FArchive, ESPMode::ThreadSafe> BodyStream;
+
+	// Save response body to this file instead of memory
+	FString ResponseFileName;
+
+	// Continue interrupted download of ResponseFileName using Range header
+	bool bResumeDownload = false;
+
+	// Size of temp. file when current attempt was started
+	int64 ResumeOffset = 0;
+
+	// Writer of temp. file, used from http thread
+	TSharedPtr<FArchive> ResponseFileWriter;
+
+	// Decoder of compressed stream
+	TSharedPtr<FYnnkStreamInflater> Inflater;
+
+	// Decoder of text stream, keeps UTF-8 sequences split between chunks
+	TSharedPtr<FYnnkUtf8StreamDecoder> TextDecoder;
+
+	// Full text of StreamText response (bAccumulateText option), appended in http thread
+	TSharedPtr<FYnnkTextAccumulator, ESPMode::ThreadSafe> TextAccumulator;
+
+	// Stream chunks waiting to be sent to game thread. Kept in the slot to be reused by next requests.
+	TSharedPtr<FYnnkStreamRingBuffer, ESPMode::ThreadSafe> StreamBuffer;
+
+	// First chunk of stream was checked for compression
+	bool bStreamEncodingChecked = false;
+
+	// Splits audio stream to frames (StreamAudio format)
+	TSharedPtr<FYnnkPcmStreamReframer> AudioReframer;
+
+	// Time points for metrics, updated from http thread
+	FYnnkHttpRequestTiming Timing;
+
+	// Session being recorded (Record transport mode)
+	TSharedPtr<FYnnkHttpRecording, ESPMode::ThreadSafe> Recording;
+
+	// Callbacks of request sent by SendRequest or SendRequestAsync
+	TSharedPtr<FYnnkHttpRequestCallbacks, ESPMode::ThreadSafe> Callbacks;
+
+	// Session being replayed instead of sending HttpRequest (Replay transport mode)
+	TSharedPtr<const FYnnkHttpRecording, ESPMode::ThreadSafe> Replay;
+	int32 ReplayChunk = 0;
+
+	// Stream chunk decoded by Inflater (http thread, under RequestsLock)
+	TArray<uint8> TempBinaryData;
+
+	// Memory of chunks broadcasted in http thread. Listeners are called without RequestsLock, so they can cancel
+	// this request or send new ones while the chunk is still in use.
+	TSharedPtr<FYnnkStreamScratch, ESPMode::ThreadSafe> StreamScratch;
+
+	bool UseGlobalDelegates() const
+	{
+		return !Callbacks.IsValid() || !Callbacks->bSkipGlobalDelegates;
+	}
+	bool FormatAudio() const
+	{
+		return ResponseFormat == EExpectedResponseType::StreamData || ResponseFormat == EExpectedResponseType::Data || ResponseFormat == EExpectedResponseType::StreamAudio;
+	}
+	bool FormatText() const
+	{
+		return ResponseFormat == EExpectedResponseType::StreamText || ResponseFormat == EExpectedResponseType::Text;
+	}
+	bool FormatStream() const
+	{
+		return ResponseFormat == EExpectedResponseType::StreamText || ResponseFormat == EExpectedResponseType::StreamData || ResponseFormat == EExpectedResponseType::StreamAudio;
+	}
+	bool IsFileResponse() const
+	{
+		return !ResponseFileName.IsEmpty();
+	}
+	bool UseStreamDelegate() const
+	{
+		return FormatStream() || IsFileResponse();
+	}
+	FString GetResponseTempFileName() const
+	{
+		return ResponseFileName + TEXT(".part");
+	}
+};
+
+/**
+* Requests sent by SendHttpBatch. Responses are delivered in order of items.
+*/
+struct FYnnkHttpBatch
+{
+	int32 BatchId = 0;
+	FName Keyword;
+	TArray<FYnnkHttpBatchItem> Items;
+	FYnnkHttpRequestOptions Options;
+	int32 MaxParallel = 1;
+
+	int32 NextToSend = 0;
+	int32 NextToDeliver = 0;
+	int32 NumActive = 0;
+	int32 NumSucceeded = 0;
+	// Open batch waits for new items until CloseBatch
+	bool bClosed = true;
+	// SendBatchItems is running; responses of requests failed synchronously are delivered in the next tick
+	bool bSending = false;
+	bool bDeliveryScheduled = false;
+
+	// Native handlers used instead of OnBatchItemResponse and OnBatchCompleted if bound
+	TFunction<void(int32 ItemIndex, const FYnnkHttpResponse& Response)> OnItemResponse;
+	TFunction<void(int32 NumSucceeded)> OnCompleted;
+
+	// Responses received before responses of previous items
+	TArray<TOptional<FYnnkHttpResponse>> Results;
+	TArray<FYnnkHttpRequestHandle> Handles;
+};
+
+/**
+* WebSocket opened by OpenWebSocket. Outgoing messages are queued until connection and while send rate is exceeded.
+*/
+struct FYnnkWebSocketChannel
+{
+	FName Keyword;
+	FYnnkWebSocketOptions Options;
+	TSharedPtr<IWebSocket> Socket;
+	bool bConnected = false;
+	// Channel was closed or replaced; events of its socket are ignored
+	bool bRemoved = false;
+
+	struct FOutgoingMessage
+	{
+		// UTF-8 for text messages
+		TArray<uint8> Data;
+		bool bBinary = false;
+	};
+	TArray<FOutgoingMessage> Outgoing;
+	int64 QueuedBytes = 0;
+
+	// Bytes which can be sent now if MaxSendRate is set
+	double SendAllowance = 0.0;
+	double LastSendTime = 0.0;
+
+	// Fragments of incoming binary message
+	TArray<uint8> IncomingData;
+};
+
+/**
+ * 
+ */
+UCLASS(Config = Engine)
+class SIMPLEHTTPCLIENT_API UHTTPSubsystem : public UEngineSubsystem
+{
+	GENERATED_BODY()
+	
+public:
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	UPROPERTY(BlueprintReadWrite, Category = "HTTP Subsystem")
+	float Timeout = 180.f;
+
+	UPROPERTY(BlueprintReadWrite, Category = "HTTP Subsystem")
+	bool bResponseInGameThread = false;
+
+	// Options used by requests sent without explicit options
+	UPROPERTY(BlueprintReadWrite, Category = "HTTP Subsystem")
+	FYnnkHttpRequestOptions DefaultOptions;
+
+	// Measure timings of requests (see GetKeywordMetrics and "stat SimpleHttpClient")
+	UPROPERTY(BlueprintReadWrite, Category = "HTTP Subsystem")
+	bool bCollectMetrics = true;
+
+	// Maximum size of stream chunks of all requests waiting for game thread (bytes), 0 - unlimited.
+	// If it's exceeded, StreamOverflowPolicy of request is applied.
+	UPROPERTY(Config, BlueprintReadWrite, Category = "HTTP Subsystem|Streaming")
+	int32 MaxPendingStreamBytes = 0;
+
+	// How often stream overflow policies were applied
+	UFUNCTION(BlueprintPure, Category = "HTTP Subsystem|Streaming")
+	FYnnkStreamBackpressureStats GetStreamBackpressureStats() const;
+
+	UFUNCTION(BlueprintCallable, Category = "HTTP Subsystem|Streaming")
+	void ResetStreamBackpressureStats();
+
+	// Endpoints connected at startup and kept alive while idle. Configured in DefaultEngine.ini:
+	// [/Script/SimpleHttpClient.HTTPSubsystem]
+	// +WarmupEndpoints=http://127.0.0.1:8080/health
+	UPROPERTY(Config, BlueprintReadOnly, Category = "HTTP Subsystem|Connections")
+	TArray<FString> WarmupEndpoints;
+
+	// Verb of warm-up and keep-alive requests (HEAD or OPTIONS)
+	UPROPERTY(Config, BlueprintReadWrite, Category = "HTTP Subsystem|Connections")
+	FString WarmupVerb = TEXT("HEAD");
+
+	// Warm-up endpoint is pinged if its host had no responses for this time (seconds). 0 disables pings.
+	UPROPERTY(Config, BlueprintReadWrite, Category = "HTTP Subsystem|Connections")
+	float KeepAliveInterval = 20.f;
+
+	// Connection to host is expected to be open if it had a response within this time (seconds). Used by connection reuse metrics.
+	UPROPERTY(Config, BlueprintReadWrite, Category = "HTTP Subsystem|Connections")
+	float ConnectionIdleTimeout = 60.f;
+
+	// Connect to endpoint now and keep connection alive
+	UFUNCTION(BlueprintCallable, Category = "HTTP Subsystem|Connections")
+	void AddWarmupEndpoint(const FString& URL);
+
+	UFUNCTION(BlueprintCallable, Category = "HTTP Subsystem|Connections")
+	void RemoveWarmupEndpoint(const FString& URL);
+
+	// Host of URL had a response within ConnectionIdleTimeout
+	UFUNCTION(BlueprintPure, Category = "HTTP Subsystem|Connections")
+	bool IsHostWarm(const FString& URL) const;
+
+	UPROPERTY(BlueprintAssignable, Category = "HTTP Subsystem")
+	FHttpResponseData OnDataResponse;
+
+	UPROPERTY(BlueprintAssignable, Category = "HTTP Subsystem")
+	FHttpResponseString OnTextResponse;
+
+	UPROPERTY(BlueprintAssignable, Category = "HTTP Subsystem")
+	FHttpStreamString OnTextStreamResponse;
+
+	UPROPERTY(BlueprintAssignable, Category = "HTTP Subsystem")
+	FHttpStreamData OnDataStreamResponse;
+
+	UPROPERTY(BlueprintAssignable, Category = "HTTP Subsystem")
+	FHttpResponseError OnResponseError;
+
+	// Headers of response, called before OnTextResponse/OnDataResponse. Headers are only parsed if this event is bound
+	// (Headers array of OnTextResponse and OnDataResponse is only built if these events have listeners).
+	UPROPERTY(BlueprintAssignable, Category = "HTTP Subsystem")
+	FHttpResponseHeaders OnResponseHeaders;
+
+	// Request was cancelled by CancelRequest, CancelRequestsByKeyword or bReplacePrevious option. Other delegates aren't called for it.
+	UPROPERTY(BlueprintAssignable, Category = "HTTP Subsystem")
+	FHttpRequestCancelled OnRequestCancelled;
+
+	// Same as OnTextStreamResponse without copying
+	FHttpStreamStringNative OnTextStreamChunk;
+
+	// Same as OnDataStreamResponse without copying
+	FHttpStreamDataNative OnDataStreamChunk;
+
+	// Frames of response with StreamAudio format
+	UPROPERTY(BlueprintAssignable, Category = "HTTP Subsystem")
+	FHttpStreamAudio OnAudioStreamFrame;
+
+	// Same as OnAudioStreamFrame without copying
+	FHttpStreamAudioNative OnAudioFrame;
+
+	// Result of DownloadToFile request
+	UPROPERTY(BlueprintAssignable, Category = "HTTP Subsystem")
+	FHttpResponseFile OnFileResponse;
+
+	// Upload/download progress of requests with bReportProgress option
+	UPROPERTY(BlueprintAssignable, Category = "HTTP Subsystem")
+	FHttpRequestProgress OnRequestProgressUpdated;
+
+	// Timings of every finished request if bCollectMetrics is set
+	UPROPERTY(BlueprintAssignable, Category = "HTTP Subsystem")
+	FHttpRequestMetricsEvent OnRequestMetrics;
+
+	// Same as OnRequestMetrics for C++ listeners
+	FHttpRequestMetricsNative OnMetricsRecorded;
+
+	// Rolling metrics of requests with keyword
+	UFUNCTION(BlueprintPure, Category = "HTTP Subsystem|Metrics")
+	bool GetKeywordMetrics(FName Keyword, FYnnkHttpMetricsSnapshot& Snapshot) const;
+
+	// Rolling metrics of requests to host (domain of URL)
+	UFUNCTION(BlueprintPure, Category = "HTTP Subsystem|Metrics")
+	bool GetHostMetrics(const FString& Host, FYnnkHttpMetricsSnapshot& Snapshot) const;
+
+	// Rolling metrics of all requests
+	UFUNCTION(BlueprintPure, Category = "HTTP Subsystem|Metrics")
+	FYnnkHttpMetricsSnapshot GetTotalMetrics() const;
+
+	UFUNCTION(BlueprintCallable, Category = "HTTP Subsystem|Metrics")
+	void GetAllMetrics(TArray<FYnnkHttpMetricsSnapshot>& Keywords, TArray<FYnnkHttpMetricsSnapshot>& Hosts) const;
+
+	UFUNCTION(BlueprintCallable, Category = "HTTP Subsystem|Metrics")
+	void ResetMetrics();
+
+	const FYnnkHttpMetrics& GetMetrics() const
+	{
+		return Metrics;
+	}
+
+	// Call Event for text stream chunks of requests with Keyword only
+	UFUNCTION(BlueprintCallable, Category = "HTTP Subsystem|Subscriptions")
+	void SubscribeToTextStream(FName Keyword, FHttpKeywordTextEvent Event);
+
+	// Call Event for data stream chunks of requests with Keyword only
+	UFUNCTION(BlueprintCallable, Category = "HTTP Subsystem|Subscriptions")
+	void SubscribeToDataStream(FName Keyword, FHttpKeywordDataEvent Event);
+
+	// Call Event for text responses of requests with Keyword only
+	UFUNCTION(BlueprintCallable, Category = "HTTP Subsystem|Subscriptions")
+	void SubscribeToTextResponse(FName Keyword, FHttpKeywordTextResponseEvent Event);
+
+	// Call Event for binary responses of requests with Keyword only
+	UFUNCTION(BlueprintCallable, Category = "HTTP Subsystem|Subscriptions")
+	void SubscribeToDataResponse(FName Keyword, FHttpKeywordDataResponseEvent Event);
+
+	// Call Event for errors of requests with Keyword only
+	UFUNCTION(BlueprintCallable, Category = "HTTP Subsystem|Subscriptions")
+	void SubscribeToError(FName Keyword, FHttpKeywordErrorEvent Event);
+
+	// Remove events of Listener subscribed to Keyword (or to all keywords if Keyword is None)
+	UFUNCTION(BlueprintCallable, Category = "HTTP Subsystem|Subscriptions")
+	void Unsubscribe(UObject* Listener, FName Keyword = NAME_None);
+
+	// Send requests with up to MaxParallel of them at once. Responses are broadcasted by OnBatchItemResponse
+	// strictly in order of Items (as soon as all previous ones are delivered), then OnBatchCompleted is called.
+	// Returns batch id, or -1 if Items is empty. Responses are never broadcasted before the function returns.
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "HTTP Batch Request"), Category = "HTTP Subsystem|Batch")
+	int32 SendHttpBatch(FName Keyword, const TArray<FYnnkHttpBatchItem>& Items, int32 MaxParallel, const FYnnkHttpRequestOptions& Options);
+
+	// Cancel active requests of batch and skip the rest. OnBatchCompleted isn't called.
+	UFUNCTION(BlueprintCallable, Category = "HTTP Subsystem|Batch")
+	bool CancelBatch(int32 BatchId);
+
+	/**
+	* Create batch to which items are added later with AddBatchItem. Responses are delivered in order of adding;
+	* batch is completed after CloseBatch when all responses are delivered. Handlers are called in game thread.
+	*/
+	int32 OpenHttpBatch(FName Keyword, int32 MaxParallel, const FYnnkHttpRequestOptions& Options,
+		TFunction<void(int32 ItemIndex, const FYnnkHttpResponse& Response)> OnItemResponse = nullptr, TFunction<void(int32 NumSucceeded)> OnCompleted = nullptr);
+
+	// Append item to open batch and send it if parallelism allows. Returns item index or INDEX_NONE.
+	int32 AddBatchItem(int32 BatchId, const FYnnkHttpBatchItem& Item);
+
+	// No more items will be added to batch
+	bool CloseBatch(int32 BatchId);
+
+	// Response of batch item (Code is 0 if request failed without response)
+	UPROPERTY(BlueprintAssignable, Category = "HTTP Subsystem")
+	FHttpBatchItemResponse OnBatchItemResponse;
+
+	// All responses of batch are delivered
+	UPROPERTY(BlueprintAssignable, Category = "HTTP Subsystem")
+	FHttpBatchCompleted OnBatchCompleted;
+
+	// Open WebSocket channel identified by Keyword (channel with the same keyword is closed). Received messages are broadcasted
+	// in game thread with Keyword as request name by stream events: OnTextStreamResponse, OnDataStreamResponse and subscriptions.
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Open WebSocket"), Category = "HTTP Subsystem|WebSocket")
+	bool OpenWebSocket(FName Keyword, FString URL, const TArray<FYnnkUrlParameter>& HeaderParams, const FYnnkWebSocketOptions& Options);
+
+	// Send text message (queued until connection). Returns false if channel doesn't exist or its queue is full.
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Send WebSocket Message (Text)"), Category = "HTTP Subsystem|WebSocket")
+	bool SendWebSocketText(FName Keyword, const FString& Message);
+
+	// Send binary message (queued until connection). Returns false if channel doesn't exist or its queue is full.
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Send WebSocket Message (Data)"), Category = "HTTP Subsystem|WebSocket")
+	bool SendWebSocketData(FName Keyword, const TArray<uint8>& Data);
+
+	bool SendWebSocketMessage(FName Keyword, TArrayView<const uint8> Data, bool bBinary);
+
+	// Close channel. Queued messages are dropped.
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "Close WebSocket"), Category = "HTTP Subsystem|WebSocket")
+	void CloseWebSocket(FName Keyword, int32 StatusCode = 1000, const FString& Reason = TEXT(""));
+
+	UFUNCTION(BlueprintPure, Category = "HTTP Subsystem|WebSocket")
+	bool IsWebSocketConnected(FName Keyword) const;
+
+	// Size of outgoing messages waiting to be sent (bytes)
+	UFUNCTION(BlueprintPure, Category = "HTTP Subsystem|WebSocket")
+	int32 GetWebSocketQueuedBytes(FName Keyword) const;
+
+	UPROPERTY(BlueprintAssignable, Category = "HTTP Subsystem")
+	FHttpWebSocketConnected OnWebSocketConnected;
+
+	// Channel was closed by server or by CloseWebSocket
+	UPROPERTY(BlueprintAssignable, Category = "HTTP Subsystem")
+	FHttpWebSocketClosed OnWebSocketClosed;
+
+	// Unable to connect or connection was lost; channel is removed
+	UPROPERTY(BlueprintAssignable, Category = "HTTP Subsystem")
+	FHttpWebSocketError OnWebSocketError;
+
+	// Handle of request created by the last call of any send function
+	UFUNCTION(BlueprintPure, Category = "HTTP Subsystem|Cancellation")
+	FYnnkHttpRequestHandle GetLastRequestHandle() const
+	{
+		return LastRequestHandle;
+	}
+
+	UFUNCTION(BlueprintPure, Category = "HTTP Subsystem|Cancellation")
+	bool IsRequestActive(const FYnnkHttpRequestHandle& Handle) const;
+
+	// Text received so far by active StreamText request sent with bAccumulateText option
+	UFUNCTION(BlueprintPure, Category = "HTTP Subsystem|Streaming")
+	FString GetStreamedText(const FYnnkHttpRequestHandle& Handle) const;
+
+	// Text received by active StreamText request since previous call (bAccumulateText option). Returns false if there is no new text.
+	UFUNCTION(BlueprintCallable, Category = "HTTP Subsystem|Streaming")
+	bool ReadNewStreamedText(const FYnnkHttpRequestHandle& Handle, FString& NewText);
+
+	// Cancel request, free its slot and buffers and broadcast OnRequestCancelled. Returns false if request is already finished.
+	UFUNCTION(BlueprintCallable, Category = "HTTP Subsystem|Cancellation")
+	bool CancelRequest(const FYnnkHttpRequestHandle& Handle);
+
+	// Cancel all active requests with keyword. Returns number of cancelled requests.
+	UFUNCTION(BlueprintCallable, Category = "HTTP Subsystem|Cancellation")
+	int32 CancelRequestsByKeyword(FName Keyword);
+
+	// Live: send requests to network. Record: send requests and save sessions to recording directory.
+	// Replay: play saved sessions with the same delegates and stream chunking, without network.
+	UPROPERTY(BlueprintReadOnly, Category = "HTTP Subsystem|Recording")
+	EYnnkHttpTransportMode TransportMode = EYnnkHttpTransportMode::Live;
+
+	// Timing of replayed sessions: 1 - original, 2 - twice faster, 0 - without delays
+	UPROPERTY(BlueprintReadWrite, Category = "HTTP Subsystem|Recording")
+	float ReplaySpeed = 1.f;
+
+	// Change transport mode for new requests. Empty directory is Saved/HttpRecordings.
+	UFUNCTION(BlueprintCallable, Category = "HTTP Subsystem|Recording")
+	void SetTransportMode(EYnnkHttpTransportMode Mode, const FString& Directory);
+
+	UFUNCTION(BlueprintPure, Category = "HTTP Subsystem|Recording")
+	FString GetRecordingDirectory() const;
+
+	UFUNCTION(BlueprintCallable, meta=(DisplayName="HTTP Request (Text)"), Category = "HTTP Subsystem")
+	bool SendHttpRequest(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FString& BodyString, EExpectedResponseType ExpectedResponseFormat = EExpectedResponseType::Default);
+
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "HTTP Request (Data)"), Category = "HTTP Subsystem")
+	bool SendHttpRequestData(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const TArray<uint8>& BodyData, EExpectedResponseType ExpectedResponseFormat = EExpectedResponseType::Default);
+
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "HTTP Request with Options (Text)"), Category = "HTTP Subsystem")
+	bool SendHttpRequestWithOptions(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FString& BodyString, const FYnnkHttpRequestOptions& Options, EExpectedResponseType ExpectedResponseFormat = EExpectedResponseType::Default);
+
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "HTTP Request with Options (Data)"), Category = "HTTP Subsystem")
+	bool SendHttpRequestDataWithOptions(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const TArray<uint8>& BodyData, const FYnnkHttpRequestOptions& Options, EExpectedResponseType ExpectedResponseFormat = EExpectedResponseType::Default);
+
+	// Send file as request body without loading it to memory. Body compression isn't applied.
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "HTTP Request (File)"), Category = "HTTP Subsystem")
+	bool SendHttpRequestFile(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FString& FileName, const FYnnkHttpRequestOptions& Options, EExpectedResponseType ExpectedResponseFormat = EExpectedResponseType::Default);
+
+#if ENGINE_MINOR_VERSION > 0
+	// Send request body read from archive while sending. Archive should support Seek(0) to be retried. Body compression and hedging aren't applied.
+	bool SendHttpRequestStream(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, TSharedRef<FArchive, ESPMode::ThreadSafe> BodyStream, const FYnnkHttpRequestOptions& Options, EExpectedResponseType ExpectedResponseFormat = EExpectedResponseType::Default);
+#endif
+
+	// Send multipart/form-data body. Parts are read while sending, so files and data aren't concatenated in memory.
+	bool SendHttpRequestMultipart(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FYnnkMultipartBody& Body, const FYnnkHttpRequestOptions& Options, EExpectedResponseType ExpectedResponseFormat = EExpectedResponseType::Default);
+
+	// Send multipart/form-data body. Content-Type header with boundary is set automatically. Body compression isn't applied.
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "HTTP Request (Multipart)"), Category = "HTTP Subsystem")
+	bool SendHttpRequestMultipartParts(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const TArray<FYnnkMultipartPart>& Parts, const FYnnkHttpRequestOptions& Options, EExpectedResponseType ExpectedResponseFormat = EExpectedResponseType::Default);
+
+	// Content-Type for file by its extension
+	static const TCHAR* GetContentTypeForFile(const FString& FileName);
+
+	// Write response body to file as it arrives. Data is saved to FileName.part and renamed when request is completed.
+	// If bResume is true and .part file exists, only missing part is requested.
+	UFUNCTION(BlueprintCallable, meta = (DisplayName = "HTTP Download to File"), Category = "HTTP Subsystem")
+	bool DownloadToFile(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FString& BodyString, const FString& FileName, bool bResume, const FYnnkHttpRequestOptions& Options);
+
+	bool SendHttpRequestInternal(FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FString& BodyString, const TArray<uint8>& BodyData, EExpectedResponseType ExpectedResponseFormat, const FYnnkHttpRequestOptions& Options,
+		TSharedPtr<FYnnkHttpRequestCallbacks, ESPMode::ThreadSafe> Callbacks = nullptr);
+
+	/**
+	* Send request with its own callbacks. By default subsystem delegates aren't broadcasted for it.
+	* Returns invalid handle if request wasn't sent (OnComplete is called with failure in this case).
+	*/
+	FYnnkHttpRequestHandle SendRequest(FName Keyword, const FString& URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FString& BodyString,
+		EExpectedResponseType ExpectedResponseFormat, const FYnnkHttpRequestOptions& Options, FYnnkHttpRequestCallbacks Callbacks);
+
+	FYnnkHttpRequestHandle SendRequestData(FName Keyword, const FString& URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const TArray<uint8>& BodyData,
+		EExpectedResponseType ExpectedResponseFormat, const FYnnkHttpRequestOptions& Options, FYnnkHttpRequestCallbacks Callbacks);
+
+	/**
+	* Send request and get future result. Future is set when request is finished, failed or cancelled
+	* (can be continued with Then() or waited in a task).
+	*/
+	TFuture<FYnnkHttpResponse> SendRequestAsync(FName Keyword, const FString& URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FString& BodyString,
+		EExpectedResponseType ExpectedResponseFormat, const FYnnkHttpRequestOptions& Options);
+
+	TFuture<FYnnkHttpResponse> SendRequestDataAsync(FName Keyword, const FString& URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const TArray<uint8>& BodyData,
+		EExpectedResponseType ExpectedResponseFormat, const FYnnkHttpRequestOptions& Options);
+
+protected:
+	// Active requests
+	TMap<int32, FYnnkNamedHttpRequest> HttpRequests;
+	// Guards HttpRequests when accessed from http thread
+	FCriticalSection RequestsLock;
+	// Temp. buffer
+	TArray<uint8> DataBuffer;
+	FString StringBuffer;
+	// Buffers for stream chunks broadcasted in game thread
+	TArray<uint8> DispatchData;
+	FString DispatchString;
+	// Decoded chunk split to audio frames in game thread
+	TArray<uint8> DispatchChunk;
+
+	// Budget of pending stream chunks shared by all requests, counters of overflow policies
+	TSharedPtr<FYnnkStreamBackpressure, ESPMode::ThreadSafe> StreamBackpressure;
+
+	FTSTicker::FDelegateHandle StreamDispatchTickerHandle;
+
+	// Aggregated timings of finished requests
+	FYnnkHttpMetrics Metrics;
+
+	// Keyword-routed events
+	FYnnkHttpSubscriptions Subscriptions;
+
+	// Time of the last response by scheme://host:port (game thread)
+	TMap<FString, double> HostActivity;
+	// Hosts with active warm-up request
+	TSet<FString> PendingWarmups;
+	FTSTicker::FDelegateHandle KeepAliveTickerHandle;
+
+	/**
+	* Send lightweight request to open connection to host of URL
+	*/
+	void WarmUpEndpoint(const FString& URL);
+	void MarkHostActivity(const FString& URL);
+	bool TickKeepAlive(float DeltaTime);
+
+	// Active batches
+	TMap<int32, TSharedPtr<FYnnkHttpBatch>> Batches;
+	int32 NextBatchId = 0;
+
+	/**
+	* Send next items of batch up to its parallelism
+	*/
+	void SendBatchItems(TSharedPtr<FYnnkHttpBatch> Batch);
+	void OnBatchItemCompleted(const FYnnkHttpResponse& Response, int32 BatchId, int32 ItemIndex);
+	/**
+	* Deliver ready responses in order and complete closed batch. Returns false if batch is finished or cancelled.
+	*/
+	bool DeliverBatchResponses(const TSharedPtr<FYnnkHttpBatch>& Batch);
+
+	// Open WebSocket channels
+	TMap<FName, TSharedPtr<FYnnkWebSocketChannel>> WebSockets;
+	// Removed channels are released in the next tick, because socket can't be destroyed inside of its own event
+	TArray<TSharedPtr<FYnnkWebSocketChannel>> ClosedWebSockets;
+	FTSTicker::FDelegateHandle WebSocketTickerHandle;
+
+	/**
+	* Send queued messages of channel allowed by its send rate
+	*/
+	void FlushWebSocket(FYnnkWebSocketChannel& Channel);
+	bool TickWebSockets(float DeltaTime);
+	void RemoveWebSocket(const TSharedPtr<FYnnkWebSocketChannel>& Channel);
+
+	int32 NextRequestSerial = 0;
+	FYnnkHttpRequestHandle LastRequestHandle;
+
+	/**
+	* Active request identified by handle or nullptr
+	*/
+	FYnnkNamedHttpRequest* FindRequest(const FYnnkHttpRequestHandle& Handle);
+	const FYnnkNamedHttpRequest* FindRequest(const FYnnkHttpRequestHandle& Handle) const;
+
+	/**
+	* Cancel http-request, drop queued stream chunks and partial file and free slot
+	*/
+	bool CancelRequestById(int32 ReqId);
+
+	/**
+	* Add timings of finished request to metrics and broadcast OnRequestMetrics
+	*/
+	void RecordRequestMetrics(int32 ReqId, int64 ContentSize, int32 ResponseCode, bool bWasSuccessful);
+
+	FString RecordingDirectory;
+	// Prefix of recording files saved in this session
+	FString RecordingSession;
+	int32 RecordingCounter = 0;
+	// Recordings available for replay, scanned by first replayed request
+	TSharedPtr<FYnnkHttpReplayIndex> ReplayIndex;
+	FTSTicker::FDelegateHandle ReplayTickerHandle;
+
+	/**
+	* Save response of the recorded request in background thread
+	*/
+	void SaveRecording(int32 ReqId, const FYnnkHttpResponseView& Response, bool bWasSuccessful);
+
+	/**
+	* Find recording for the request and schedule its chunks instead of sending it
+	*/
+	void StartReplay(int32 ReqId);
+	bool TickReplay(float DeltaTime);
+	void AdvanceReplay(int32 ReqId, double Now);
+
+	// before 5.5
+	bool StreamChunkReceivedWrapper(void* Ptr, int64 Length, int32 ReqId, const IHttpRequest* Source);
+	// since 5.5
+	void StreamChunkReceivedWrapperV2(void* Ptr, int64& InOutLength, int32 ReqId, const IHttpRequest* Source);
+
+	/**
+	* Copy chunk to stream buffer of the request (http thread). If buffer or global budget is full, applies overflow policy of the request.
+	* Never waits: http thread is shared by all requests.
+	*/
+	void QueueStreamChunk(FYnnkStreamRingBuffer& StreamBuffer, FName RequestName, const uint8* Data, int32 Size, EYnnkStreamOverflowPolicy Policy, bool bAudioFrame);
+
+	/**
+	* Broadcast queued stream chunks of the request (game thread)
+	*/
+	void DispatchStreamChunks(int32 ReqId);
+	bool TickStreamDispatch(float DeltaTime);
+
+	void BroadcastStreamChunk(FName RequestName, const FYnnkHttpRequestCallbacks* Callbacks, FYnnkUtf8StreamDecoder* TextDecoder, TArrayView<const uint8> Chunk, FString& StringScratch, TArray<uint8>& DataScratch);
+	void BroadcastTextChunk(FName RequestName, const FYnnkHttpRequestCallbacks* Callbacks, FString& Text);
+	void BroadcastAudioFrame(FName RequestName, const FYnnkHttpRequestCallbacks* Callbacks, const FYnnkPcmFormat& Format, TArrayView<const uint8> Frame, TArray<uint8>& DataScratch);
+
+	/**
+	* Call OnComplete of per-request callbacks (in game thread if bResponseInGameThread is set)
+	*/
+	void ExecuteCompleteCallback(const TSharedPtr<FYnnkHttpRequestCallbacks, ESPMode::ThreadSafe>& Callbacks, FYnnkHttpResponse&& Response);
+
+	/**
+	* Find free slot and create http-request with headers, but without body
+	*/
+	int32 CreateNamedRequest(FName Keyword, const FString& URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, EExpectedResponseType ExpectedResponseFormat, const FYnnkHttpRequestOptions& Options, const TCHAR* DefaultContentType);
+
+	/**
+	* Set Range header or remove old temp. file before sending download request
+	*/
+	void PrepareResponseFile(FYnnkNamedHttpRequest& Req);
+
+	/**
+	* Write chunk of downloaded data to temp. file (http thread)
+	*/
+	void WriteResponseFileChunk(FYnnkNamedHttpRequest& Req, const IHttpRequest* Source, const uint8* Data, int64 Length);
+
+	/**
+	* Close and rename temp. file and report result. Returns true if file is saved.
+	*/
+	bool OnFileRequestCompleted(int32 ReqId, const FYnnkHttpResponseView& Response, bool bWasSuccessful);
+
+	/**
+	* Bind delegates and send current HttpRequest of the active request
+	*/
+	bool StartAttempt(int32 ReqId);
+
+	/**
+	* Create new request with URL, verb, headers and content of the source one
+	*/
+	TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> CloneHttpRequest(const FYnnkNamedHttpRequest& Req, const TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>& Source) const;
+
+	/**
+	* Schedule next attempt according to retry policy. Returns false if no attempts left.
+	*/
+	bool ScheduleRetry(int32 ReqId, const FHttpResponsePtr& Response);
+
+	/**
+	* Send duplicate request if the primary one is still waiting for data
+	*/
+	void SendHedgeRequest(int32 ReqId, TWeakPtr<IHttpRequest, ESPMode::ThreadSafe> PrimaryRequest);
+
+	/**
+	* Cancel request without calling completion delegate
+	*/
+	void AbandonHttpRequest(TSharedPtr<IHttpRequest, ESPMode::ThreadSafe>& Request);
+
+	/**
+	* Free slot of the finished request. If bCancel is true, the request is cancelled in http module and buffers are freed.
+	*/
+	void ReleaseRequest(int32 ReqId, bool bCancel = false);
+
+	float GetAttemptTimeout(const FYnnkHttpRequestOptions& Options) const
+	{
+		return Options.RetryPolicy.AttemptTimeout > 0.f ? Options.RetryPolicy.AttemptTimeout : Timeout;
+	}
+
+	void OnRequestProgress(FHttpRequestPtr Request, uint64 BytesSent, uint64 BytesReceived, int32 ReqId);
+
+	/**
+	* Result of http-request with text (json) data
+	*/
+	UFUNCTION()
+	void OnStringRequestCompleted(int32 ReqId, const FString& Content, const FYnnkHttpHeaders& Headers, const int32 ResponseCode, const bool bWasSuccessful);
+
+	/**
+	* Result of http-request with binary data
+	*/
+	UFUNCTION()
+	void OnDataRequestCompleted(int32 ReqId, const TArray<uint8>& Content, const FYnnkHttpHeaders& Headers, const int32 ResponseCode, const bool bWasSuccessful);
+
+	void OnHTTPRequestComplete(FHttpRequestPtr Request, FHttpResponsePtr RequestResponse, bool bWasSuccessful, int32 ReqId);
+
+	/**
+	* Report result of the final attempt and free slot
+	*/
+	void CompleteRequest(int32 ReqId, const FYnnkHttpResponseView& Response, bool bWasSuccessful);
+};
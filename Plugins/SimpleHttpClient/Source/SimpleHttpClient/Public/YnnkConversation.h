@@ -0,0 +1,107 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Object.h"
+#include "YnnkHttpTypes.h"
+#include "YnnkConversation.generated.h"
+
+/**
+* Chat request body built incrementally. Every message is serialized to UTF-8 json once, when it's added,
+* and the body is assembled by copying cached segments, so cost of a turn doesn't depend on length of conversation.
+* Oldest messages are left out of the body when it exceeds TokenBudget.
+*/
+UCLASS(BlueprintType)
+class SIMPLEHTTPCLIENT_API UYnnkConversation : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	// Create conversation. RequestTemplate is json object with other fields of request body (model, stream etc.).
+	UFUNCTION(BlueprintCallable, Category = "Simple HTTP Client|Conversation")
+	static UYnnkConversation* CreateConversation(const FJsonItem& RequestTemplate, int32 InTokenBudget = 0, const FString& InMessagesField = TEXT("messages"));
+
+	// Set fields of request body other than messages. Existing messages field of template is ignored.
+	UFUNCTION(BlueprintCallable, Category = "Simple HTTP Client|Conversation")
+	bool SetRequestTemplate(const FJsonItem& RequestTemplate);
+
+	// Add message {"role": Role, "content": Content}. Pinned messages (system prompt) are never truncated and precede other messages.
+	UFUNCTION(BlueprintCallable, Category = "Simple HTTP Client|Conversation")
+	void AddMessage(const FString& Role, const FString& Content, bool bPinned = false);
+
+	// Add message with arbitrary json (tool calls, content parts etc.)
+	UFUNCTION(BlueprintCallable, Category = "Simple HTTP Client|Conversation")
+	bool AddMessageJson(const FJsonItem& Message, bool bPinned = false);
+
+	// Remove the last not pinned message (e.g. to regenerate reply). Returns false if there is no such message.
+	UFUNCTION(BlueprintCallable, Category = "Simple HTTP Client|Conversation")
+	bool RemoveLastMessage();
+
+	// Remove messages; pinned messages are removed only if bRemovePinned is set
+	UFUNCTION(BlueprintCallable, Category = "Simple HTTP Client|Conversation")
+	void ClearMessages(bool bRemovePinned = false);
+
+	UFUNCTION(BlueprintPure, Category = "Simple HTTP Client|Conversation")
+	int32 GetNumMessages() const
+	{
+		return NumPinned + Messages.Num();
+	}
+
+	// Number of not pinned messages left out of the body by TokenBudget
+	UFUNCTION(BlueprintPure, Category = "Simple HTTP Client|Conversation")
+	int32 GetNumTruncatedMessages() const;
+
+	// Estimated number of tokens of messages included in the body
+	UFUNCTION(BlueprintPure, Category = "Simple HTTP Client|Conversation")
+	int32 GetEstimatedTokens() const;
+
+	// Request body as string (for SendHttpRequest)
+	UFUNCTION(BlueprintPure, Category = "Simple HTTP Client|Conversation")
+	FString GetRequestBody() const;
+
+	// Request body as UTF-8 (for SendHttpRequestData), doesn't need to be encoded again
+	UFUNCTION(BlueprintPure, Category = "Simple HTTP Client|Conversation")
+	TArray<uint8> GetRequestBodyData() const;
+
+	void BuildRequestBody(TArray<uint8>& OutData) const;
+
+	// Maximum estimated size of messages in tokens; 0 to send all messages. The last message is always sent.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Conversation", meta = (ClampMin = "0"))
+	int32 TokenBudget = 0;
+
+	// Size of token (UTF-8 bytes of message json) used to estimate number of tokens
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Conversation", meta = (ClampMin = "1.0"))
+	float BytesPerToken = 4.f;
+
+private:
+	struct FMessage
+	{
+		int32 Offset = 0;
+		int32 Size = 0;
+		// size of all previous messages (bytes)
+		int64 BytesBefore = 0;
+	};
+
+	/** Append serialized message to cache */
+	void AppendMessage(const uint8* Data, int32 Size, bool bPinned);
+
+	/** Index of the first message fitting TokenBudget */
+	int32 GetFirstIncludedMessage() const;
+
+	int32 EstimateTokens(int64 Bytes) const;
+
+	FString MessagesField = TEXT("messages");
+
+	// template object without closing bracket and with "messages":[
+	TArray<uint8> BodyPrefix;
+
+	// pinned messages separated with commas
+	TArray<uint8> PinnedData;
+	int32 NumPinned = 0;
+
+	// other messages in order, without separators
+	TArray<uint8> MessageData;
+	TArray<FMessage> Messages;
+};
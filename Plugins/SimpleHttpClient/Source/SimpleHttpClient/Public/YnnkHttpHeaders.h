@@ -0,0 +1,84 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpResponse.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "YnnkHttpHeaders.generated.h"
+
+struct FYnnkHttpHeaderData;
+
+/**
+* Response headers. Header lines are copied from response, so stored copy doesn't keep content alive.
+* They are parsed to case-insensitive map on first access; copies share the same map.
+*/
+USTRUCT(BlueprintType, Category = "Simple HTTP Client")
+struct SIMPLEHTTPCLIENT_API FYnnkHttpHeaders
+{
+	GENERATED_BODY()
+
+	FYnnkHttpHeaders() = default;
+	/** Copy headers of http module response */
+	explicit FYnnkHttpHeaders(FHttpResponsePtr Response);
+	/** Headers as "Name: Value" lines */
+	explicit FYnnkHttpHeaders(TArray<FString> Lines);
+
+	bool IsEmpty() const;
+
+	/** Value of header or nullptr. Name is case-insensitive. */
+	const FString* Find(const FString& Name) const;
+
+	FString GetValue(const FString& Name) const
+	{
+		const FString* Value = Find(Name);
+		return Value ? *Value : FString();
+	}
+
+	/** Content-Length or -1 */
+	int64 GetContentLength() const;
+
+	/** Content-Type without parameters (charset etc.) */
+	FString GetContentType() const;
+
+	/** Retry-After in seconds (number or http-date) or -1 */
+	float GetRetryAfter() const;
+
+	/** Headers as "Name: Value" lines (format of OnTextResponse) */
+	TArray<FString> ToArray() const;
+
+	/** All headers. Duplicate headers are joined with comma. */
+	const TMap<FString, FString>& GetMap() const;
+
+private:
+	TSharedPtr<FYnnkHttpHeaderData, ESPMode::ThreadSafe> Data;
+};
+
+/**
+* Blueprint access to response headers
+*/
+UCLASS()
+class SIMPLEHTTPCLIENT_API UYnnkHttpHeadersLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+	// Header value by case-insensitive name
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "Get Header"), Category = "HTTP Headers")
+	static bool GetHeaderValue(const FYnnkHttpHeaders& Headers, const FString& Name, FString& Value);
+
+	// -1 if not specified
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "Get Content Length"), Category = "HTTP Headers")
+	static int64 GetHeaderContentLength(const FYnnkHttpHeaders& Headers);
+
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "Get Content Type"), Category = "HTTP Headers")
+	static FString GetHeaderContentType(const FYnnkHttpHeaders& Headers);
+
+	// Seconds or -1 if not specified
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "Get Retry After"), Category = "HTTP Headers")
+	static float GetHeaderRetryAfter(const FYnnkHttpHeaders& Headers);
+
+	UFUNCTION(BlueprintPure, meta = (DisplayName = "To Array (Headers)"), Category = "HTTP Headers")
+	static TArray<FString> HeadersToArray(const FYnnkHttpHeaders& Headers);
+};
@@ -0,0 +1,311 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "YnnkHttpMetrics.generated.h"
+
+/**
+* Timings of a finished request (seconds). Zero if the stage wasn't reached.
+*/
+USTRUCT(BlueprintType, Category = "Simple HTTP Client")
+struct FYnnkHttpRequestMetrics
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Request Metrics")
+	FName Keyword;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Request Metrics")
+	FString Host;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Request Metrics")
+	int32 ResponseCode = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Request Metrics")
+	bool bSucceeded = false;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Request Metrics")
+	int32 Attempts = 0;
+
+	// Host had a response within connection idle timeout before the last attempt, so its connection was expected to be reused
+	UPROPERTY(BlueprintReadOnly, Category = "Request Metrics")
+	bool bReusedConnection = false;
+
+	// From send call to the last attempt passed to http module (includes retry backoff)
+	UPROPERTY(BlueprintReadOnly, Category = "Request Metrics")
+	float QueueTime = 0.f;
+
+	// From sending to the first response header
+	UPROPERTY(BlueprintReadOnly, Category = "Request Metrics")
+	float ConnectTime = 0.f;
+
+	// From sending to the first byte of body
+	UPROPERTY(BlueprintReadOnly, Category = "Request Metrics")
+	float TimeToFirstByte = 0.f;
+
+	// From sending to the first non-empty chunk of text stream
+	UPROPERTY(BlueprintReadOnly, Category = "Request Metrics")
+	float TimeToFirstToken = 0.f;
+
+	// From send call to completion
+	UPROPERTY(BlueprintReadOnly, Category = "Request Metrics")
+	float TotalTime = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Request Metrics")
+	int64 BytesReceived = 0;
+
+	// Stream chunks
+	UPROPERTY(BlueprintReadOnly, Category = "Request Metrics")
+	int32 ChunksReceived = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Request Metrics")
+	float MeanChunkInterval = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Request Metrics")
+	float MaxChunkInterval = 0.f;
+};
+
+/**
+* Counters of stream overflow policies since start or ResetStreamBackpressureStats
+*/
+USTRUCT(BlueprintType, Category = "Simple HTTP Client")
+struct FYnnkStreamBackpressureStats
+{
+	GENERATED_BODY()
+
+	// Stream chunks waiting for game thread (bytes)
+	UPROPERTY(BlueprintReadOnly, Category = "Backpressure Stats")
+	int64 PendingBytes = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Backpressure Stats")
+	int64 PeakPendingBytes = 0;
+
+	// Buffer of request was full and new chunks were parked (Park and Coalesce policies)
+	UPROPERTY(BlueprintReadOnly, Category = "Backpressure Stats")
+	int32 Parks = 0;
+
+	// Total time while chunks waited in parking space (seconds)
+	UPROPERTY(BlueprintReadOnly, Category = "Backpressure Stats")
+	float ParkedTime = 0.f;
+
+	// Chunks merged with previous ones (Coalesce policy)
+	UPROPERTY(BlueprintReadOnly, Category = "Backpressure Stats")
+	int32 CoalescedChunks = 0;
+
+	// Audio frames dropped (DropAudioFrames policy, or frame larger than stream buffer)
+	UPROPERTY(BlueprintReadOnly, Category = "Backpressure Stats")
+	int32 DroppedFrames = 0;
+};
+
+/**
+* Distribution of one metric in the rolling window (seconds)
+*/
+USTRUCT(BlueprintType, Category = "Simple HTTP Client")
+struct FYnnkHttpMetricStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Metric Stats")
+	int32 Count = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Metric Stats")
+	float Mean = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Metric Stats")
+	float P50 = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Metric Stats")
+	float P90 = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Metric Stats")
+	float P99 = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Metric Stats")
+	float Max = 0.f;
+};
+
+/**
+* Aggregated metrics of requests with the same keyword or host
+*/
+USTRUCT(BlueprintType, Category = "Simple HTTP Client")
+struct FYnnkHttpMetricsSnapshot
+{
+	GENERATED_BODY()
+
+	// Keyword or host
+	UPROPERTY(BlueprintReadOnly, Category = "Metrics Snapshot")
+	FString Name;
+
+	// Total since last reset
+	UPROPERTY(BlueprintReadOnly, Category = "Metrics Snapshot")
+	int32 NumRequests = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Metrics Snapshot")
+	int32 NumFailed = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Metrics Snapshot")
+	int64 BytesReceived = 0;
+
+	// Requests sent to warm host (see FYnnkHttpRequestMetrics::bReusedConnection)
+	UPROPERTY(BlueprintReadOnly, Category = "Metrics Snapshot")
+	int32 NumReusedConnections = 0;
+
+	// NumReusedConnections / NumRequests
+	UPROPERTY(BlueprintReadOnly, Category = "Metrics Snapshot")
+	float ConnectionReuseRate = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Metrics Snapshot")
+	FYnnkHttpMetricStats QueueTime;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Metrics Snapshot")
+	FYnnkHttpMetricStats ConnectTime;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Metrics Snapshot")
+	FYnnkHttpMetricStats TimeToFirstByte;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Metrics Snapshot")
+	FYnnkHttpMetricStats TimeToFirstToken;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Metrics Snapshot")
+	FYnnkHttpMetricStats TotalTime;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Metrics Snapshot")
+	FYnnkHttpMetricStats ChunkInterval;
+};
+
+/**
+* Time points of the active request (FPlatformTime::Seconds)
+*/
+struct FYnnkHttpRequestTiming
+{
+	double SubmitTime = 0.0;
+	double SendTime = 0.0;
+	double HeadersTime = 0.0;
+	double FirstByteTime = 0.0;
+	double FirstTokenTime = 0.0;
+	double LastChunkTime = 0.0;
+	int64 BytesReceived = 0;
+	int32 ChunksReceived = 0;
+	double ChunkIntervalSum = 0.0;
+	double ChunkIntervalMax = 0.0;
+	bool bWarmConnection = false;
+
+	/** Request created by send function */
+	void Submit(double Now)
+	{
+		*this = FYnnkHttpRequestTiming();
+		SubmitTime = Now;
+	}
+
+	/** New attempt passed to http module */
+	void StartAttempt(double Now)
+	{
+		const double Submitted = SubmitTime;
+		*this = FYnnkHttpRequestTiming();
+		SubmitTime = Submitted;
+		SendTime = Now;
+	}
+
+	void AddChunk(double Now, int64 Size)
+	{
+		if (FirstByteTime == 0.0)
+		{
+			FirstByteTime = Now;
+		}
+		else
+		{
+			const double Interval = Now - LastChunkTime;
+			ChunkIntervalSum += Interval;
+			ChunkIntervalMax = FMath::Max(ChunkIntervalMax, Interval);
+		}
+		LastChunkTime = Now;
+		BytesReceived += Size;
+		ChunksReceived++;
+	}
+};
+
+/**
+* Histogram of the last N samples with log-scaled buckets (100 us to ~3 min).
+* Percentiles are found by bucket counts without sorting or allocations.
+*/
+class SIMPLEHTTPCLIENT_API FYnnkRollingHistogram
+{
+public:
+	static constexpr int32 NumBuckets = 64;
+
+	FYnnkRollingHistogram(int32 InWindowSize = 256);
+
+	void Add(float Value);
+	void Reset();
+	FYnnkHttpMetricStats GetStats() const;
+
+	int32 Num() const
+	{
+		return NumSamples;
+	}
+
+private:
+	static int32 GetBucket(float Value);
+	static float GetBucketUpperBound(int32 Bucket);
+	float GetPercentile(float Percentile) const;
+
+	TArray<float> Samples;
+	int32 NextSample = 0;
+	int32 NumSamples = 0;
+	double Sum = 0.0;
+	int32 BucketCounts[NumBuckets];
+};
+
+/**
+* Rolling metrics of finished requests grouped by keyword and host
+*/
+class SIMPLEHTTPCLIENT_API FYnnkHttpMetrics
+{
+public:
+	FYnnkHttpMetrics(int32 InWindowSize = 256)
+		: WindowSize(InWindowSize)
+		, Total(InWindowSize)
+	{}
+
+	void Record(const FYnnkHttpRequestMetrics& Metrics);
+	void Reset();
+
+	bool GetKeywordSnapshot(FName Keyword, FYnnkHttpMetricsSnapshot& OutSnapshot) const;
+	bool GetHostSnapshot(const FString& Host, FYnnkHttpMetricsSnapshot& OutSnapshot) const;
+	void GetTotalSnapshot(FYnnkHttpMetricsSnapshot& OutSnapshot) const;
+	void GetAllSnapshots(TArray<FYnnkHttpMetricsSnapshot>& OutKeywords, TArray<FYnnkHttpMetricsSnapshot>& OutHosts) const;
+
+private:
+	struct FGroup
+	{
+		FGroup(int32 InWindowSize = 256)
+			: QueueTime(InWindowSize), ConnectTime(InWindowSize), TimeToFirstByte(InWindowSize), TimeToFirstToken(InWindowSize), TotalTime(InWindowSize), ChunkInterval(InWindowSize)
+		{}
+
+		int32 NumRequests = 0;
+		int32 NumFailed = 0;
+		int64 BytesReceived = 0;
+		int32 NumReusedConnections = 0;
+		FYnnkRollingHistogram QueueTime;
+		FYnnkRollingHistogram ConnectTime;
+		FYnnkRollingHistogram TimeToFirstByte;
+		FYnnkRollingHistogram TimeToFirstToken;
+		FYnnkRollingHistogram TotalTime;
+		FYnnkRollingHistogram ChunkInterval;
+
+		void Add(const FYnnkHttpRequestMetrics& Metrics);
+		void GetSnapshot(const FString& Name, FYnnkHttpMetricsSnapshot& OutSnapshot) const;
+	};
+
+	FGroup& FindOrAddGroup(TMap<FName, FGroup>& Groups, FName Name);
+
+	int32 WindowSize;
+	mutable FCriticalSection Lock;
+	FGroup Total;
+	TMap<FName, FGroup> Keywords;
+	// host names are stored as FName too to avoid string hashing
+	TMap<FName, FGroup> Hosts;
+};
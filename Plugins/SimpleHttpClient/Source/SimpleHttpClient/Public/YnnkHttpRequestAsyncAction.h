@@ -0,0 +1,71 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "YnnkHttpTypes.h"
+#include "YnnkHttpRequestAsyncAction.generated.h"
+
+class UHTTPSubsystem;
+struct FYnnkHttpResponse;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FYnnkHttpAsyncActionEvent, int32, Code, const TArray<FString>&, Headers, const FString&, Text, const TArray<uint8>&, Data);
+
+/**
+* Blueprint node sending one request. Its events are called only for this request and always in game thread.
+*/
+UCLASS()
+class SIMPLEHTTPCLIENT_API UYnnkHttpRequestAsyncAction : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	// Chunk of text or data stream (Text or Data)
+	UPROPERTY(BlueprintAssignable)
+	FYnnkHttpAsyncActionEvent OnChunk;
+
+	// Response received (Text or Data depending on response type)
+	UPROPERTY(BlueprintAssignable)
+	FYnnkHttpAsyncActionEvent OnCompleted;
+
+	// Request failed without response, returned error code or was cancelled
+	UPROPERTY(BlueprintAssignable)
+	FYnnkHttpAsyncActionEvent OnFailed;
+
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "HTTP Request (Async)"), Category = "HTTP Subsystem")
+	static UYnnkHttpRequestAsyncAction* SendHttpRequestAsync(UObject* WorldContextObject, FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FString& BodyString,
+		const FYnnkHttpRequestOptions& Options, EExpectedResponseType ExpectedResponseFormat = EExpectedResponseType::Default, bool bWantHeaders = false);
+
+	virtual void Activate() override;
+
+	// Cancel request sent by this node
+	UFUNCTION(BlueprintCallable, Category = "HTTP Subsystem")
+	void Cancel();
+
+	UFUNCTION(BlueprintPure, Category = "HTTP Subsystem")
+	FYnnkHttpRequestHandle GetRequestHandle() const
+	{
+		return RequestHandle;
+	}
+
+private:
+	void HandleTextChunk(FStringView Text);
+	void HandleDataChunk(TArrayView<const uint8> Data);
+	void HandleComplete(const FYnnkHttpResponse& Response);
+
+	UPROPERTY()
+	UHTTPSubsystem* HttpSubsystem = nullptr;
+
+	FName Keyword;
+	FString URL;
+	ERequestMethod Verb = ERequestMethod::Post;
+	TArray<FYnnkUrlParameter> HeaderParams;
+	FString BodyString;
+	FYnnkHttpRequestOptions Options;
+	EExpectedResponseType ExpectedResponseFormat = EExpectedResponseType::Default;
+	bool bWantHeaders = false;
+
+	FYnnkHttpRequestHandle RequestHandle;
+};
@@ -0,0 +1,105 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "YnnkHttpSubscriptions.generated.h"
+
+DECLARE_DYNAMIC_DELEGATE_TwoParams(FHttpKeywordTextEvent, const FName&, RequestName, const FString&, Text);
+DECLARE_DYNAMIC_DELEGATE_TwoParams(FHttpKeywordDataEvent, const FName&, RequestName, const TArray<uint8>&, Data);
+DECLARE_DYNAMIC_DELEGATE_FourParams(FHttpKeywordTextResponseEvent, const FName&, RequestName, int32, Code, const TArray<FString>&, Headers, const FString&, Data);
+DECLARE_DYNAMIC_DELEGATE_FourParams(FHttpKeywordDataResponseEvent, const FName&, RequestName, int32, Code, const TArray<FString>&, Headers, const TArray<uint8>&, Data);
+DECLARE_DYNAMIC_DELEGATE_TwoParams(FHttpKeywordErrorEvent, const FName&, RequestName, int32, Code);
+
+/**
+* Events of UHTTPSubsystem subscribed by request keyword.
+* Broadcast is a map lookup, so only listeners of the keyword are called.
+*/
+class SIMPLEHTTPCLIENT_API FYnnkHttpSubscriptions
+{
+public:
+	struct FSubscribers
+	{
+		TArray<FHttpKeywordTextEvent> TextStream;
+		TArray<FHttpKeywordDataEvent> DataStream;
+		TArray<FHttpKeywordTextResponseEvent> TextResponse;
+		TArray<FHttpKeywordDataResponseEvent> DataResponse;
+		TArray<FHttpKeywordErrorEvent> Error;
+
+		bool IsEmpty() const
+		{
+			return TextStream.Num() + DataStream.Num() + TextResponse.Num() + DataResponse.Num() + Error.Num() == 0;
+		}
+	};
+
+	template<typename DelegateType>
+	void Add(FName Keyword, TArray<DelegateType> FSubscribers::* List, const DelegateType& Event)
+	{
+		if (!Event.IsBound())
+		{
+			return;
+		}
+		FScopeLock Lock(&SubscribersLock);
+		TArray<DelegateType>& Events = Subscribers.FindOrAdd(Keyword).*List;
+		// drop events of destroyed listeners
+		Events.RemoveAll([](const DelegateType& Item) { return !Item.IsBound(); });
+		Events.AddUnique(Event);
+		NumKeywords.Set(Subscribers.Num());
+	}
+
+	/** Remove events of the listener. If Keyword is None, listener is removed from all keywords. */
+	void Remove(FName Keyword, const UObject* Listener);
+
+	void Reset();
+
+	/** Fast check without lock */
+	bool IsEmpty() const
+	{
+		return NumKeywords.GetValue() == 0;
+	}
+
+	template<typename DelegateType>
+	bool HasSubscribers(FName Keyword, TArray<DelegateType> FSubscribers::* List) const
+	{
+		if (IsEmpty())
+		{
+			return false;
+		}
+		FScopeLock Lock(&SubscribersLock);
+		const FSubscribers* KeywordSubscribers = Subscribers.Find(Keyword);
+		return KeywordSubscribers && (KeywordSubscribers->*List).Num() > 0;
+	}
+
+	/** Call events of keyword. Events are copied, so listeners can unsubscribe while being called. */
+	template<typename DelegateType, typename... ArgTypes>
+	void Broadcast(FName Keyword, TArray<DelegateType> FSubscribers::* List, const ArgTypes&... Args) const
+	{
+		if (IsEmpty())
+		{
+			return;
+		}
+
+		TArray<DelegateType, TInlineAllocator<4>> Events;
+		{
+			FScopeLock Lock(&SubscribersLock);
+			const FSubscribers* KeywordSubscribers = Subscribers.Find(Keyword);
+			if (!KeywordSubscribers)
+			{
+				return;
+			}
+			Events.Append(KeywordSubscribers->*List);
+		}
+		for (const DelegateType& Event : Events)
+		{
+			Event.ExecuteIfBound(Keyword, Args...);
+		}
+	}
+
+private:
+	mutable FCriticalSection SubscribersLock;
+	TMap<FName, FSubscribers> Subscribers;
+	FThreadSafeCounter NumKeywords;
+};
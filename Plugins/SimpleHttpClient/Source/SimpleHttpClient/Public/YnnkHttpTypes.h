@@ -1,189 +1,468 @@
-// Copyright (c) YuriNK, 2023, All Rights Reserved.
-// ykasczc@gmail.com
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "Interfaces/IHttpRequest.h"
-#include "Engine/DataTable.h"
-#include "GameplayTagContainer.h"
-#include "Dom/JsonObject.h"
-#include "Dom/JsonValue.h"
-#include "Serialization/JsonWriter.h"
-#include "Serialization/JsonReader.h"
-#include "Serialization/JsonSerializer.h"
-#include "Misc/Guid.h"
-
-#include "YnnkHttpTypes.generated.h"
-
-UENUM(BlueprintType)
-enum class ERequestMethod : uint8
-{
-	Get			UMETA(DisplayName = "GET"),
-	Post		UMETA(DisplayName = "POST")
-};
-
-UENUM(BlueprintType)
-enum class EExpectedResponseType : uint8
-{
-	Default		UMETA(DisplayName = "Auto"),
-	Text		UMETA(DisplayName = "Text"),
-	Data		UMETA(DisplayName = "Binary Data"),
-	StreamText	UMETA(DisplayName = "Text Stream"),
-	StreamData	UMETA(DisplayName = "Data Stream")
-};
-
-
-/**
-* Http-request header parameters
-*/
-USTRUCT(BlueprintType, Category = "Simple HTTP Client")
-struct FYnnkUrlParameter
-{
-	GENERATED_BODY()
-
-	// Header parameter name
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Eleven Header")
-	FString Name;
-
-	// Header parameter value
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Eleven Header")
-	FString Value;
-
-	FYnnkUrlParameter() {};
-	FYnnkUrlParameter(FString InKey, FString InValue)
-		: Name(InKey), Value(InValue)
-	{}
-	FYnnkUrlParameter(FString InKey, int32 InValue)
-		: Name(InKey), Value(FString::FromInt(InValue))
-	{}
-	FYnnkUrlParameter(FString InKey, float InValue)
-		: Name(InKey)
-	{
-		FString s = FString::SanitizeFloat(InValue);
-		s.ReplaceCharInline(',', '.');
-		Value = s;
-	}
-};
-
-/**
-* Simple http-request with header and body
-*/
-USTRUCT(BlueprintType, Category = "Simple HTTP Client")
-struct FYnnkHttpRequest
-{
-	GENERATED_BODY()
-
-	// ID to recognize requests in a queue
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Eleven Request")
-	int32 Id = INDEX_NONE;
-
-	// Request URL
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Eleven Request")
-	FString URL;
-
-	// Get/Post method
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Eleven Request")
-	ERequestMethod Method = ERequestMethod::Post;
-
-	// Header parameters
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Eleven Request")
-	TArray<FYnnkUrlParameter> Parameters;
-
-	// Request body (can be empty)
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Eleven Request")
-	FString Body;
-
-	FYnnkHttpRequest() {};
-	FYnnkHttpRequest(FString InUrl, ERequestMethod InMethod)
-		: URL(InUrl), Method(InMethod)
-	{}
-	FYnnkHttpRequest(FString InUrl, ERequestMethod InMethod, const FYnnkUrlParameter& Param1)
-		: URL(InUrl), Method(InMethod)
-	{
-		Parameters.Add(Param1);
-	}
-	FYnnkHttpRequest(FString InUrl, ERequestMethod InMethod, const FYnnkUrlParameter& Param1, const FYnnkUrlParameter& Param2)
-		: URL(InUrl), Method(InMethod)
-	{
-		Parameters.Add(Param1); Parameters.Add(Param2);
-	}
-	FYnnkHttpRequest(FString InUrl, ERequestMethod InMethod, const FYnnkUrlParameter& Param1, const FYnnkUrlParameter& Param2, const FYnnkUrlParameter& Param3)
-		: URL(InUrl), Method(InMethod)
-	{
-		Parameters.Add(Param1); Parameters.Add(Param2); Parameters.Add(Param3);
-	}
-
-	bool IsValid() const
-	{
-		return (Id != INDEX_NONE);
-	}
-	void Invalidate()
-	{
-		Id = INDEX_NONE;
-	}
-};
-
-/**
-* Simple http-request with header and body
-*/
-USTRUCT(BlueprintType, Category = "Simple HTTP Client")
-struct SIMPLEHTTPCLIENT_API FJsonItem
-{
-	GENERATED_BODY()
-
-protected:
-
-	UPROPERTY()
-	FString Body;
-
-	bool SetValue(FString Path, EJson Format, float ValueNumeric = 0.f, const FString& ValueStr = TEXT(""), bool bValue = false);
-	bool GetValue(const FString& Path, EJson Format, float* ValueNumeric = nullptr, FString* ValueStr = nullptr, bool* bValue = nullptr) const;
-	bool GetChildObjectByPath(TSharedPtr<FJsonObject>& InParentObjectField, TSharedPtr<FJsonObject>& OutChildObjectField, FString FieldNameAsPath) const;
-	bool SetTargetValue(TSharedPtr<FJsonObject>& InParentObjectField, const FString& FieldName, TSharedPtr<FJsonValue>& NewValue) const;
-
-	bool AddArrayItem(const FString& Path, EJson Format, float ValueNumeric = 0.f, const FString& ValueStr = TEXT(""), bool bValue = false);
-
-public:
-
-	FString AsString() const
-	{
-		return Body;
-	}
-
-	void FromString(const FString& InData)
-	{
-		Body = InData;
-	}
-
-	bool IsValid() const
-	{
-		const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Body);
-		TSharedPtr<FJsonObject> JsonResponse = MakeShareable(new FJsonObject);
-		return FJsonSerializer::Deserialize(Reader, JsonResponse);
-	}
-
-	bool SetStringValue(const FString& Path, const FString& Value)
-	{ return SetValue(Path, EJson::String, 0.f, Value); };
-	bool SetFloatValue(const FString& Path, const float Value)
-	{ return SetValue(Path, EJson::Number, Value); };
-	bool SetBooleanValue(const FString& Path, const bool Value)
-	{ return SetValue(Path, EJson::Boolean, 0.f, "", Value); };
-	bool SetArrayValue(const FString& Path, const FString& Value)
-	{ return SetValue(Path, EJson::Array, 0.f, Value); };
-
-	bool AddStringArrayItem(const FString& Path, const FString& Value)
-	{ return AddArrayItem(Path, EJson::String, 0.0f, Value, false); }
-	bool AddFloatArrayItem(const FString& Path, const float Value)
-	{ return AddArrayItem(Path, EJson::Number, Value, TEXT(""), false); }
-	bool AddBooleanArrayItem(const FString& Path, const bool Value)
-	{ return AddArrayItem(Path, EJson::Boolean, 0.0f, TEXT(""), Value); }
-	bool AddObjectArrayItem(const FString& Path, const FString& Value)
-	{ return AddArrayItem(Path, EJson::Object, 0.0f, Value, false); }
-
-	FString GetStringValue(const FString& Path) const;
-	float GetFloatValue(const FString& Path) const;
-	bool GetBooleanValue(const FString& Path) const;
-
-};
-
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Engine/DataTable.h"
+#include "GameplayTagContainer.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/Guid.h"
+
+#include "YnnkHttpTypes.generated.h"
+
+UENUM(BlueprintType)
+enum class ERequestMethod : uint8
+{
+	Get			UMETA(DisplayName = "GET"),
+	Post		UMETA(DisplayName = "POST")
+};
+
+UENUM(BlueprintType)
+enum class EExpectedResponseType : uint8
+{
+	Default		UMETA(DisplayName = "Auto"),
+	Text		UMETA(DisplayName = "Text"),
+	Data		UMETA(DisplayName = "Binary Data"),
+	StreamText	UMETA(DisplayName = "Text Stream"),
+	StreamData	UMETA(DisplayName = "Data Stream"),
+	StreamAudio	UMETA(DisplayName = "Audio Stream (PCM Frames)")
+};
+
+UENUM(BlueprintType)
+enum class EYnnkContentEncoding : uint8
+{
+	None		UMETA(DisplayName = "None"),
+	Gzip		UMETA(DisplayName = "gzip"),
+	Deflate		UMETA(DisplayName = "deflate")
+};
+
+UENUM(BlueprintType)
+enum class EYnnkHttpTransportMode : uint8
+{
+	Live		UMETA(DisplayName = "Live"),
+	Record		UMETA(DisplayName = "Live and Record"),
+	Replay		UMETA(DisplayName = "Replay Recordings")
+};
+
+// What to do with stream chunk when it doesn't fit request buffer or global budget (game thread doesn't read chunks fast enough)
+UENUM(BlueprintType)
+enum class EYnnkStreamOverflowPolicy : uint8
+{
+	// Keep chunks of the request in parking space until game thread frees the buffer. Nothing is dropped, parking space grows while game thread is late.
+	Park			UMETA(DisplayName = "Park Until Read"),
+	// Park and broadcast all pending chunks of request as one chunk when buffer or global budget is nearly full
+	Coalesce		UMETA(DisplayName = "Coalesce Pending Chunks"),
+	// Drop new audio frames (StreamAudio) instead of parking them; other formats are parked
+	DropAudioFrames	UMETA(DisplayName = "Drop Audio Frames")
+};
+
+
+/**
+* Http-request header parameters
+*/
+USTRUCT(BlueprintType, Category = "Simple HTTP Client")
+struct FYnnkUrlParameter
+{
+	GENERATED_BODY()
+
+	// Header parameter name
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Eleven Header")
+	FString Name;
+
+	// Header parameter value
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Eleven Header")
+	FString Value;
+
+	FYnnkUrlParameter() {};
+	FYnnkUrlParameter(FString InKey, FString InValue)
+		: Name(InKey), Value(InValue)
+	{}
+	FYnnkUrlParameter(FString InKey, int32 InValue)
+		: Name(InKey), Value(FString::FromInt(InValue))
+	{}
+	FYnnkUrlParameter(FString InKey, float InValue)
+		: Name(InKey)
+	{
+		FString s = FString::SanitizeFloat(InValue);
+		s.ReplaceCharInline(',', '.');
+		Value = s;
+	}
+};
+
+/**
+* Settings of WebSocket channel opened by UHTTPSubsystem::OpenWebSocket
+*/
+USTRUCT(BlueprintType, Category = "Simple HTTP Client")
+struct FYnnkWebSocketOptions
+{
+	GENERATED_BODY()
+
+	// Sec-WebSocket-Protocol (empty to not request subprotocol)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WebSocket")
+	FString Protocol;
+
+	// Outgoing messages waiting for connection or send rate above this size (bytes) are rejected
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WebSocket", meta = (ClampMin = "1024"))
+	int32 MaxQueuedBytes = 1048576;
+
+	// Limit of outgoing data rate (KB per second), 0 for unlimited
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WebSocket", meta = (ClampMin = "0"))
+	float MaxSendRate = 0.f;
+
+	// Broadcast fragments of binary messages as they arrive instead of whole messages
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "WebSocket")
+	bool bDeliverBinaryFragments = false;
+};
+
+/**
+* Simple http-request with header and body
+*/
+USTRUCT(BlueprintType, Category = "Simple HTTP Client")
+struct FYnnkHttpRequest
+{
+	GENERATED_BODY()
+
+	// ID to recognize requests in a queue
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Eleven Request")
+	int32 Id = INDEX_NONE;
+
+	// Request URL
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Eleven Request")
+	FString URL;
+
+	// Get/Post method
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Eleven Request")
+	ERequestMethod Method = ERequestMethod::Post;
+
+	// Header parameters
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Eleven Request")
+	TArray<FYnnkUrlParameter> Parameters;
+
+	// Request body (can be empty)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Eleven Request")
+	FString Body;
+
+	FYnnkHttpRequest() {};
+	FYnnkHttpRequest(FString InUrl, ERequestMethod InMethod)
+		: URL(InUrl), Method(InMethod)
+	{}
+	FYnnkHttpRequest(FString InUrl, ERequestMethod InMethod, const FYnnkUrlParameter& Param1)
+		: URL(InUrl), Method(InMethod)
+	{
+		Parameters.Add(Param1);
+	}
+	FYnnkHttpRequest(FString InUrl, ERequestMethod InMethod, const FYnnkUrlParameter& Param1, const FYnnkUrlParameter& Param2)
+		: URL(InUrl), Method(InMethod)
+	{
+		Parameters.Add(Param1); Parameters.Add(Param2);
+	}
+	FYnnkHttpRequest(FString InUrl, ERequestMethod InMethod, const FYnnkUrlParameter& Param1, const FYnnkUrlParameter& Param2, const FYnnkUrlParameter& Param3)
+		: URL(InUrl), Method(InMethod)
+	{
+		Parameters.Add(Param1); Parameters.Add(Param2); Parameters.Add(Param3);
+	}
+
+	bool IsValid() const
+	{
+		return (Id != INDEX_NONE);
+	}
+	void Invalidate()
+	{
+		Id = INDEX_NONE;
+	}
+};
+
+/**
+* Retry and hedging rules of a single http-request
+*/
+USTRUCT(BlueprintType, Category = "Simple HTTP Client")
+struct FYnnkRetryPolicy
+{
+	GENERATED_BODY()
+
+	// Total number of attempts, 1 means no retries
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Retry", meta = (ClampMin = "1"))
+	int32 MaxAttempts = 1;
+
+	// Delay before the first retry (seconds)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Retry", meta = (ClampMin = "0"))
+	float InitialBackoff = 0.5f;
+
+	// Delay is multiplied by this value after every failed attempt
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Retry", meta = (ClampMin = "1"))
+	float BackoffMultiplier = 2.f;
+
+	// Upper limit of delay between attempts (seconds)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Retry", meta = (ClampMin = "0"))
+	float MaxBackoff = 10.f;
+
+	// Random deviation of delay as a fraction of it (0.2 = +-20%)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Retry", meta = (ClampMin = "0", ClampMax = "1"))
+	float Jitter = 0.2f;
+
+	// Response codes to retry. Connection failures are always retried.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Retry")
+	TArray<int32> RetryOnCodes = { 408, 429, 500, 502, 503, 504 };
+
+	// Timeout of a single attempt (seconds), 0 to use subsystem Timeout
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Retry", meta = (ClampMin = "0"))
+	float AttemptTimeout = 0.f;
+
+	// Send a duplicate request if the first one didn't receive any data in this time (seconds), 0 to disable.
+	// Whichever request finishes first wins, the other one is cancelled.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Hedging", meta = (ClampMin = "0"))
+	float HedgeDelay = 0.f;
+
+	bool CanRetryCode(int32 ResponseCode) const
+	{
+		return ResponseCode <= 0 || RetryOnCodes.Contains(ResponseCode);
+	}
+
+	float GetBackoff(int32 FailedAttempts) const
+	{
+		const float Delay = FMath::Min(InitialBackoff * FMath::Pow(BackoffMultiplier, (float)FMath::Max(FailedAttempts - 1, 0)), MaxBackoff);
+		return FMath::Max(Delay * (1.f + FMath::FRandRange(-Jitter, Jitter)), 0.f);
+	}
+};
+
+/**
+* Format of PCM audio
+*/
+USTRUCT(BlueprintType, Category = "Simple HTTP Client")
+struct FYnnkPcmFormat
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PCM Format")
+	int32 SampleRate = 24000;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PCM Format")
+	int32 NumChannels = 1;
+
+	// 16 or 32 for integer PCM, 32 for float
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PCM Format")
+	int32 BitsPerSample = 16;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PCM Format")
+	bool bFloat = false;
+
+	int32 GetBlockAlign() const
+	{
+		return FMath::Max(NumChannels * BitsPerSample / 8, 1);
+	}
+	int32 GetByteRate() const
+	{
+		return SampleRate * GetBlockAlign();
+	}
+	bool IsValid() const
+	{
+		return SampleRate > 0 && NumChannels > 0 && BitsPerSample >= 8 && BitsPerSample % 8 == 0;
+	}
+};
+
+/**
+* Settings of EExpectedResponseType::StreamAudio
+*/
+USTRUCT(BlueprintType, Category = "Simple HTTP Client")
+struct FYnnkAudioStreamSettings
+{
+	GENERATED_BODY()
+
+	// Duration of one frame (seconds)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio Stream", meta = (ClampMin = "0.005"))
+	float FrameDuration = 0.04f;
+
+	// Number of frames to accumulate before the first one is sent
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio Stream", meta = (ClampMin = "0"))
+	int32 PrerollFrames = 2;
+
+	// Capacity of buffer which collects received data to frames (seconds). Frames aren't paced: each one is sent as soon as it's complete after pre-roll.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio Stream", meta = (ClampMin = "0.1"))
+	float ReframeBufferDuration = 1.f;
+
+	// Format of stream without RIFF/WAV header
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio Stream")
+	FYnnkPcmFormat RawFormat;
+};
+
+/**
+* Additional per-request settings
+*/
+USTRUCT(BlueprintType, Category = "Simple HTTP Client")
+struct FYnnkHttpRequestOptions
+{
+	GENERATED_BODY()
+
+	// Retries and hedged requests
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Request Options")
+	FYnnkRetryPolicy RetryPolicy;
+
+	// Compress request body
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Compression")
+	EYnnkContentEncoding BodyEncoding = EYnnkContentEncoding::None;
+
+	// Body smaller than this size (bytes) is sent uncompressed
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Compression", meta = (ClampMin = "0"))
+	int32 CompressionThreshold = 2048;
+
+	// Ask server for compressed response (Accept-Encoding: gzip, deflate) and decode it, including stream modes
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Compression")
+	bool bDecompressResponse = false;
+
+	// Size of preallocated buffer (bytes) for stream chunks waiting to be broadcasted in game thread. Must fit at least one audio frame.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Request Options", meta = (ClampMin = "4096"))
+	int32 StreamBufferSize = 262144;
+
+	// Policy applied when stream buffer of request or global budget (UHTTPSubsystem::MaxPendingStreamBytes) is full
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Request Options")
+	EYnnkStreamOverflowPolicy StreamOverflowPolicy = EYnnkStreamOverflowPolicy::Park;
+
+	// Frames of EExpectedResponseType::StreamAudio
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Request Options")
+	FYnnkAudioStreamSettings AudioStream;
+
+	// Broadcast OnRequestProgressUpdated while sending and receiving data
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Request Options")
+	bool bReportProgress = false;
+
+	// Cancel active requests with the same keyword when this one is sent
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Request Options")
+	bool bReplacePrevious = false;
+
+	// Keep full text of StreamText response (read it with GetStreamedText instead of joining chunks); it's also passed to OnTextResponse
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Request Options")
+	bool bAccumulateText = false;
+
+	// If set, only tokens at this path of server-sent events are accumulated, e.g. "choices[0].delta.content"
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Request Options", meta = (EditCondition = "bAccumulateText"))
+	FString AccumulatedTokenPath;
+};
+
+/**
+* Identifies request sent by UHTTPSubsystem. Remains valid, but inactive, after request is finished.
+*/
+USTRUCT(BlueprintType, Category = "Simple HTTP Client")
+struct FYnnkHttpRequestHandle
+{
+	GENERATED_BODY()
+
+	// Slot of active request
+	UPROPERTY()
+	int32 RequestId = INDEX_NONE;
+
+	// Unique number of request (slots are reused)
+	UPROPERTY()
+	int32 Serial = 0;
+
+	FYnnkHttpRequestHandle()
+	{}
+
+	FYnnkHttpRequestHandle(int32 InRequestId, int32 InSerial)
+		: RequestId(InRequestId), Serial(InSerial)
+	{}
+
+	bool IsValid() const
+	{
+		return RequestId != INDEX_NONE;
+	}
+
+	bool operator==(const FYnnkHttpRequestHandle& Other) const
+	{
+		return RequestId == Other.RequestId && Serial == Other.Serial;
+	}
+};
+
+/**
+* One request of batch sent by UHTTPSubsystem::SendHttpBatch
+*/
+USTRUCT(BlueprintType, Category = "Simple HTTP Client")
+struct FYnnkHttpBatchItem
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Batch Item")
+	FString URL;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Batch Item")
+	ERequestMethod Verb = ERequestMethod::Post;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Batch Item")
+	TArray<FYnnkUrlParameter> HeaderParams;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Batch Item")
+	FString BodyString;
+
+	// Stream formats are received as whole responses (Text or Binary Data)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Batch Item")
+	EExpectedResponseType ExpectedResponseFormat = EExpectedResponseType::Default;
+};
+
+/**
+* Simple http-request with header and body
+*/
+USTRUCT(BlueprintType, Category = "Simple HTTP Client")
+struct SIMPLEHTTPCLIENT_API FJsonItem
+{
+	GENERATED_BODY()
+
+protected:
+
+	UPROPERTY()
+	FString Body;
+
+	bool SetValue(FString Path, EJson Format, float ValueNumeric = 0.f, const FString& ValueStr = TEXT(""), bool bValue = false);
+	bool GetValue(const FString& Path, EJson Format, float* ValueNumeric = nullptr, FString* ValueStr = nullptr, bool* bValue = nullptr) const;
+	bool GetChildObjectByPath(TSharedPtr<FJsonObject>& InParentObjectField, TSharedPtr<FJsonObject>& OutChildObjectField, FString FieldNameAsPath) const;
+	bool SetTargetValue(TSharedPtr<FJsonObject>& InParentObjectField, const FString& FieldName, TSharedPtr<FJsonValue>& NewValue) const;
+
+	bool AddArrayItem(const FString& Path, EJson Format, float ValueNumeric = 0.f, const FString& ValueStr = TEXT(""), bool bValue = false);
+
+public:
+
+	FString AsString() const
+	{
+		return Body;
+	}
+
+	void FromString(const FString& InData)
+	{
+		Body = InData;
+	}
+
+	bool IsValid() const
+	{
+		const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Body);
+		TSharedPtr<FJsonObject> JsonResponse = MakeShareable(new FJsonObject);
+		return FJsonSerializer::Deserialize(Reader, JsonResponse);
+	}
+
+	bool SetStringValue(const FString& Path, const FString& Value)
+	{ return SetValue(Path, EJson::String, 0.f, Value); };
+	bool SetFloatValue(const FString& Path, const float Value)
+	{ return SetValue(Path, EJson::Number, Value); };
+	bool SetBooleanValue(const FString& Path, const bool Value)
+	{ return SetValue(Path, EJson::Boolean, 0.f, "", Value); };
+	bool SetArrayValue(const FString& Path, const FString& Value)
+	{ return SetValue(Path, EJson::Array, 0.f, Value); };
+
+	bool AddStringArrayItem(const FString& Path, const FString& Value)
+	{ return AddArrayItem(Path, EJson::String, 0.0f, Value, false); }
+	bool AddFloatArrayItem(const FString& Path, const float Value)
+	{ return AddArrayItem(Path, EJson::Number, Value, TEXT(""), false); }
+	bool AddBooleanArrayItem(const FString& Path, const bool Value)
+	{ return AddArrayItem(Path, EJson::Boolean, 0.0f, TEXT(""), Value); }
+	bool AddObjectArrayItem(const FString& Path, const FString& Value)
+	{ return AddArrayItem(Path, EJson::Object, 0.0f, Value, false); }
+
+	FString GetStringValue(const FString& Path) const;
+	float GetFloatValue(const FString& Path) const;
+	bool GetBooleanValue(const FString& Path) const;
+
+};
+
@@ -0,0 +1,94 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "YnnkMultipartBody.generated.h"
+
+/**
+* Part of multipart/form-data body
+*/
+USTRUCT(BlueprintType, Category = "Simple HTTP Client")
+struct SIMPLEHTTPCLIENT_API FYnnkMultipartPart
+{
+	GENERATED_BODY()
+
+	// Form field name
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Multipart Part")
+	FString Name;
+
+	// Text value, used if FilePath and Data are empty
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Multipart Part")
+	FString Value;
+
+	// File sent as part content. It's read while sending and isn't loaded to memory.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Multipart Part")
+	FString FilePath;
+
+	// Binary content (if FilePath is empty)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Multipart Part")
+	TArray<uint8> Data;
+
+	// filename attribute of file or binary part. Name of FilePath is used if empty.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Multipart Part")
+	FString FileName;
+
+	// Content-Type of file or binary part. Detected by extension if empty.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Multipart Part")
+	FString ContentType;
+};
+
+/**
+* Builder of multipart/form-data body. Parts aren't concatenated: CreateReader() returns archive
+* which reads them one by one while request is being sent, so memory doesn't grow with size of uploaded files.
+* Byte parts are shared with the reader and must not be changed after they're added.
+*/
+class SIMPLEHTTPCLIENT_API FYnnkMultipartBody
+{
+public:
+	FYnnkMultipartBody();
+
+	void AddText(const FString& Name, const FString& Value);
+
+	void AddData(const FString& Name, TSharedRef<const TArray<uint8>, ESPMode::ThreadSafe> Data, const FString& FileName, const FString& ContentType);
+	void AddData(const FString& Name, TArray<uint8>&& Data, const FString& FileName, const FString& ContentType);
+
+	/** Add file to be read while sending. Returns false if file doesn't exist. */
+	bool AddFile(const FString& Name, const FString& FilePath, const FString& FileName = FString(), const FString& ContentType = FString());
+
+	/** Add text, data or file part depending on filled fields */
+	bool AddPart(const FYnnkMultipartPart& Part);
+
+	/** Value of Content-Type header with boundary */
+	FString GetContentType() const;
+
+	/** Size of the whole body including closing boundary */
+	int64 GetContentLength() const;
+
+	bool IsEmpty() const { return NumParts == 0; }
+
+	/** Archive reading the body. It can be rewound with Seek(0) to send the body again. */
+	TSharedRef<FArchive, ESPMode::ThreadSafe> CreateReader() const;
+
+	/** Read the whole body to memory (for engine versions without streamed request content) */
+	bool ReadToArray(TArray<uint8>& OutData) const;
+
+	struct FSegment
+	{
+		TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe> Bytes;
+		FString FilePath;
+		int64 Size = 0;
+	};
+
+private:
+	/** Append part headers or field value to the last in-memory segment */
+	void AppendInline(const FString& Text);
+	void AppendPartHeader(const FString& Name, const FString& FileName, const FString& ContentType);
+
+	FString Boundary;
+	TArray<FSegment> Segments;
+	// last segment is owned by the builder and can be extended
+	TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> InlineBytes;
+	int32 NumParts = 0;
+};
@@ -0,0 +1,75 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "YnnkHttpTypes.h"
+
+/**
+* Splits streamed WAV or raw PCM data to sample-aligned frames of fixed duration.
+* Buffers are allocated once when audio format is known and reused by following streams of the same format.
+*/
+class SIMPLEHTTPCLIENT_API FYnnkPcmStreamReframer
+{
+public:
+	/** Prepare to process a new stream */
+	void Init(const FYnnkAudioStreamSettings& InSettings);
+
+	/** Add data received from server. OnFrame is called for every complete frame after pre-roll. */
+	void Process(const uint8* Data, int32 Size, TFunctionRef<void(TArrayView<const uint8>)> OnFrame);
+
+	/** Emit all buffered data including incomplete frame (sample-aligned) */
+	void Flush(TFunctionRef<void(TArrayView<const uint8>)> OnFrame);
+
+	bool HasFormat() const
+	{
+		return bFormatKnown;
+	}
+
+	const FYnnkPcmFormat& GetFormat() const
+	{
+		return Format;
+	}
+
+	int32 GetFrameSize() const
+	{
+		return FrameSize;
+	}
+
+private:
+	enum class EHeaderResult : uint8
+	{
+		NeedMoreData,
+		Done,
+		Invalid
+	};
+
+	/** Parse RIFF header accumulated in HeaderData */
+	EHeaderResult ParseWavHeader(int32& OutDataOffset);
+
+	/** Allocate reframing buffer for the known format */
+	void SetFormat(const FYnnkPcmFormat& InFormat);
+
+	void WriteToBuffer(const uint8* Data, int32 Size, TFunctionRef<void(TArrayView<const uint8>)> OnFrame);
+	void EmitFrame(int32 Size, TFunctionRef<void(TArrayView<const uint8>)> OnFrame);
+
+	FYnnkAudioStreamSettings Settings;
+	FYnnkPcmFormat Format;
+	bool bFormatKnown = false;
+
+	// beginning of stream until the "data" chunk
+	TArray<uint8> HeaderData;
+
+	// circular buffer of data not emitted yet (pre-roll and incomplete frame)
+	TArray<uint8> Buffer;
+	int32 ReadPos = 0;
+	int32 UsedSize = 0;
+
+	// frame crossing the end of buffer is copied here
+	TArray<uint8> FrameData;
+
+	int32 FrameSize = 0;
+	int32 PrerollSize = 0;
+	bool bPrerollDone = false;
+};
@@ -0,0 +1,131 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "HAL/CriticalSection.h"
+#include "YnnkHttpTypes.h"
+#include "YnnkSpeechPipeline.generated.h"
+
+class UHTTPSubsystem;
+class FYnnkStreamTokenReader;
+class FYnnkSentenceSegmenter;
+struct FYnnkHttpResponse;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FYnnkSpeechPipelineEvent, int32, SegmentIndex, const FString&, Text, int32, Code, const TArray<uint8>&, Data);
+
+/**
+* Text-to-speech stage of UYnnkSpeechPipeline
+*/
+USTRUCT(BlueprintType, Category = "Simple HTTP Client")
+struct FYnnkSpeechPipelineSettings
+{
+	GENERATED_BODY()
+
+	// Path of token in json of LLM stream events, for example "choices[0].delta.content". Empty if LLM streams plain text.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LLM")
+	FString TokenPath = TEXT("choices[0].delta.content");
+
+	// Shorter sentences are merged with the next one
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Segmentation")
+	int32 MinSegmentLength = 24;
+
+	// Longer sentences are split at comma or space
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Segmentation")
+	int32 MaxSegmentLength = 240;
+
+	// Template of TTS request. BodyString is json to which segment text is written.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Speech")
+	FYnnkHttpBatchItem SpeechRequest;
+
+	// Field of SpeechRequest body for segment text
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Speech")
+	FString SpeechTextPath = TEXT("text");
+
+	// Number of TTS requests sent at once
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Speech")
+	int32 MaxParallelSpeechRequests = 2;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Speech")
+	FYnnkHttpRequestOptions SpeechOptions;
+
+	FYnnkSpeechPipelineSettings()
+	{
+		SpeechRequest.ExpectedResponseFormat = EExpectedResponseType::Data;
+	}
+};
+
+/**
+* Streams LLM reply, splits it to sentences as tokens arrive and sends TTS request for every sentence
+* without waiting for the whole reply. Audio is delivered in order of sentences. Events are called in game thread.
+*/
+UCLASS()
+class SIMPLEHTTPCLIENT_API UYnnkSpeechPipeline : public UBlueprintAsyncActionBase
+{
+	GENERATED_BODY()
+
+public:
+	// Sentence was sent to TTS
+	UPROPERTY(BlueprintAssignable)
+	FYnnkSpeechPipelineEvent OnSegment;
+
+	// TTS response of sentence (Code and Data), in order of sentences
+	UPROPERTY(BlueprintAssignable)
+	FYnnkSpeechPipelineEvent OnSpeech;
+
+	// All sentences are delivered (SegmentIndex is number of sentences, Text is full reply, Code is number of successful TTS responses)
+	UPROPERTY(BlueprintAssignable)
+	FYnnkSpeechPipelineEvent OnCompleted;
+
+	// LLM request failed. Speech of received sentences is still delivered.
+	UPROPERTY(BlueprintAssignable)
+	FYnnkSpeechPipelineEvent OnFailed;
+
+	UFUNCTION(BlueprintCallable, meta = (BlueprintInternalUseOnly = "true", WorldContext = "WorldContextObject", DisplayName = "LLM to Speech (Async)"), Category = "HTTP Subsystem")
+	static UYnnkSpeechPipeline* StartSpeechPipeline(UObject* WorldContextObject, FName Keyword, FString URL, ERequestMethod Verb, const TArray<FYnnkUrlParameter>& HeaderParams, const FString& BodyString,
+		const FYnnkHttpRequestOptions& Options, const FYnnkSpeechPipelineSettings& Settings);
+
+	virtual void Activate() override;
+
+	// Cancel LLM and TTS requests
+	UFUNCTION(BlueprintCallable, Category = "HTTP Subsystem")
+	void Cancel();
+
+private:
+	// http thread (subsystem doesn't hold its lock here, so new requests can be sent),
+	// or game thread if UHTTPSubsystem::bResponseInGameThread is set
+	void HandleTextChunk(FStringView Text);
+
+	// game thread
+	void HandleLlmComplete(const FYnnkHttpResponse& Response);
+	void SendPendingSegments();
+	void HandleSpeech(int32 ItemIndex, const FYnnkHttpResponse& Response);
+	void HandleSpeechCompleted(int32 NumSucceeded);
+
+	UPROPERTY()
+	UHTTPSubsystem* HttpSubsystem = nullptr;
+
+	FName Keyword;
+	FString URL;
+	ERequestMethod Verb = ERequestMethod::Post;
+	TArray<FYnnkUrlParameter> HeaderParams;
+	FString BodyString;
+	FYnnkHttpRequestOptions Options;
+	FYnnkSpeechPipelineSettings Settings;
+
+	FYnnkHttpRequestHandle LlmRequest;
+	int32 BatchId = INDEX_NONE;
+	bool bCancelled = false;
+
+	// Guards parsers and PendingSegments
+	FCriticalSection SegmentsLock;
+	TSharedPtr<FYnnkStreamTokenReader> TokenReader;
+	TSharedPtr<FYnnkSentenceSegmenter> Segmenter;
+	FString TokenBuffer;
+	TArray<FString> PendingSegments;
+
+	TArray<FString> Segments;
+	FString FullText;
+};
@@ -0,0 +1,155 @@
+// Copyright (c) YuriNK, 2023, All Rights Reserved.
+// ykasczc@gmail.com
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include <atomic>
+
+/**
+* Memory budget of pending stream data shared by buffers of all requests, and counters of overflow policies
+*/
+class SIMPLEHTTPCLIENT_API FYnnkStreamBackpressure
+{
+public:
+	/** 0 - unlimited */
+	void SetMaxBytes(int64 InMaxBytes)
+	{
+		MaxBytes = InMaxBytes;
+	}
+
+	/** Reserve space for chunk. Returns false if budget is exceeded, but never rejects the only pending chunk. */
+	bool TryReserve(int32 Size);
+
+	/** Reserve space for chunk ignoring the budget */
+	void Reserve(int32 Size);
+
+	void Release(int32 Size)
+	{
+		UsedBytes -= Size;
+	}
+
+	int64 GetUsedBytes() const
+	{
+		return UsedBytes;
+	}
+
+	int64 GetPeakBytes() const
+	{
+		return PeakBytes;
+	}
+
+	/** Used space is above the share of limited budget */
+	bool IsNearlyFull(float Share) const
+	{
+		const int64 Limit = MaxBytes;
+		return Limit > 0 && UsedBytes >= (int64)(Limit * Share);
+	}
+
+	void ResetCounters();
+
+	// Chunks were parked until game thread frees space
+	std::atomic<int32> NumParks{ 0 };
+	std::atomic<int64> ParkedMicroseconds{ 0 };
+	// Chunks merged with previous ones before broadcasting
+	std::atomic<int32> NumCoalescedChunks{ 0 };
+	std::atomic<int32> NumDroppedFrames{ 0 };
+
+private:
+	void UpdatePeak(int64 NewUsed);
+
+	std::atomic<int64> MaxBytes{ 0 };
+	std::atomic<int64> UsedBytes{ 0 };
+	std::atomic<int64> PeakBytes{ 0 };
+};
+
+/**
+* Preallocated FIFO of variable-size chunks stored contiguously in one buffer.
+* One thread pushes chunks, another one reads and pops them. Nothing is allocated after construction,
+* except parking space for chunks which don't fit the buffer (allocated on the first overflow).
+*/
+class SIMPLEHTTPCLIENT_API FYnnkStreamRingBuffer
+{
+public:
+	/** Used space is also counted by Backpressure: push fails if either buffer or shared budget is full */
+	explicit FYnnkStreamRingBuffer(int32 InCapacity, TSharedPtr<FYnnkStreamBackpressure, ESPMode::ThreadSafe> InBackpressure = nullptr);
+	~FYnnkStreamRingBuffer();
+
+	int32 GetCapacity() const
+	{
+		return Buffer.Num();
+	}
+
+	/** Largest chunk which can be pushed to empty buffer */
+	int32 GetMaxChunkSize() const
+	{
+		return Buffer.Num() - ChunkHeaderSize;
+	}
+
+	/** Copy chunk to the buffer. Returns false if there is no free space or older chunks are parked. */
+	bool Push(const uint8* Data, int32 Size);
+
+	/**
+	* Keep chunk which doesn't fit the buffer until reader calls MoveParked(). Parking space isn't limited,
+	* so nothing is lost while reader is late. Returns false if chunk wouldn't fit even the empty buffer.
+	*/
+	bool Park(const uint8* Data, int32 Size);
+
+	/** Move parked chunks to the buffer while there is free space. Called by reader. */
+	void MoveParked();
+
+	bool HasParked() const;
+
+	/** Get the oldest chunk. View is valid until Pop() is called. */
+	bool Peek(TArrayView<const uint8>& OutChunk) const;
+
+	/** Remove the oldest chunk */
+	void Pop();
+
+	/** Remove all chunks, including parked ones */
+	void Reset();
+
+	int32 Num() const;
+
+	bool IsEmpty() const
+	{
+		return Num() == 0;
+	}
+
+	/** Used bytes including chunk headers */
+	int32 GetUsedSize() const;
+
+	/** Used space of the buffer or shared budget is above the share of capacity, or chunks are parked */
+	bool IsNearlyFull(float Share) const;
+
+private:
+	static constexpr int32 ChunkHeaderSize = sizeof(int32);
+
+	/** Find space for block and move write position (under Guard). Returns INDEX_NONE if there is no space. */
+	int32 ReserveBlock(int32 BlockSize, bool bIgnoreBudget);
+
+	/** Add time since the first parked chunk to parked time counter (under Guard) */
+	void FinishParking();
+
+	TArray<uint8> Buffer;
+	TSharedPtr<FYnnkStreamBackpressure, ESPMode::ThreadSafe> Backpressure;
+
+	// position of the oldest chunk
+	int32 ReadPos = 0;
+	// position for the next chunk
+	int32 WritePos = 0;
+	// end of data before writer jumped to the beginning of buffer
+	int32 WrapPos = 0;
+	bool bWrapped = false;
+
+	int32 UsedSize = 0;
+	int32 NumChunks = 0;
+
+	// chunks waiting for free space, in the same format as in Buffer
+	TArray<uint8> Parked;
+	int32 ParkedReadPos = 0;
+	double ParkStartTime = 0.0;
+
+	mutable FCriticalSection Guard;
+};